@@ -0,0 +1,157 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Host test and throughput of the C565 decoder (main/img_c565.h).
+ *
+ * Every image is converted twice by tools/img_conv.py, compressed and as plain RGB565.
+ * Whole images and random bands of rows and columns decoded from the compressed one have
+ * to match the plain one pixel for pixel. Then decoding speed is measured as RGB565 bytes
+ * produced per second, for the whole image, for a narrow band at the right edge (the
+ * pixels left of it are decoded and dropped) and for a memcpy() of the plain image:
+ *
+ *   ./c565_bench [ms per measurement]
+ *
+ * Exits with 1 on the first mismatch.
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lvgl.h"
+#include "img_c565.h"
+#include "bg_bulb.h"
+#include "bg_bulb_rgb565.h"
+#include "bulb_c565.h"
+#include "bulb_rgb565.h"
+
+#define C565_BENCH_BANDS        (500)
+#define C565_BENCH_BAND_W       (40)    /* Width of the narrow band */
+
+typedef struct {
+    const char *name;
+    const lv_image_dsc_t *c565;
+    const lv_image_dsc_t *rgb565;
+} c565_bench_image_t;
+
+static const c565_bench_image_t images[] = {
+    { "bg_bulb", &bg_bulb, &bg_bulb_rgb565 },   /* The firmware's background: bulb on a gradient */
+    { "bulb", &bulb_c565, &bulb_rgb565 },       /* Only the bulb, few runs */
+};
+
+static uint32_t rng = 0x2545F491;
+
+static uint32_t c565_bench_rand(void)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static int64_t c565_bench_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static bool c565_bench_check(const c565_bench_image_t *img, uint16_t *out)
+{
+    const int32_t w = img->rgb565->header.w;
+    const int32_t h = img->rgb565->header.h;
+    const uint16_t *ref = (const uint16_t *)img->rgb565->data;
+
+    if (!img_c565_is_valid(img->c565)) {
+        printf("FAIL %s: not a C565 image\n", img->name);
+        return false;
+    }
+    img_c565_decode_rows(img->c565, 0, h, 0, w, (uint8_t *)out, w * sizeof(uint16_t));
+    if (memcmp(out, ref, (size_t)w * h * sizeof(uint16_t)) != 0) {
+        printf("FAIL %s: whole image differs\n", img->name);
+        return false;
+    }
+
+    for (int i = 0; i < C565_BENCH_BANDS; i++) {
+        const int32_t y = c565_bench_rand() % h;
+        const int32_t x = c565_bench_rand() % w;
+        const int32_t rows = 1 + c565_bench_rand() % (h - y);
+        const int32_t cols = 1 + c565_bench_rand() % (w - x);
+        /* Odd strides, like a draw buffer reshaped to the band */
+        const uint32_t stride = (cols + c565_bench_rand() % 4) * sizeof(uint16_t);
+
+        img_c565_decode_rows(img->c565, y, rows, x, cols, (uint8_t *)out, stride);
+        for (int32_t r = 0; r < rows; r++) {
+            if (memcmp((uint8_t *)out + r * stride, &ref[(y + r) * w + x], cols * sizeof(uint16_t)) != 0) {
+                printf("FAIL %s: band (%"PRId32",%"PRId32") %"PRId32"x%"PRId32" differs in row %"PRId32"\n",
+                       img->name, x, y, cols, rows, y + r);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/* RGB565 MB/s produced by decoding columns x to w - 1 of every row, for at least ms */
+static double c565_bench_decode(const c565_bench_image_t *img, int32_t x, uint16_t *out, uint32_t ms)
+{
+    const int32_t w = img->c565->header.w;
+    const int32_t h = img->c565->header.h;
+    const int64_t start = c565_bench_ns();
+    uint64_t bytes = 0;
+    int64_t ns;
+
+    do {
+        img_c565_decode_rows(img->c565, 0, h, x, w - x, (uint8_t *)out, (w - x) * sizeof(uint16_t));
+        bytes += (uint64_t)(w - x) * h * sizeof(uint16_t);
+        ns = c565_bench_ns() - start;
+    } while (ns < (int64_t)ms * 1000000);
+    return bytes * 1e3 / ns;
+}
+
+static double c565_bench_memcpy(const c565_bench_image_t *img, uint16_t *out, uint32_t ms)
+{
+    const int64_t start = c565_bench_ns();
+    uint64_t bytes = 0;
+    int64_t ns;
+
+    do {
+        memcpy(out, img->rgb565->data, img->rgb565->data_size);
+        /* Keeps the copy from being optimized away */
+        __asm__ volatile("" : : "r"(out) : "memory");
+        bytes += img->rgb565->data_size;
+        ns = c565_bench_ns() - start;
+    } while (ns < (int64_t)ms * 1000000);
+    return bytes * 1e3 / ns;
+}
+
+int main(int argc, char **argv)
+{
+    const uint32_t ms = argc > 1 ? strtoul(argv[1], NULL, 10) : 200;
+
+    printf("image     size     RGB565   C565  ratio  whole MB/s  %dpx band MB/s  memcpy MB/s\n", C565_BENCH_BAND_W);
+    for (size_t i = 0; i < sizeof(images) / sizeof(images[0]); i++) {
+        const c565_bench_image_t *img = &images[i];
+        const int32_t w = img->rgb565->header.w;
+        const int32_t h = img->rgb565->header.h;
+        uint16_t *out = malloc((size_t)w * h * sizeof(uint16_t) + 4 * sizeof(uint16_t) * h);
+
+        if (!out || !c565_bench_check(img, out)) {
+            free(out);
+            return 1;
+        }
+        const double whole = c565_bench_decode(img, 0, out, ms);
+        const double band = c565_bench_decode(img, LV_MAX(w - C565_BENCH_BAND_W, 0), out, ms);
+        const double copy = c565_bench_memcpy(img, out, ms);
+        printf("%-8s  %3"PRId32"x%-3"PRId32"  %6"PRIu32" %6"PRIu32"  %4.1f%%  %10.0f  %15.0f  %11.0f\n", img->name, w, h,
+               img->rgb565->data_size, img->c565->data_size, 100.0 * img->c565->data_size / img->rgb565->data_size,
+               whole, band, copy);
+        free(out);
+    }
+    return 0;
+}
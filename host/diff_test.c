@@ -0,0 +1,193 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Host test of the tile diff (main/lcd_diff.h).
+ *
+ * Random frame sequences go through lcd_diff_frame() and every window is written into a
+ * model of the panel's GRAM the way CASET / RASET / RAMWR would. After each frame the GRAM
+ * has to match the frame pixel for pixel, and the windows have to lie on the tile grid,
+ * stay within max_rects and be absent exactly when nothing changed.
+ *
+ * Exits with 1 on the first failure.
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lvgl.h"
+#include "lcd_diff.h"
+
+#define DIFF_TEST_FRAMES    (400)
+
+typedef struct {
+    uint16_t hres;
+    uint16_t vres;
+    uint8_t tile;
+    uint8_t max_rects;
+    uint32_t window_cost_px;
+} diff_test_case_t;
+
+static const diff_test_case_t cases[] = {
+    { 160, 160, 16, 8, 256 },
+    { 160, 160, 16, 1, 256 },
+    { 160, 160, 16, 16, 0 },
+    { 160, 160, 8, 4, 1024 },
+    { 150, 130, 16, 6, 256 },       /* Partial tiles at the right and bottom edges */
+    { 33, 17, 16, 3, 0 },
+};
+
+static uint32_t rng = 0x2545F491;
+
+static uint32_t diff_test_rand(void)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+/* A few kinds of change, mostly small like an animation's, sometimes none or everything */
+static void diff_test_mutate(uint16_t *frame, int32_t hres, int32_t vres)
+{
+    switch (diff_test_rand() % 6) {
+    case 0:
+        break;
+    case 1: {
+        const int32_t n = 1 + diff_test_rand() % 4;
+        for (int32_t i = 0; i < n; i++) {
+            frame[diff_test_rand() % (hres * vres)] ^= 1 << (diff_test_rand() % 16);
+        }
+        break;
+    }
+    case 2:
+    case 3: {
+        const int32_t n = 1 + diff_test_rand() % 5;
+        for (int32_t i = 0; i < n; i++) {
+            const int32_t x1 = diff_test_rand() % hres;
+            const int32_t y1 = diff_test_rand() % vres;
+            const int32_t w = diff_test_rand() % 40;
+            const int32_t h = diff_test_rand() % 40;
+            const int32_t x2 = LV_MIN(hres - 1, x1 + w);
+            const int32_t y2 = LV_MIN(vres - 1, y1 + h);
+            const uint16_t color = diff_test_rand();
+            for (int32_t y = y1; y <= y2; y++) {
+                for (int32_t x = x1; x <= x2; x++) {
+                    frame[y * hres + x] = color;
+                }
+            }
+        }
+        break;
+    }
+    case 4:
+        /* Scroll by a row, like a list */
+        memmove(frame, frame + hres, (size_t)hres * (vres - 1) * sizeof(uint16_t));
+        for (int32_t x = 0; x < hres; x++) {
+            frame[(vres - 1) * hres + x] = diff_test_rand();
+        }
+        break;
+    default:
+        for (int32_t i = 0; i < hres * vres; i++) {
+            frame[i] = diff_test_rand();
+        }
+        break;
+    }
+}
+
+static bool diff_test_case(const diff_test_case_t *tc)
+{
+    const int32_t hres = tc->hres;
+    const int32_t vres = tc->vres;
+    const size_t frame_size = (size_t)hres * vres * sizeof(uint16_t);
+    uint16_t *frame = calloc(1, frame_size);
+    uint16_t *last = calloc(1, frame_size);
+    uint16_t *gram = calloc(1, frame_size);
+    lcd_diff_t *diff = NULL;
+    bool ok = false;
+
+    const lcd_diff_cfg_t cfg = {
+        .hres = tc->hres,
+        .vres = tc->vres,
+        .tile = tc->tile,
+        .max_rects = tc->max_rects,
+        .window_cost_px = tc->window_cost_px,
+    };
+    if (!frame || !last || !gram || lcd_diff_new(&cfg, &diff) != ESP_OK) {
+        printf("FAIL %dx%d: setup\n", hres, vres);
+        goto out;
+    }
+    /* Whatever the panel showed before the first frame */
+    for (int32_t i = 0; i < hres * vres; i++) {
+        gram[i] = 0xDEAD;
+    }
+
+    for (uint32_t f = 0; f < DIFF_TEST_FRAMES; f++) {
+        if (f) {
+            diff_test_mutate(frame, hres, vres);
+        }
+        if (f == DIFF_TEST_FRAMES / 2) {
+            lcd_diff_invalidate(diff);
+        }
+
+        const lcd_diff_rect_t *rects;
+        const int n = lcd_diff_frame(diff, (const uint8_t *)frame, &rects);
+        const bool changed = f == 0 || f == DIFF_TEST_FRAMES / 2 || memcmp(frame, last, frame_size) != 0;
+        if ((n > 0) != changed || n > tc->max_rects) {
+            printf("FAIL %dx%d tile %u: frame %"PRIu32" gave %d windows\n", hres, vres, tc->tile, f, n);
+            goto out;
+        }
+
+        for (int i = 0; i < n; i++) {
+            const lv_area_t *a = &rects[i].area;
+            if (a->x1 < 0 || a->y1 < 0 || a->x2 >= hres || a->y2 >= vres || a->x1 > a->x2 || a->y1 > a->y2 ||
+                    a->x1 % tc->tile || a->y1 % tc->tile ||
+                    ((a->x2 + 1) % tc->tile && a->x2 != hres - 1) || ((a->y2 + 1) % tc->tile && a->y2 != vres - 1)) {
+                printf("FAIL %dx%d tile %u: frame %"PRIu32" window (%"PRId32",%"PRId32")-(%"PRId32",%"PRId32") off the grid\n",
+                       hres, vres, tc->tile, f, a->x1, a->y1, a->x2, a->y2);
+                goto out;
+            }
+
+            /* RAMWR fills the window row by row */
+            const int32_t w = lv_area_get_width(a);
+            const uint16_t *px = (const uint16_t *)rects[i].px;
+            for (int32_t y = a->y1; y <= a->y2; y++) {
+                memcpy(&gram[y * hres + a->x1], px, w * sizeof(uint16_t));
+                px += w;
+            }
+        }
+
+        if (memcmp(gram, frame, frame_size) != 0) {
+            printf("FAIL %dx%d tile %u: frame %"PRIu32" not reconstructed\n", hres, vres, tc->tile, f);
+            goto out;
+        }
+        memcpy(last, frame, frame_size);
+    }
+
+    lcd_diff_stats_t st;
+    lcd_diff_get_stats(diff, &st);
+    printf("ok   %dx%d tile %u max %u cost %"PRIu32": %"PRIu32" frames, %"PRIu32" skipped, %.1f windows/frame, "
+           "%.0f%% of the bytes sent\n", hres, vres, tc->tile, tc->max_rects, tc->window_cost_px, st.frames,
+           st.frames_skipped, (double)st.rects / st.frames,
+           100.0 * st.bytes_sent / (st.bytes_sent + st.bytes_saved));
+    ok = true;
+
+out:
+    lcd_diff_del(diff);
+    free(frame);
+    free(last);
+    free(gram);
+    return ok;
+}
+
+int main(void)
+{
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        if (!diff_test_case(&cases[i])) {
+            return 1;
+        }
+    }
+    return 0;
+}
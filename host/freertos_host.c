@@ -0,0 +1,278 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "lcd_sim.h"
+
+#define HOST_RTOS_POLL_NS       (1000000)   /* Real time between checks while nothing is on the bus */
+
+struct host_queue {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint8_t *items;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t head;
+    UBaseType_t count;
+};
+
+struct host_task {
+    pthread_t thread;
+    TaskFunction_t fn;
+    void *arg;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t notify;
+    bool deleted;               /* vTaskDelete() from another task, exits at its next blocking call */
+};
+
+typedef bool (*host_rtos_ready_t)(void *obj);
+
+static __thread struct host_task *host_task_self;
+
+static struct host_task *host_task_new(void)
+{
+    struct host_task *task = calloc(1, sizeof(struct host_task));
+
+    if (task) {
+        pthread_mutex_init(&task->lock, NULL);
+        pthread_cond_init(&task->cond, NULL);
+    }
+    return task;
+}
+
+static void host_task_free(struct host_task *task)
+{
+    pthread_cond_destroy(&task->cond);
+    pthread_mutex_destroy(&task->lock);
+    free(task);
+}
+
+/*
+ * With `lock` held: true once ready(obj), false when the ticks ran out on the simulated clock.
+ * A blocked task lets the bus finish its next transfer, only with nothing on the bus does it
+ * wait for another thread.
+ */
+static bool host_rtos_wait(pthread_mutex_t *lock, pthread_cond_t *cond, host_rtos_ready_t ready, void *obj,
+                           TickType_t ticks)
+{
+    const int64_t deadline_us = lcd_sim_now_us() + (int64_t)ticks * 1000 / configTICK_RATE_HZ;
+
+    while (!ready(obj)) {
+        if (host_task_self && __atomic_load_n(&host_task_self->deleted, __ATOMIC_ACQUIRE)) {
+            pthread_mutex_unlock(lock);
+            pthread_exit(NULL);
+        }
+        if (ticks == 0 || (ticks != portMAX_DELAY && lcd_sim_now_us() >= deadline_us)) {
+            return false;
+        }
+
+        bool ran = true;
+        pthread_mutex_unlock(lock);
+        if (ticks == portMAX_DELAY) {
+            ran = lcd_sim_wait();
+        } else {
+            lcd_sim_advance(deadline_us);
+        }
+        pthread_mutex_lock(lock);
+
+        if (!ran && !ready(obj)) {
+            struct timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_nsec += HOST_RTOS_POLL_NS;
+            if (ts.tv_nsec >= 1000000000) {
+                ts.tv_sec++;
+                ts.tv_nsec -= 1000000000;
+            }
+            pthread_cond_timedwait(cond, lock, &ts);
+        }
+    }
+    return true;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    struct host_queue *queue = calloc(1, sizeof(struct host_queue));
+    uint8_t *items = calloc(length, item_size);
+
+    if (!queue || !items || !length) {
+        free(queue);
+        free(items);
+        return NULL;
+    }
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->cond, NULL);
+    queue->items = items;
+    queue->length = length;
+    queue->item_size = item_size;
+    return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    pthread_cond_destroy(&queue->cond);
+    pthread_mutex_destroy(&queue->lock);
+    free(queue->items);
+    free(queue);
+}
+
+static bool host_queue_has_space(void *obj)
+{
+    const struct host_queue *queue = obj;
+    return queue->count < queue->length;
+}
+
+static bool host_queue_has_item(void *obj)
+{
+    const struct host_queue *queue = obj;
+    return queue->count > 0;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks)
+{
+    pthread_mutex_lock(&queue->lock);
+    if (!host_rtos_wait(&queue->lock, &queue->cond, host_queue_has_space, queue, ticks)) {
+        pthread_mutex_unlock(&queue->lock);
+        return pdFALSE;
+    }
+    const UBaseType_t tail = (queue->head + queue->count) % queue->length;
+    memcpy(queue->items + (size_t)tail * queue->item_size, item, queue->item_size);
+    queue->count++;
+    pthread_cond_broadcast(&queue->cond);
+    pthread_mutex_unlock(&queue->lock);
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks)
+{
+    pthread_mutex_lock(&queue->lock);
+    if (!host_rtos_wait(&queue->lock, &queue->cond, host_queue_has_item, queue, ticks)) {
+        pthread_mutex_unlock(&queue->lock);
+        return pdFALSE;
+    }
+    memcpy(item, queue->items + (size_t)queue->head * queue->item_size, queue->item_size);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    pthread_cond_broadcast(&queue->cond);
+    pthread_mutex_unlock(&queue->lock);
+    return pdTRUE;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item, BaseType_t *woken)
+{
+    if (woken) {
+        *woken = pdFALSE;
+    }
+    return xQueueSend(queue, item, 0);
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    const UBaseType_t count = queue->count;
+    pthread_mutex_unlock(&queue->lock);
+    return count;
+}
+
+static void *host_task_main(void *arg)
+{
+    struct host_task *task = arg;
+
+    host_task_self = task;
+    task->fn(task->arg);
+    return NULL;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg, UBaseType_t prio,
+                                   TaskHandle_t *ret_task, BaseType_t core)
+{
+    struct host_task *task = host_task_new();
+
+    if (!task) {
+        return pdFAIL;
+    }
+    task->fn = fn;
+    task->arg = arg;
+    if (ret_task) {
+        *ret_task = task;
+    }
+    if (pthread_create(&task->thread, NULL, host_task_main, task) != 0) {
+        host_task_free(task);
+        return pdFAIL;
+    }
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack, void *arg, UBaseType_t prio,
+                       TaskHandle_t *ret_task)
+{
+    return xTaskCreatePinnedToCore(fn, name, stack, arg, prio, ret_task, -1);
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if (!task || task == host_task_self) {
+        pthread_exit(NULL);
+    }
+    __atomic_store_n(&task->deleted, true, __ATOMIC_RELEASE);
+    pthread_join(task->thread, NULL);
+    host_task_free(task);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    /* Threads the shim did not start, e.g. main(), get a handle on first use */
+    if (!host_task_self) {
+        host_task_self = host_task_new();
+    }
+    return host_task_self;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    lcd_sim_advance(lcd_sim_now_us() + (int64_t)ticks * 1000 / configTICK_RATE_HZ);
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    pthread_mutex_lock(&task->lock);
+    task->notify++;
+    pthread_cond_broadcast(&task->cond);
+    pthread_mutex_unlock(&task->lock);
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken)
+{
+    if (woken) {
+        *woken = pdFALSE;
+    }
+    xTaskNotifyGive(task);
+}
+
+static bool host_task_notified(void *obj)
+{
+    const struct host_task *task = obj;
+    return task->notify > 0;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks)
+{
+    struct host_task *task = xTaskGetCurrentTaskHandle();
+    uint32_t value = 0;
+
+    pthread_mutex_lock(&task->lock);
+    if (host_rtos_wait(&task->lock, &task->cond, host_task_notified, task, ticks)) {
+        value = task->notify;
+        task->notify = clear ? 0 : task->notify - 1;
+    }
+    pthread_mutex_unlock(&task->lock);
+    return value;
+}
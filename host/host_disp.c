@@ -0,0 +1,233 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <sched.h>
+#include <stdlib.h>
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_lcd_panel_ops.h"
+#include "host_disp.h"
+#include "lcd_pipe.h"
+#include "lcd_sim.h"
+
+static const char *TAG = "host_disp";
+
+typedef struct {
+    host_disp_cfg_t cfg;
+    esp_lcd_panel_io_handle_t io;
+    esp_lcd_panel_handle_t panel;
+    lv_display_t *disp;
+    bool flushing;
+    bool frame_last;            /* The flush in flight ends a frame */
+    host_disp_stats_t stats;
+} host_disp_ctx_t;
+
+static host_disp_ctx_t host_disp;
+static uint32_t host_disp_rng;
+
+static uint32_t host_disp_tick_cb(void)
+{
+    return (uint32_t)(lcd_sim_now_us() / 1000);
+}
+
+/* The last flush of a frame is on the panel, from the port's flush or lcd_pipe */
+static void host_disp_frame_sent_cb(lv_display_t *disp, void *user_ctx)
+{
+    host_disp.stats.frames++;
+    lcd_sim_present();
+    if (host_disp.cfg.on_frame) {
+        host_disp.cfg.on_frame(host_disp.stats.frames, host_disp.cfg.user_ctx);
+    }
+}
+
+static bool host_disp_flush_done_cb(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+{
+    host_disp.flushing = false;
+    lv_display_flush_ready(host_disp.disp);
+    if (host_disp.frame_last) {
+        host_disp_frame_sent_cb(host_disp.disp, NULL);
+    }
+    return false;
+}
+
+/* The port's flush: byte swap, one window, flush ready once it is on the panel */
+static void host_disp_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    /* Same byte order fix-up as the port's swap_bytes, none once rendering in panel order (lcd_native.h) */
+    if (lv_display_get_color_format(disp) == LV_COLOR_FORMAT_RGB565) {
+        lv_draw_sw_rgb565_swap(px_map, lv_area_get_size(area));
+    }
+    host_disp.flushing = true;
+    host_disp.frame_last = lv_display_flush_is_last(disp);
+    host_disp.stats.flushes++;
+    esp_lcd_panel_draw_bitmap(host_disp.panel, area->x1, area->y1, area->x2 + 1, area->y2 + 1, px_map);
+}
+
+/* LVGL waits for the previous flush here instead of spinning, the virtual clock runs on */
+static void host_disp_flush_wait_cb(lv_display_t *disp)
+{
+    while (host_disp.flushing && lcd_sim_wait()) {
+    }
+}
+
+static esp_err_t host_disp_lcd_init(void)
+{
+    const lcd_sim_cfg_t sim_cfg = {
+        .h_res = HOST_DISP_H_RES,
+        .v_res = HOST_DISP_V_RES,
+        .pclk_hz = host_disp.cfg.pclk_hz,
+        .trans_overhead_ns = host_disp.cfg.trans_ns,
+        .max_trans_bytes = host_disp.cfg.chunk_bytes,
+        .queue_depth = host_disp.cfg.queue_depth,
+    };
+    ESP_RETURN_ON_ERROR(lcd_sim_new_io(&sim_cfg, &host_disp.io), TAG, "New panel IO failed");
+
+    const esp_lcd_panel_dev_config_t panel_cfg = {
+        .reset_gpio_num = -1,
+        .color_space = ESP_LCD_COLOR_SPACE_BGR,
+        .bits_per_pixel = 16,
+    };
+    ESP_RETURN_ON_ERROR(lcd_sim_new_panel(host_disp.io, &panel_cfg, &host_disp.panel), TAG, "New panel failed");
+
+    /* The firmware's init sequence */
+    esp_lcd_panel_reset(host_disp.panel);
+    esp_lcd_panel_init(host_disp.panel);
+    esp_lcd_panel_invert_color(host_disp.panel, false);
+    esp_lcd_panel_mirror(host_disp.panel, true, true);
+    esp_lcd_panel_disp_on_off(host_disp.panel, true);
+
+    if (host_disp.cfg.shm_name) {
+        ESP_RETURN_ON_ERROR(lcd_sim_share(host_disp.cfg.shm_name), TAG, "Shared framebuffer failed");
+    }
+
+    const esp_lcd_panel_io_callbacks_t cbs = {
+        .on_color_trans_done = host_disp_flush_done_cb,
+    };
+    return esp_lcd_panel_io_register_event_callbacks(host_disp.io, &cbs, NULL);
+}
+
+esp_err_t host_disp_init(const host_disp_cfg_t *cfg, lv_display_t **ret_disp)
+{
+    ESP_RETURN_ON_FALSE(cfg && ret_disp, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(cfg->rows && cfg->rows <= HOST_DISP_V_RES && (cfg->partial || cfg->rows == HOST_DISP_V_RES),
+                        ESP_ERR_INVALID_ARG, TAG, "full refresh needs %d rows, partial refresh 1..%d",
+                        HOST_DISP_V_RES, HOST_DISP_V_RES);
+    ESP_RETURN_ON_FALSE(!cfg->diff_tile || (!cfg->partial && !cfg->dedup_rows), ESP_ERR_INVALID_ARG, TAG,
+                        "the tile diff needs full refresh and excludes the band filter");
+    ESP_RETURN_ON_FALSE(cfg->pipe_bufs || (!cfg->dedup_rows && !cfg->diff_tile), ESP_ERR_INVALID_ARG, TAG,
+                        "the band filter and the tile diff run in lcd_pipe");
+
+    host_disp.cfg = *cfg;
+    lv_tick_set_cb(host_disp_tick_cb);
+    ESP_RETURN_ON_ERROR(host_disp_lcd_init(), TAG, "Panel init failed");
+
+    const size_t buf_size = HOST_DISP_H_RES * cfg->rows * sizeof(uint16_t);
+    void *buf1 = malloc(buf_size);
+    void *buf2 = cfg->single_buf ? NULL : malloc(buf_size);
+    ESP_RETURN_ON_FALSE(buf1 && (cfg->single_buf || buf2), ESP_ERR_NO_MEM, TAG, "No memory for the draw buffers");
+
+    host_disp.disp = lv_display_create(HOST_DISP_H_RES, HOST_DISP_V_RES);
+    ESP_RETURN_ON_FALSE(host_disp.disp, ESP_ERR_NO_MEM, TAG, "Create display failed");
+    lv_display_set_color_format(host_disp.disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffers(host_disp.disp, buf1, buf2, buf_size,
+                           cfg->partial ? LV_DISPLAY_RENDER_MODE_PARTIAL : LV_DISPLAY_RENDER_MODE_FULL);
+    lv_display_set_flush_cb(host_disp.disp, host_disp_flush_cb);
+    lv_display_set_flush_wait_cb(host_disp.disp, host_disp_flush_wait_cb);
+
+    if (cfg->pipe_bufs) {
+        /* The firmware's pipeline with main.c's settings, it replaces the flush and the IO callback */
+        const lcd_pipe_cfg_t pipe_cfg = {
+            .io = host_disp.io,
+            .panel = host_disp.panel,
+            .disp = host_disp.disp,
+            .buf_num = cfg->pipe_bufs,
+            .buf_caps = MALLOC_CAP_DEFAULT,
+            .swap_bytes = true,
+            .dedup_rows = cfg->dedup_rows,
+            .diff_tile = cfg->diff_tile,
+            .diff_max_rects = 8,
+            .diff_window_cost_px = 256,
+            .task_priority = 5,
+            .task_stack = 4096,
+            .task_affinity = -1,
+            .on_frame_sent = host_disp_frame_sent_cb,
+        };
+        ESP_RETURN_ON_ERROR(lcd_pipe_init(&pipe_cfg), TAG, "Pipeline failed");
+    }
+    *ret_disp = host_disp.disp;
+    return ESP_OK;
+}
+
+void host_disp_drain(void)
+{
+    lcd_pipe_stats_t st;
+
+    /* The pipeline's task sends on its own thread, the clock runs until every buffer is back */
+    while (host_disp.cfg.pipe_bufs && lcd_pipe_get_stats(&st) == ESP_OK && st.depth) {
+        if (!lcd_sim_wait()) {
+            sched_yield();
+        }
+    }
+    while (lcd_sim_wait()) {
+    }
+}
+
+void host_disp_get_stats(host_disp_stats_t *stats)
+{
+    lcd_pipe_stats_t st;
+
+    *stats = host_disp.stats;
+    if (host_disp.cfg.pipe_bufs && lcd_pipe_get_stats(&st) == ESP_OK) {
+        stats->flushes = st.flushes;
+        stats->dedup = st.dedup;
+        stats->diff = st.diff;
+    }
+}
+
+void host_disp_get_panel(esp_lcd_panel_io_handle_t *io, esp_lcd_panel_handle_t *panel)
+{
+    *io = host_disp.io;
+    *panel = host_disp.panel;
+}
+
+uint32_t host_disp_rand(void)
+{
+    host_disp_rng ^= host_disp_rng << 13;
+    host_disp_rng ^= host_disp_rng >> 17;
+    host_disp_rng ^= host_disp_rng << 5;
+    return host_disp_rng;
+}
+
+void host_disp_scene_create(lv_obj_t *scr, lv_obj_t **objs, uint32_t seed)
+{
+    host_disp_rng = seed;
+    lv_obj_clean(scr);
+    lv_obj_set_style_bg_color(scr, lv_color_hex(0x203040), 0);
+    for (int i = 0; i < HOST_DISP_SCENE_OBJS; i++) {
+        objs[i] = lv_obj_create(scr);
+        lv_obj_remove_style_all(objs[i]);
+        lv_obj_set_style_bg_opa(objs[i], LV_OPA_COVER, 0);
+        lv_obj_set_style_bg_color(objs[i], lv_color_hex(host_disp_rand() & 0xFFFFFF), 0);
+        lv_obj_set_pos(objs[i], 3 + i * 23, 5 + i * 19);
+        lv_obj_set_size(objs[i], 17, 13);
+    }
+}
+
+void host_disp_scene_mutate(lv_obj_t **objs)
+{
+    lv_obj_t *obj = objs[host_disp_rand() % HOST_DISP_SCENE_OBJS];
+
+    switch (host_disp_rand() % 3) {
+    case 0:
+        lv_obj_set_pos(obj, (int32_t)(host_disp_rand() % HOST_DISP_H_RES) - 10,
+                       (int32_t)(host_disp_rand() % HOST_DISP_V_RES) - 10);
+        break;
+    case 1:
+        lv_obj_set_size(obj, 1 + host_disp_rand() % 61, 1 + host_disp_rand() % 61);
+        break;
+    default:
+        lv_obj_set_style_bg_color(obj, lv_color_hex(host_disp_rand() & 0xFFFFFF), 0);
+        break;
+    }
+}
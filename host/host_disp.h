@@ -0,0 +1,118 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * LVGL display on the simulated panel (lcd_sim.h), shared by the host programs.
+ *
+ * Sets the panel up with the firmware's init sequence, flushes like the port does (byte
+ * swap, draw_bitmap, flush ready from on_color_trans_done) or through the firmware's
+ * render-ahead pipeline (lcd_pipe.h), and lets LVGL wait for a flush on the virtual clock.
+ * The LVGL tick reads the same clock.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_lcd_types.h"
+#include "lvgl.h"
+#include "lcd_dedup.h"
+#include "lcd_diff.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HOST_DISP_H_RES     (160)
+#define HOST_DISP_V_RES     (160)
+#define HOST_DISP_SCENE_OBJS (6)    /* Rectangles of the test scene */
+
+/**
+ * @brief Display configuration, the defaults of main.c with HOST_DISP_CFG_DEFAULT()
+ */
+typedef struct {
+    uint32_t pclk_hz;           /* SPI clock */
+    uint32_t trans_ns;          /* Overhead per SPI transaction */
+    uint32_t chunk_bytes;       /* Largest color transaction */
+    uint32_t queue_depth;       /* Color transactions in flight */
+    bool partial;               /* Partial instead of full refresh */
+    uint32_t rows;              /* Draw buffer rows, HOST_DISP_V_RES for full refresh */
+    bool single_buf;            /* One draw buffer instead of two */
+    uint8_t pipe_bufs;          /* Flush through lcd_pipe with this many buffers, 0 flushes like the port */
+    uint16_t dedup_rows;        /* lcd_pipe leaves bands of this many rows out when unchanged (lcd_dedup.h), 0 is off */
+    uint8_t diff_tile;          /* lcd_pipe sends only changed tiles of this size (lcd_diff.h), full refresh, 0 is off */
+    const char *shm_name;       /* Shared memory framebuffer, NULL for none */
+    void (*on_frame)(uint32_t frame, void *user_ctx);  /* Last flush of a frame reached the panel */
+    void *user_ctx;
+} host_disp_cfg_t;
+
+#define HOST_DISP_CFG_DEFAULT() {                                           \
+        .pclk_hz = 80 * 1000 * 1000,                                        \
+        .trans_ns = 2000,                                                   \
+        .chunk_bytes = HOST_DISP_H_RES * HOST_DISP_V_RES * sizeof(uint16_t),\
+        .queue_depth = 10,                                                  \
+        .rows = HOST_DISP_V_RES,                                            \
+    }
+
+/**
+ * @brief Display counters
+ */
+typedef struct {
+    uint32_t frames;            /* Frames whose last flush completed */
+    uint32_t flushes;
+    lcd_dedup_stats_t dedup;    /* lcd_pipe's unchanged band filter, zero when off */
+    lcd_diff_stats_t diff;      /* lcd_pipe's changed tile diff, zero when off */
+} host_disp_stats_t;
+
+/**
+ * @brief Create the simulated panel and its LVGL display, after lv_init()
+ *
+ * @param cfg      Configuration
+ * @param ret_disp Returned display, also the default one
+ * @return ESP_OK on success
+ */
+esp_err_t host_disp_init(const host_disp_cfg_t *cfg, lv_display_t **ret_disp);
+
+/**
+ * @brief Let the virtual clock run until every queued flush reached the panel
+ */
+void host_disp_drain(void);
+
+/**
+ * @brief Get the counters
+ */
+void host_disp_get_stats(host_disp_stats_t *stats);
+
+/**
+ * @brief Get the simulated panel IO and panel, for a firmware module that takes over the flush
+ */
+void host_disp_get_panel(esp_lcd_panel_io_handle_t *io, esp_lcd_panel_handle_t *panel);
+
+/**
+ * @brief Next number of the test scenes' xorshift generator, seeded by host_disp_scene_create()
+ */
+uint32_t host_disp_rand(void);
+
+/**
+ * @brief Build the test scene of the flush tests: small rectangles at odd positions and sizes
+ *
+ * Cleans `scr`, gives it a plain background and creates HOST_DISP_SCENE_OBJS rectangles in
+ * random colors. The scene and every later host_disp_rand() / host_disp_scene_mutate() only
+ * depend on `seed`, so a run can be repeated exactly.
+ *
+ * @param scr  Screen to build on
+ * @param objs Receives the rectangles
+ * @param seed Generator seed, not 0
+ */
+void host_disp_scene_create(lv_obj_t *scr, lv_obj_t **objs, uint32_t seed);
+
+/**
+ * @brief Move, resize or recolor one random rectangle of the test scene, partly off screen at times
+ */
+void host_disp_scene_mutate(lv_obj_t **objs);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,31 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Host build: ESP-IDF's panel device configuration */
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_lcd_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    int reset_gpio_num;                             /* Unused on the host */
+    union {
+        lcd_rgb_element_order_t rgb_ele_order;
+        lcd_rgb_element_order_t color_space;        /* Old name of rgb_ele_order */
+    };
+    uint32_t bits_per_pixel;
+    struct {
+        uint32_t reset_active_high: 1;
+    } flags;
+    void *vendor_config;
+} esp_lcd_panel_dev_config_t;
+
+#ifdef __cplusplus
+}
+#endif
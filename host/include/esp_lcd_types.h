@@ -0,0 +1,28 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Host build: ESP-IDF's esp_lcd handle and color types */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct esp_lcd_panel_io_t esp_lcd_panel_io_t;
+typedef struct esp_lcd_panel_t esp_lcd_panel_t;
+typedef esp_lcd_panel_io_t *esp_lcd_panel_io_handle_t;     /* Panel IO handle */
+typedef esp_lcd_panel_t *esp_lcd_panel_handle_t;           /* Panel handle */
+
+typedef enum {
+    LCD_RGB_ELEMENT_ORDER_RGB,
+    LCD_RGB_ELEMENT_ORDER_BGR,
+} lcd_rgb_element_order_t;
+
+#define ESP_LCD_COLOR_SPACE_RGB     LCD_RGB_ELEMENT_ORDER_RGB
+#define ESP_LCD_COLOR_SPACE_BGR     LCD_RGB_ELEMENT_ORDER_BGR
+
+#ifdef __cplusplus
+}
+#endif
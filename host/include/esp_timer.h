@@ -0,0 +1,24 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Host build: esp_timer_get_time() reads the simulated clock of host/lcd_sim.c */
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Virtual time since the simulation started, in microseconds
+ *
+ * Advances with the modeled SPI transfers and delays only, so runs are deterministic.
+ */
+int64_t esp_timer_get_time(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,647 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "esp_check.h"
+#include "esp_timer.h"
+#include "esp_lcd_panel_commands.h"
+#include "esp_lcd_panel_io_interface.h"
+#include "esp_lcd_panel_interface.h"
+#include "lcd_sim.h"
+
+#define LCD_SIM_QUEUE_MAX       (64)
+#define LCD_SIM_SLEEP_NS        (120 * 1000000LL)   /* Between SWRESET, SLPIN and SLPOUT */
+#define LCD_SIM_WAKE_NS         (5 * 1000000LL)     /* From SLPOUT to the first RAM access */
+
+static const char *TAG = "lcd_sim";
+
+typedef struct {
+    int64_t end_ns;
+    const uint8_t *data;        /* Caller's buffer, read when the transaction ends */
+    size_t len;
+    bool notify;                /* Last transaction of a tx_color */
+} lcd_sim_trans_t;
+
+typedef struct {
+    esp_lcd_panel_io_t base;
+    lcd_sim_cfg_t cfg;
+    esp_lcd_panel_io_callbacks_t cbs;
+    void *user_ctx;
+} lcd_sim_io_t;
+
+typedef struct {
+    esp_lcd_panel_t base;
+    esp_lcd_panel_io_handle_t io;
+    int x_gap;
+    int y_gap;
+    uint8_t madctl;
+} lcd_sim_panel_t;
+
+typedef struct {
+    lcd_sim_io_t *io;
+    int64_t now_ns;
+    int64_t bus_free_ns;
+    lcd_sim_trans_t queue[LCD_SIM_QUEUE_MAX];
+    uint32_t queue_head;
+    uint32_t queue_cnt;
+    lcd_sim_stats_t stats;
+
+    /* Panel controller */
+    uint16_t *gram;             /* Native RGB565, row major */
+    uint16_t xs, xe, ys, ye;    /* CASET / RASET window */
+    uint16_t wx, wy;            /* RAM write pointer */
+    int hi_byte;                /* First byte of a pixel split across transfers, -1 if none */
+    uint8_t madctl;
+    bool inverted;
+    bool sleeping;
+    bool on;
+    int64_t sleep_ns;           /* Last SWRESET, SLPIN or SLPOUT */
+    int64_t slpout_ns;
+
+    lcd_sim_shm_header_t *shm;
+    size_t shm_size;
+} lcd_sim_ctx_t;
+
+static lcd_sim_ctx_t sim;
+
+/* The pipeline's transfer task and LVGL drive the bus from their own threads, the clock reads without it */
+static pthread_mutex_t sim_lock;
+static pthread_once_t sim_lock_once = PTHREAD_ONCE_INIT;
+
+/* Recursive, the transfer-done callbacks run with it held and may present the panel */
+static void lcd_sim_lock_init(void)
+{
+    pthread_mutexattr_t attr;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&sim_lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+static void lcd_sim_lock(void)
+{
+    pthread_once(&sim_lock_once, lcd_sim_lock_init);
+    pthread_mutex_lock(&sim_lock);
+}
+
+static void lcd_sim_unlock(void)
+{
+    pthread_mutex_unlock(&sim_lock);
+}
+
+int64_t lcd_sim_now_us(void)
+{
+    return __atomic_load_n(&sim.now_ns, __ATOMIC_RELAXED) / 1000;
+}
+
+static void lcd_sim_set_now(int64_t ns)
+{
+    __atomic_store_n(&sim.now_ns, ns, __ATOMIC_RELAXED);
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return lcd_sim_now_us();
+}
+
+static void lcd_sim_panel_data(const uint8_t *data, size_t size);
+
+static int64_t lcd_sim_trans_ns(size_t bytes)
+{
+    return sim.io->cfg.trans_overhead_ns + (int64_t)bytes * 8 * 1000000000LL / sim.io->cfg.pclk_hz;
+}
+
+/* Oldest queued transaction ends and its pixels reach GRAM, the caller's time moves along if it waited for it */
+static void lcd_sim_complete(void)
+{
+    const lcd_sim_trans_t t = sim.queue[sim.queue_head];
+    esp_lcd_panel_io_event_data_t edata = { };
+
+    sim.queue_head = (sim.queue_head + 1) % LCD_SIM_QUEUE_MAX;
+    sim.queue_cnt--;
+    if (t.end_ns > sim.now_ns) {
+        lcd_sim_set_now(t.end_ns);
+    }
+    lcd_sim_panel_data(t.data, t.len);
+    if (t.notify && sim.io->cbs.on_color_trans_done) {
+        sim.io->cbs.on_color_trans_done(&sim.io->base, &edata, sim.io->user_ctx);
+    }
+}
+
+void lcd_sim_advance(int64_t us)
+{
+    const int64_t end_ns = us * 1000;
+
+    lcd_sim_lock();
+    while (sim.queue_cnt && sim.queue[sim.queue_head].end_ns <= end_ns) {
+        lcd_sim_complete();
+    }
+    if (end_ns > sim.now_ns) {
+        lcd_sim_set_now(end_ns);
+    }
+    lcd_sim_unlock();
+}
+
+bool lcd_sim_wait(void)
+{
+    lcd_sim_lock();
+    const bool busy = sim.queue_cnt;
+    if (busy) {
+        lcd_sim_complete();
+    }
+    lcd_sim_unlock();
+    return busy;
+}
+
+/* Polling transaction: waits for the queued ones like the SPI driver, then blocks the caller */
+static void lcd_sim_poll(size_t bytes)
+{
+    while (sim.queue_cnt) {
+        lcd_sim_complete();
+    }
+    const int64_t start = sim.now_ns > sim.bus_free_ns ? sim.now_ns : sim.bus_free_ns;
+    const int64_t ns = lcd_sim_trans_ns(bytes);
+    lcd_sim_set_now(start + ns);
+    sim.bus_free_ns = sim.now_ns;
+    sim.stats.busy_ns += ns;
+    sim.stats.cmd_bytes += bytes;
+    sim.stats.trans++;
+}
+
+/* Queued transaction: the caller only blocks while the queue is full */
+static void lcd_sim_queue(const uint8_t *data, size_t bytes, bool notify)
+{
+    if (sim.queue_cnt == sim.io->cfg.queue_depth) {
+        lcd_sim_complete();
+    }
+    const int64_t start = sim.now_ns > sim.bus_free_ns ? sim.now_ns : sim.bus_free_ns;
+    const int64_t ns = lcd_sim_trans_ns(bytes);
+    sim.bus_free_ns = start + ns;
+    sim.queue[(sim.queue_head + sim.queue_cnt) % LCD_SIM_QUEUE_MAX] = (lcd_sim_trans_t) {
+        .end_ns = sim.bus_free_ns, .data = data, .len = bytes, .notify = notify,
+    };
+    sim.queue_cnt++;
+    sim.stats.busy_ns += ns;
+    sim.stats.px_bytes += bytes;
+    sim.stats.trans++;
+}
+
+static void lcd_sim_panel_power_on(void)
+{
+    sim.xs = 0;
+    sim.xe = sim.io->cfg.h_res - 1;
+    sim.ys = 0;
+    sim.ye = sim.io->cfg.v_res - 1;
+    sim.wx = sim.wy = 0;
+    sim.hi_byte = -1;
+    sim.madctl = 0;
+    sim.inverted = false;
+    sim.sleeping = true;
+    sim.on = false;
+    sim.sleep_ns = sim.now_ns;
+    sim.slpout_ns = INT64_MIN / 2;
+}
+
+static void lcd_sim_panel_cmd(int cmd, const uint8_t *param, size_t param_size)
+{
+    switch (cmd) {
+    case LCD_CMD_SWRESET:
+        lcd_sim_panel_power_on();
+        break;
+    case LCD_CMD_SLPIN:
+    case LCD_CMD_SLPOUT:
+        if (sim.now_ns - sim.sleep_ns < LCD_SIM_SLEEP_NS) {
+            ESP_LOGW(TAG, "%s %"PRId64" us after the last reset or sleep change", cmd == LCD_CMD_SLPIN ? "SLPIN" : "SLPOUT",
+                     (sim.now_ns - sim.sleep_ns) / 1000);
+            sim.stats.timing_errors++;
+        }
+        sim.sleeping = cmd == LCD_CMD_SLPIN;
+        sim.sleep_ns = sim.now_ns;
+        if (cmd == LCD_CMD_SLPOUT) {
+            sim.slpout_ns = sim.now_ns;
+        }
+        break;
+    case LCD_CMD_INVOFF:
+    case LCD_CMD_INVON:
+        sim.inverted = cmd == LCD_CMD_INVON;
+        break;
+    case LCD_CMD_DISPOFF:
+    case LCD_CMD_DISPON:
+        sim.on = cmd == LCD_CMD_DISPON;
+        break;
+    case LCD_CMD_CASET:
+        if (param_size >= 4) {
+            sim.xs = param[0] << 8 | param[1];
+            sim.xe = param[2] << 8 | param[3];
+        }
+        break;
+    case LCD_CMD_RASET:
+        if (param_size >= 4) {
+            sim.ys = param[0] << 8 | param[1];
+            sim.ye = param[2] << 8 | param[3];
+        }
+        break;
+    case LCD_CMD_RAMWR:
+    case LCD_CMD_RAMWRC:
+        if (sim.now_ns - sim.slpout_ns < LCD_SIM_WAKE_NS) {
+            ESP_LOGW(TAG, "RAM write %"PRId64" us after SLPOUT", (sim.now_ns - sim.slpout_ns) / 1000);
+            sim.stats.timing_errors++;
+        }
+        if (cmd == LCD_CMD_RAMWR) {
+            sim.wx = sim.xs;
+            sim.wy = sim.ys;
+            sim.hi_byte = -1;
+        }
+        break;
+    case LCD_CMD_MADCTL:
+        if (param_size >= 1) {
+            sim.madctl = param[0];
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/* Pixel at the write pointer, through the MADCTL address mapping */
+static void lcd_sim_panel_put(uint16_t px)
+{
+    int x = sim.wx, y = sim.wy;
+
+    if (sim.madctl & LCD_CMD_MV_BIT) {
+        const int t = x;
+        x = y;
+        y = t;
+    }
+    if (sim.madctl & LCD_CMD_MX_BIT) {
+        x = sim.io->cfg.h_res - 1 - x;
+    }
+    if (sim.madctl & LCD_CMD_MY_BIT) {
+        y = sim.io->cfg.v_res - 1 - y;
+    }
+    if (x >= 0 && x < sim.io->cfg.h_res && y >= 0 && y < sim.io->cfg.v_res) {
+        sim.gram[y * sim.io->cfg.h_res + x] = px;
+    }
+
+    if (++sim.wx > sim.xe) {
+        sim.wx = sim.xs;
+        if (++sim.wy > sim.ye) {
+            sim.wy = sim.ys;
+        }
+    }
+}
+
+/* Big endian RGB565 on the wire */
+static void lcd_sim_panel_data(const uint8_t *data, size_t size)
+{
+    size_t i = 0;
+
+    if (sim.hi_byte >= 0 && size) {
+        lcd_sim_panel_put(sim.hi_byte << 8 | data[i++]);
+        sim.hi_byte = -1;
+    }
+    for (; i + 1 < size; i += 2) {
+        lcd_sim_panel_put(data[i] << 8 | data[i + 1]);
+    }
+    if (i < size) {
+        sim.hi_byte = data[i];
+    }
+}
+
+static esp_err_t lcd_sim_io_tx_param(esp_lcd_panel_io_t *io, int lcd_cmd, const void *param, size_t param_size)
+{
+    lcd_sim_lock();
+    if (lcd_cmd >= 0) {
+        lcd_sim_poll(1);
+    }
+    if (param_size) {
+        lcd_sim_poll(param_size);
+    }
+    lcd_sim_panel_cmd(lcd_cmd, param, param_size);
+    lcd_sim_unlock();
+    return ESP_OK;
+}
+
+static esp_err_t lcd_sim_io_tx_color(esp_lcd_panel_io_t *io, int lcd_cmd, const void *color, size_t color_size)
+{
+    lcd_sim_io_t *sim_io = (lcd_sim_io_t *)io;
+
+    lcd_sim_lock();
+    if (lcd_cmd >= 0) {
+        lcd_sim_poll(1);
+        lcd_sim_panel_cmd(lcd_cmd, NULL, 0);
+    }
+    sim.stats.colors++;
+
+    /* Like the DMA, a transaction reads the buffer while it is on the wire, GRAM takes it when
+     * it ends: a caller rewriting the buffer before the completion callback sends what it
+     * rewrote. Commands wait for the queue, so the window is still the same then. */
+    for (size_t off = 0; off < color_size; off += sim_io->cfg.max_trans_bytes) {
+        const size_t len = color_size - off < sim_io->cfg.max_trans_bytes ? color_size - off : sim_io->cfg.max_trans_bytes;
+        lcd_sim_queue((const uint8_t *)color + off, len, off + len == color_size);
+    }
+    lcd_sim_unlock();
+    return ESP_OK;
+}
+
+static esp_err_t lcd_sim_io_register_event_callbacks(esp_lcd_panel_io_t *io, const esp_lcd_panel_io_callbacks_t *cbs,
+                                                     void *user_ctx)
+{
+    lcd_sim_io_t *sim_io = (lcd_sim_io_t *)io;
+
+    lcd_sim_lock();
+    sim_io->cbs = *cbs;
+    sim_io->user_ctx = user_ctx;
+    lcd_sim_unlock();
+    return ESP_OK;
+}
+
+static esp_err_t lcd_sim_io_del(esp_lcd_panel_io_t *io)
+{
+    lcd_sim_lock();
+    while (sim.queue_cnt) {
+        lcd_sim_complete();
+    }
+    if (sim.shm) {
+        munmap(sim.shm, sim.shm_size);
+    }
+    free(sim.gram);
+    free(sim.io);
+    memset(&sim, 0, sizeof(sim));
+    lcd_sim_unlock();
+    return ESP_OK;
+}
+
+esp_err_t lcd_sim_new_io(const lcd_sim_cfg_t *cfg, esp_lcd_panel_io_handle_t *ret_io)
+{
+    ESP_RETURN_ON_FALSE(cfg && ret_io && cfg->h_res && cfg->v_res && cfg->pclk_hz && cfg->max_trans_bytes,
+                        ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(cfg->queue_depth && cfg->queue_depth <= LCD_SIM_QUEUE_MAX, ESP_ERR_INVALID_ARG, TAG,
+                        "queue depth must be 1..%d", LCD_SIM_QUEUE_MAX);
+    ESP_RETURN_ON_FALSE(!sim.io, ESP_ERR_INVALID_STATE, TAG, "simulated IO already exists");
+
+    lcd_sim_io_t *io = calloc(1, sizeof(lcd_sim_io_t));
+    uint16_t *gram = calloc((size_t)cfg->h_res * cfg->v_res, sizeof(uint16_t));
+    if (!io || !gram) {
+        free(io);
+        free(gram);
+        return ESP_ERR_NO_MEM;
+    }
+    io->cfg = *cfg;
+    io->base.tx_param = lcd_sim_io_tx_param;
+    io->base.tx_color = lcd_sim_io_tx_color;
+    io->base.del = lcd_sim_io_del;
+    io->base.register_event_callbacks = lcd_sim_io_register_event_callbacks;
+
+    sim.io = io;
+    sim.gram = gram;
+    lcd_sim_panel_power_on();
+    *ret_io = &io->base;
+    return ESP_OK;
+}
+
+void lcd_sim_get_stats(lcd_sim_stats_t *stats)
+{
+    lcd_sim_lock();
+    *stats = sim.stats;
+    lcd_sim_unlock();
+}
+
+/* Delays of the panel driver, vTaskDelay() on the target */
+static void lcd_sim_delay_ms(uint32_t ms)
+{
+    lcd_sim_advance(lcd_sim_now_us() + ms * 1000);
+}
+
+static esp_err_t lcd_sim_panel_tx(lcd_sim_panel_t *panel, int cmd, const void *param, size_t param_size)
+{
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(panel->io, cmd, param, param_size), TAG, "send command failed");
+    return ESP_OK;
+}
+
+static esp_err_t lcd_sim_panel_reset(esp_lcd_panel_t *panel)
+{
+    lcd_sim_panel_t *p = (lcd_sim_panel_t *)panel;
+
+    ESP_RETURN_ON_ERROR(lcd_sim_panel_tx(p, LCD_CMD_SWRESET, NULL, 0), TAG, "reset failed");
+    lcd_sim_delay_ms(120);
+    return ESP_OK;
+}
+
+static esp_err_t lcd_sim_panel_init(esp_lcd_panel_t *panel)
+{
+    lcd_sim_panel_t *p = (lcd_sim_panel_t *)panel;
+
+    ESP_RETURN_ON_ERROR(lcd_sim_panel_tx(p, LCD_CMD_SLPOUT, NULL, 0), TAG, "init failed");
+    lcd_sim_delay_ms(120);
+    ESP_RETURN_ON_ERROR(lcd_sim_panel_tx(p, LCD_CMD_MADCTL, (uint8_t[]) { p->madctl }, 1), TAG, "init failed");
+    ESP_RETURN_ON_ERROR(lcd_sim_panel_tx(p, LCD_CMD_COLMOD, (uint8_t[]) { 0x55 }, 1), TAG, "init failed");
+    return ESP_OK;
+}
+
+static esp_err_t lcd_sim_panel_draw_bitmap(esp_lcd_panel_t *panel, int x_start, int y_start, int x_end, int y_end,
+                                           const void *color_data)
+{
+    lcd_sim_panel_t *p = (lcd_sim_panel_t *)panel;
+
+    ESP_RETURN_ON_FALSE(x_start < x_end && y_start < y_end, ESP_ERR_INVALID_ARG, TAG, "start position must be smaller than end position");
+    const size_t len = (size_t)(x_end - x_start) * (y_end - y_start) * sizeof(uint16_t);
+    x_start += p->x_gap;
+    x_end += p->x_gap;
+    y_start += p->y_gap;
+    y_end += p->y_gap;
+
+    ESP_RETURN_ON_ERROR(lcd_sim_panel_tx(p, LCD_CMD_CASET, (uint8_t[]) {
+        (x_start >> 8) & 0xFF, x_start & 0xFF, ((x_end - 1) >> 8) & 0xFF, (x_end - 1) & 0xFF,
+    }, 4), TAG, "set column address failed");
+    ESP_RETURN_ON_ERROR(lcd_sim_panel_tx(p, LCD_CMD_RASET, (uint8_t[]) {
+        (y_start >> 8) & 0xFF, y_start & 0xFF, ((y_end - 1) >> 8) & 0xFF, (y_end - 1) & 0xFF,
+    }, 4), TAG, "set row address failed");
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_color(p->io, LCD_CMD_RAMWR, color_data, len), TAG, "send color failed");
+    return ESP_OK;
+}
+
+static esp_err_t lcd_sim_panel_madctl(lcd_sim_panel_t *p, uint8_t mask, uint8_t bits)
+{
+    p->madctl = (p->madctl & ~mask) | bits;
+    return lcd_sim_panel_tx(p, LCD_CMD_MADCTL, (uint8_t[]) { p->madctl }, 1);
+}
+
+static esp_err_t lcd_sim_panel_mirror(esp_lcd_panel_t *panel, bool mirror_x, bool mirror_y)
+{
+    return lcd_sim_panel_madctl((lcd_sim_panel_t *)panel, LCD_CMD_MX_BIT | LCD_CMD_MY_BIT,
+                                (mirror_x ? LCD_CMD_MX_BIT : 0) | (mirror_y ? LCD_CMD_MY_BIT : 0));
+}
+
+static esp_err_t lcd_sim_panel_swap_xy(esp_lcd_panel_t *panel, bool swap_axes)
+{
+    return lcd_sim_panel_madctl((lcd_sim_panel_t *)panel, LCD_CMD_MV_BIT, swap_axes ? LCD_CMD_MV_BIT : 0);
+}
+
+static esp_err_t lcd_sim_panel_set_gap(esp_lcd_panel_t *panel, int x_gap, int y_gap)
+{
+    lcd_sim_panel_t *p = (lcd_sim_panel_t *)panel;
+
+    p->x_gap = x_gap;
+    p->y_gap = y_gap;
+    return ESP_OK;
+}
+
+static esp_err_t lcd_sim_panel_invert_color(esp_lcd_panel_t *panel, bool invert_color_data)
+{
+    return lcd_sim_panel_tx((lcd_sim_panel_t *)panel, invert_color_data ? LCD_CMD_INVON : LCD_CMD_INVOFF, NULL, 0);
+}
+
+static esp_err_t lcd_sim_panel_disp_on_off(esp_lcd_panel_t *panel, bool on_off)
+{
+    return lcd_sim_panel_tx((lcd_sim_panel_t *)panel, on_off ? LCD_CMD_DISPON : LCD_CMD_DISPOFF, NULL, 0);
+}
+
+static esp_err_t lcd_sim_panel_disp_sleep(esp_lcd_panel_t *panel, bool sleep)
+{
+    return lcd_sim_panel_tx((lcd_sim_panel_t *)panel, sleep ? LCD_CMD_SLPIN : LCD_CMD_SLPOUT, NULL, 0);
+}
+
+static esp_err_t lcd_sim_panel_del(esp_lcd_panel_t *panel)
+{
+    free(panel);
+    return ESP_OK;
+}
+
+esp_err_t lcd_sim_new_panel(esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_config_t *cfg,
+                            esp_lcd_panel_handle_t *ret_panel)
+{
+    ESP_RETURN_ON_FALSE(io && cfg && ret_panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(cfg->bits_per_pixel == 16, ESP_ERR_NOT_SUPPORTED, TAG, "only RGB565 is simulated");
+
+    lcd_sim_panel_t *p = calloc(1, sizeof(lcd_sim_panel_t));
+    ESP_RETURN_ON_FALSE(p, ESP_ERR_NO_MEM, TAG, "no mem for panel");
+    p->io = io;
+    p->madctl = cfg->rgb_ele_order == LCD_RGB_ELEMENT_ORDER_BGR ? LCD_CMD_BGR_BIT : 0;
+    p->base.reset = lcd_sim_panel_reset;
+    p->base.init = lcd_sim_panel_init;
+    p->base.draw_bitmap = lcd_sim_panel_draw_bitmap;
+    p->base.mirror = lcd_sim_panel_mirror;
+    p->base.swap_xy = lcd_sim_panel_swap_xy;
+    p->base.set_gap = lcd_sim_panel_set_gap;
+    p->base.invert_color = lcd_sim_panel_invert_color;
+    p->base.disp_on_off = lcd_sim_panel_disp_on_off;
+    p->base.disp_sleep = lcd_sim_panel_disp_sleep;
+    p->base.del = lcd_sim_panel_del;
+    *ret_panel = &p->base;
+    return ESP_OK;
+}
+
+/* What the glass shows: the panel's subpixels are BGR, so MADCTL must say so */
+static uint16_t lcd_sim_visible(uint32_t i)
+{
+    if (!sim.on || sim.sleeping) {
+        return 0;
+    }
+    uint16_t px = sim.gram[i];
+    if (sim.inverted) {
+        px = ~px;
+    }
+    if (!(sim.madctl & LCD_CMD_BGR_BIT)) {
+        px = (px & 0x07E0) | (px >> 11) | (uint16_t)(px << 11);
+    }
+    return px;
+}
+
+esp_err_t lcd_sim_write_ppm(const char *path)
+{
+    ESP_RETURN_ON_FALSE(sim.io, ESP_ERR_INVALID_STATE, TAG, "no simulated IO");
+
+    const uint32_t w = sim.io->cfg.h_res, h = sim.io->cfg.v_res;
+    uint8_t *rgb = malloc((size_t)w * h * 3);
+    ESP_RETURN_ON_FALSE(rgb, ESP_ERR_NO_MEM, TAG, "no mem for image");
+    lcd_sim_lock();
+    for (uint32_t i = 0; i < w * h; i++) {
+        const uint16_t px = lcd_sim_visible(i);
+        const uint8_t r = px >> 11, g = (px >> 5) & 0x3F, b = px & 0x1F;
+        rgb[i * 3 + 0] = r << 3 | r >> 2;
+        rgb[i * 3 + 1] = g << 2 | g >> 4;
+        rgb[i * 3 + 2] = b << 3 | b >> 2;
+    }
+    lcd_sim_unlock();
+
+    esp_err_t ret = ESP_OK;
+    FILE *f = fopen(path, "wb");
+    if (!f || fprintf(f, "P6\n%"PRIu32" %"PRIu32"\n255\n", w, h) < 0 || fwrite(rgb, 3, (size_t)w * h, f) != (size_t)w * h) {
+        ESP_LOGE(TAG, "Write %s failed", path);
+        ret = ESP_FAIL;
+    }
+    if (f && fclose(f) != 0) {
+        ret = ESP_FAIL;
+    }
+    free(rgb);
+    return ret;
+}
+
+uint32_t lcd_sim_crc32(void)
+{
+    static uint32_t table[256];
+    uint32_t crc = 0xFFFFFFFF;
+
+    if (!table[1]) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = c & 1 ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+    }
+    lcd_sim_lock();
+    for (uint32_t i = 0; sim.io && i < (uint32_t)sim.io->cfg.h_res * sim.io->cfg.v_res; i++) {
+        const uint16_t px = lcd_sim_visible(i);
+        crc = table[(crc ^ px) & 0xFF] ^ (crc >> 8);
+        crc = table[(crc ^ (px >> 8)) & 0xFF] ^ (crc >> 8);
+    }
+    lcd_sim_unlock();
+    return ~crc;
+}
+
+esp_err_t lcd_sim_share(const char *name)
+{
+    ESP_RETURN_ON_FALSE(sim.io && name, ESP_ERR_INVALID_STATE, TAG, "no simulated IO");
+    ESP_RETURN_ON_FALSE(!sim.shm, ESP_ERR_INVALID_STATE, TAG, "framebuffer already shared");
+
+    const size_t size = sizeof(lcd_sim_shm_header_t) + (size_t)sim.io->cfg.h_res * sim.io->cfg.v_res * sizeof(uint16_t);
+    const int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+    ESP_RETURN_ON_FALSE(fd >= 0, ESP_FAIL, TAG, "shm_open %s failed", name);
+    void *mem = ftruncate(fd, size) == 0 ? mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    ESP_RETURN_ON_FALSE(mem != MAP_FAILED, ESP_FAIL, TAG, "map %s failed", name);
+
+    sim.shm = mem;
+    sim.shm_size = size;
+    memcpy(sim.shm->magic, "LCDS", 4);
+    sim.shm->w = sim.io->cfg.h_res;
+    sim.shm->h = sim.io->cfg.v_res;
+    sim.shm->frame = 0;
+    return ESP_OK;
+}
+
+void lcd_sim_present(void)
+{
+    if (!sim.shm) {
+        return;
+    }
+    uint16_t *fb = (uint16_t *)(sim.shm + 1);
+    lcd_sim_lock();
+    for (uint32_t i = 0; i < (uint32_t)sim.io->cfg.h_res * sim.io->cfg.v_res; i++) {
+        fb[i] = lcd_sim_visible(i);
+    }
+    __atomic_store_n(&sim.shm->frame, sim.shm->frame + 1, __ATOMIC_RELEASE);
+    lcd_sim_unlock();
+}
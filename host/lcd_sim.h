@@ -0,0 +1,138 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Simulated SPI panel IO and GC9D01 panel for the host build.
+ *
+ * Both implement ESP-IDF's esp_lcd driver interfaces, so code written against
+ * esp_lcd_panel_io.h / esp_lcd_panel_ops.h runs unchanged. Time is virtual: commands
+ * block the caller for their modeled bus time, color transfers are queued like
+ * spi_device_queue_trans() and complete (with on_color_trans_done) once the clock passes
+ * their end, and esp_timer_get_time() reads that clock, so a run is deterministic.
+ * The calls may come from several threads (host/freertos_host.c), on_color_trans_done then
+ * runs on the one whose call let the clock pass the transfer's end.
+ *
+ * The panel decodes the command stream (CASET, RASET, RAMWR, RAMWRC, MADCTL, INVON/OFF,
+ * DISPON/OFF, SLPIN/OUT) into its GRAM, whose visible image can be written to a PPM file or
+ * published to a shared memory framebuffer. Pixels reach GRAM when their transaction
+ * completes, read from the caller's buffer then, so a buffer reused too early shows.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_dev.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Shared memory framebuffer layout, followed by w * h RGB565 pixels */
+typedef struct {
+    char magic[4];              /* "LCDS" */
+    uint16_t w;
+    uint16_t h;
+    volatile uint32_t frame;    /* Bumped after each lcd_sim_present() */
+} lcd_sim_shm_header_t;
+
+/**
+ * @brief Bus and panel configuration
+ */
+typedef struct {
+    uint16_t h_res;             /* Panel GRAM size */
+    uint16_t v_res;
+    uint32_t pclk_hz;           /* SPI clock */
+    uint32_t trans_overhead_ns; /* Per SPI transaction: queueing, CS, DMA setup */
+    uint32_t max_trans_bytes;   /* Color data is split into transactions of at most this size */
+    uint32_t queue_depth;       /* Color transactions in flight, as trans_queue_depth */
+} lcd_sim_cfg_t;
+
+/**
+ * @brief Bus statistics since the IO was created
+ */
+typedef struct {
+    int64_t busy_ns;            /* Bus time of all transactions */
+    uint64_t cmd_bytes;         /* Command and parameter bytes */
+    uint64_t px_bytes;          /* Color bytes */
+    uint32_t trans;             /* SPI transactions */
+    uint32_t colors;            /* tx_color calls */
+    uint32_t timing_errors;     /* Commands inside the panel's SLPIN / SLPOUT delays */
+} lcd_sim_stats_t;
+
+/**
+ * @brief Create the simulated panel IO, only one exists at a time
+ *
+ * @param cfg    Configuration
+ * @param ret_io Returned panel IO handle
+ * @return ESP_ERR_INVALID_STATE if it already exists
+ */
+esp_err_t lcd_sim_new_io(const lcd_sim_cfg_t *cfg, esp_lcd_panel_io_handle_t *ret_io);
+
+/**
+ * @brief Create the GC9D01 panel driver on the simulated IO
+ *
+ * Sends the same kind of command stream the vendor driver does: reset, SLPOUT, MADCTL,
+ * COLMOD and a CASET / RASET / RAMWR sequence per draw_bitmap().
+ *
+ * @param io        Panel IO from lcd_sim_new_io()
+ * @param cfg       Panel configuration, 16 bits per pixel only
+ * @param ret_panel Returned panel handle
+ * @return ESP_OK on success
+ */
+esp_err_t lcd_sim_new_panel(esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_config_t *cfg,
+                            esp_lcd_panel_handle_t *ret_panel);
+
+/**
+ * @brief Virtual time in microseconds, as esp_timer_get_time()
+ */
+int64_t lcd_sim_now_us(void);
+
+/**
+ * @brief Let the virtual clock run to `us`, completing the transfers that end before it
+ */
+void lcd_sim_advance(int64_t us);
+
+/**
+ * @brief Let the virtual clock run until the oldest color transfer completes
+ *
+ * @return false if nothing is in flight
+ */
+bool lcd_sim_wait(void);
+
+/**
+ * @brief Get the bus statistics
+ */
+void lcd_sim_get_stats(lcd_sim_stats_t *stats);
+
+/**
+ * @brief Write what the panel shows to a binary PPM file
+ *
+ * Black while the display is off or asleep, colors inverted after INVON and red / blue
+ * swapped when MADCTL does not match the panel's BGR subpixel order.
+ */
+esp_err_t lcd_sim_write_ppm(const char *path);
+
+/**
+ * @brief CRC-32 of what the panel shows, as little endian RGB565, to compare frames across runs
+ */
+uint32_t lcd_sim_crc32(void);
+
+/**
+ * @brief Publish frames to a POSIX shared memory object (lcd_sim_shm_header_t)
+ *
+ * @param name Object name, e.g. "/lcd_sim"
+ */
+esp_err_t lcd_sim_share(const char *name);
+
+/**
+ * @brief Copy what the panel shows to the shared memory framebuffer, if any
+ */
+void lcd_sim_present(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,166 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Host test of the SPI link tuner (main/lcd_link.h) against a simulated flaky link.
+ *
+ * The simulated link corrupts transfers above a clock limit, underruns chunks above a size
+ * limit at high clocks (the DMA feed from PSRAM falling behind), drops bits now and then in
+ * a marginal clock band and refuses clocks its "driver" does not support. The tuner has to
+ * pick the fastest, then largest, combination that stays clean for every round, fall back
+ * to the slowest and smallest one when nothing passes, and the ladder hash has to tell
+ * ladders apart.
+ *
+ * Exits with 1 on the first failure.
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "lcd_link.h"
+
+#define LINK_TEST_MAX_CHUNK     (32 * 1024)
+
+typedef struct {
+    lcd_link_probe_t base;
+    uint32_t clean_hz;          /* Bit errors on every transfer above this clock */
+    uint32_t marginal_hz;       /* Up to clean_hz every other transfer or so loses a bit, 0 is none */
+    uint32_t underrun_hz;       /* Above this clock chunks larger than underrun_bytes lose their tail */
+    uint32_t underrun_bytes;
+    uint32_t refused_hz;        /* Clock configure() fails for, 0 is none */
+    uint32_t pclk_hz;
+    uint32_t chunk_bytes;
+    uint32_t rng;
+} link_sim_t;
+
+typedef struct {
+    const char *name;
+    link_sim_t sim;
+    uint16_t rounds;
+    esp_err_t ret;
+    uint32_t pclk_hz;
+    uint32_t chunk_bytes;
+    uint16_t tried;
+} link_case_t;
+
+static uint8_t tx[LINK_TEST_MAX_CHUNK];
+static uint8_t rx[LINK_TEST_MAX_CHUNK];
+
+static const lcd_link_ladder_t ladder = {
+    .pclk_hz = { 80000000, 40000000, 26666666, 20000000 },
+    .chunk_bytes = { LINK_TEST_MAX_CHUNK, 16 * 1024, 4 * 1024 },
+};
+
+static uint32_t link_sim_rand(link_sim_t *sim)
+{
+    sim->rng ^= sim->rng << 13;
+    sim->rng ^= sim->rng >> 17;
+    sim->rng ^= sim->rng << 5;
+    return sim->rng;
+}
+
+static esp_err_t link_sim_configure(lcd_link_probe_t *probe, uint32_t pclk_hz, uint32_t chunk_bytes)
+{
+    link_sim_t *sim = (link_sim_t *)probe;
+
+    if (pclk_hz == sim->refused_hz || chunk_bytes > LINK_TEST_MAX_CHUNK) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    sim->pclk_hz = pclk_hz;
+    sim->chunk_bytes = chunk_bytes;
+    return ESP_OK;
+}
+
+static esp_err_t link_sim_transfer(lcd_link_probe_t *probe, const uint8_t *tx, uint8_t *rx, size_t len)
+{
+    link_sim_t *sim = (link_sim_t *)probe;
+
+    memcpy(rx, tx, len);
+    if (sim->pclk_hz > sim->underrun_hz && len > sim->underrun_bytes) {
+        memset(rx + sim->underrun_bytes, 0, len - sim->underrun_bytes);
+    }
+    const bool marginal = sim->marginal_hz && sim->pclk_hz > sim->marginal_hz && sim->pclk_hz <= sim->clean_hz;
+    if (sim->pclk_hz > sim->clean_hz || (marginal && link_sim_rand(sim) % 3 == 0)) {
+        const uint32_t bit = link_sim_rand(sim) % (len * 8);
+        rx[bit / 8] ^= 1 << (bit % 8);
+    }
+    return ESP_OK;
+}
+
+static bool link_test_case(link_case_t *c)
+{
+    lcd_link_ladder_t l = ladder;
+    lcd_link_result_t res;
+
+    c->sim.base.configure = link_sim_configure;
+    c->sim.base.transfer = link_sim_transfer;
+    c->sim.rng = 0x2545F491;
+    l.rounds = c->rounds;
+    const esp_err_t ret = lcd_link_tune(&c->sim.base, &l, tx, rx, &res);
+    if (ret != c->ret || res.pclk_hz != c->pclk_hz || res.chunk_bytes != c->chunk_bytes || res.tried != c->tried) {
+        printf("FAIL %s: %s, %"PRIu32" Hz, %"PRIu32" B after %u tries, expected %s, %"PRIu32" Hz, %"PRIu32" B after %u\n",
+               c->name, esp_err_to_name(ret), res.pclk_hz, res.chunk_bytes, res.tried, esp_err_to_name(c->ret),
+               c->pclk_hz, c->chunk_bytes, c->tried);
+        return false;
+    }
+    printf("ok   %s: %"PRIu32" Hz, %"PRIu32" B after %u tries\n", c->name, res.pclk_hz, res.chunk_bytes, res.tried);
+    return true;
+}
+
+int main(void)
+{
+    link_case_t cases[] = {
+        {
+            .name = "clean link",
+            .sim = { .clean_hz = 80000000, .underrun_hz = 80000000 },
+            .rounds = 8, .ret = ESP_OK, .pclk_hz = 80000000, .chunk_bytes = LINK_TEST_MAX_CHUNK, .tried = 1,
+        },
+        {
+            .name = "clock limit",
+            .sim = { .clean_hz = 40000000, .underrun_hz = 80000000 },
+            .rounds = 8, .ret = ESP_OK, .pclk_hz = 40000000, .chunk_bytes = LINK_TEST_MAX_CHUNK, .tried = 4,
+        },
+        {
+            .name = "PSRAM underrun",
+            .sim = { .clean_hz = 80000000, .underrun_hz = 40000000, .underrun_bytes = 16 * 1024 },
+            .rounds = 8, .ret = ESP_OK, .pclk_hz = 80000000, .chunk_bytes = 16 * 1024, .tried = 2,
+        },
+        {
+            .name = "marginal clock",
+            .sim = { .clean_hz = 80000000, .marginal_hz = 40000000, .underrun_hz = 80000000 },
+            .rounds = 8, .ret = ESP_OK, .pclk_hz = 40000000, .chunk_bytes = LINK_TEST_MAX_CHUNK, .tried = 4,
+        },
+        {
+            .name = "refused clock",
+            .sim = { .clean_hz = 40000000, .underrun_hz = 80000000, .refused_hz = 40000000 },
+            .rounds = 8, .ret = ESP_OK, .pclk_hz = 26666666, .chunk_bytes = LINK_TEST_MAX_CHUNK, .tried = 7,
+        },
+        {
+            .name = "dead link",
+            .sim = { .clean_hz = 0, .underrun_hz = 80000000 },
+            .rounds = 8, .ret = ESP_ERR_NOT_FOUND, .pclk_hz = 20000000, .chunk_bytes = 4 * 1024, .tried = 12,
+        },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        if (!link_test_case(&cases[i])) {
+            return 1;
+        }
+    }
+
+    /* A stored result is only reused for the same candidates */
+    lcd_link_ladder_t other = ladder;
+    const uint32_t hash = lcd_link_ladder_hash(&ladder);
+    other.chunk_bytes[2] = 8 * 1024;
+    const uint32_t hash_chunk = lcd_link_ladder_hash(&other);
+    other = ladder;
+    other.rounds = 4;
+    if (hash != lcd_link_ladder_hash(&ladder) || hash_chunk == hash || lcd_link_ladder_hash(&other) == hash) {
+        printf("FAIL ladder hash does not tell ladders apart\n");
+        return 1;
+    }
+    printf("ok   ladder hash\n");
+    return 0;
+}
@@ -0,0 +1,57 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * LVGL configuration of the host build, following the firmware's sdkconfig where the
+ * rendering depends on it. Not set here: the custom OS and heap (LVGL's own heap and no
+ * OS instead) and the ESP32-S3 assembly blenders.
+ */
+
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#define LV_COLOR_DEPTH                  16
+
+#define LV_USE_STDLIB_MALLOC            LV_STDLIB_BUILTIN
+#define LV_USE_STDLIB_STRING            LV_STDLIB_BUILTIN
+#define LV_USE_STDLIB_SPRINTF           LV_STDLIB_BUILTIN
+#define LV_MEM_SIZE                     (1024 * 1024)
+
+#define LV_USE_OS                       LV_OS_NONE
+
+#define LV_DEF_REFR_PERIOD              33
+#define LV_DPI_DEF                      130
+
+#define LV_USE_DRAW_SW                  1
+#define LV_DRAW_SW_DRAW_UNIT_CNT        1
+#define LV_DRAW_SW_COMPLEX              1
+#define LV_DRAW_BUF_ALIGN               4
+#define LV_DRAW_SW_SUPPORT_RGB565       1
+#define LV_DRAW_SW_SUPPORT_RGB565_SWAPPED 1
+#define LV_DRAW_LAYER_SIMPLE_BUF_SIZE   (24 * 1024)
+
+#define LV_CACHE_DEF_SIZE               0
+#define LV_IMAGE_HEADER_CACHE_DEF_CNT   0
+
+#define LV_USE_LOG                      1
+#define LV_LOG_LEVEL                    LV_LOG_LEVEL_WARN
+#define LV_LOG_PRINTF                   1
+
+#define LV_USE_ASSERT_NULL              1
+#define LV_USE_ASSERT_MALLOC            1
+
+#define LV_FONT_MONTSERRAT_14           1
+#define LV_FONT_DEFAULT                 &lv_font_montserrat_14
+
+#define LV_USE_THEME_DEFAULT            1
+#define LV_THEME_DEFAULT_DARK           0
+#define LV_THEME_DEFAULT_GROW           1
+#define LV_THEME_DEFAULT_TRANSITION_TIME 80
+
+#define LV_USE_GIF                      1
+#define LV_USE_SNAPSHOT                 1
+
+#define LV_BUILD_EXAMPLES               1
+
+#endif /* LV_CONF_H */
@@ -0,0 +1,296 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Runs the firmware's first screen (main/app_ui.c) on the host against the simulated
+ * GC9D01 panel of lcd_sim.c, for a fixed span of virtual time, and reports the frame rate,
+ * the bytes on the wire per frame and the host CPU time LVGL spent per frame.
+ *
+ * The defaults follow main.c: 160x160, 80 MHz SPI, full refresh with two full-screen
+ * buffers. Virtual time only advances with the modeled SPI traffic and LVGL's timers, so
+ * two runs give the same frames and numbers; --cpu-scale adds the host render time, scaled,
+ * to the clock to approximate a slower CPU instead.
+ */
+
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "esp_check.h"
+#include "lvgl.h"
+#include "app_ui.h"
+#include "img_bulb_gif.h"
+#include "lv_mem_prof.h"
+#include "lcd_sim.h"
+#include "host_disp.h"
+
+#define HOST_MEM_PROF_BLOCKS    (4096)
+
+static const char *TAG = "lcd_host";
+
+typedef struct {
+    /* Options */
+    double seconds;
+    host_disp_cfg_t disp_cfg;
+    double cpu_scale;
+    const char *ppm_dir;
+    uint32_t ppm_every;
+    const char *mem_report;
+    FILE *mem_trace;
+    app_ui_anim_t anim;
+
+    int64_t render_ns;
+} host_ctx_t;
+
+static host_ctx_t host = {
+    .seconds = 5.0,
+    .disp_cfg = HOST_DISP_CFG_DEFAULT(),
+    .ppm_every = 1,
+    .anim = APP_UI_ANIM_A565,
+};
+
+static int64_t host_cpu_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/* LVGL's heap calls as EXAMPLE_LVGL_MEM_TRACE prints them, for tools/alloc_replay.c; linked with
+ * -Wl,--wrap=lv_malloc_core,... like lv_mem_app.c's calls on the target */
+void *__real_lv_malloc_core(size_t size);
+void *__real_lv_realloc_core(void *p, size_t new_size);
+void __real_lv_free_core(void *p);
+
+void *__wrap_lv_malloc_core(size_t size)
+{
+    void *ptr = __real_lv_malloc_core(size);
+
+    if (host.mem_trace) {
+        fprintf(host.mem_trace, "LVMEM a %x %u\n", (unsigned)(uintptr_t)ptr, (unsigned)size);
+    }
+    return ptr;
+}
+
+void *__wrap_lv_realloc_core(void *p, size_t new_size)
+{
+    void *ptr = __real_lv_realloc_core(p, new_size);
+
+    if (host.mem_trace) {
+        fprintf(host.mem_trace, "LVMEM r %x %x %u\n", (unsigned)(uintptr_t)p, (unsigned)(uintptr_t)ptr,
+                (unsigned)new_size);
+    }
+    return ptr;
+}
+
+void __wrap_lv_free_core(void *p)
+{
+    if (host.mem_trace) {
+        fprintf(host.mem_trace, "LVMEM f %x\n", (unsigned)(uintptr_t)p);
+    }
+    __real_lv_free_core(p);
+}
+
+static void host_frame_cb(uint32_t frame, void *user_ctx)
+{
+    if (host.ppm_dir && frame % host.ppm_every == 0) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/frame_%05"PRIu32".ppm", host.ppm_dir, frame);
+        lcd_sim_write_ppm(path);
+    }
+}
+
+static void host_run(void)
+{
+    const int64_t end_us = lcd_sim_now_us() + (int64_t)(host.seconds * 1000000.0);
+
+    while (lcd_sim_now_us() < end_us) {
+        const int64_t t0 = host_cpu_ns();
+        uint32_t wait_ms = lv_timer_handler();
+        const int64_t spent_ns = host_cpu_ns() - t0;
+
+        host.render_ns += spent_ns;
+        if (host.cpu_scale > 0) {
+            lcd_sim_advance(lcd_sim_now_us() + (int64_t)(spent_ns * host.cpu_scale / 1000.0));
+        }
+        if (wait_ms == LV_NO_TIMER_READY) {
+            wait_ms = LV_DEF_REFR_PERIOD;
+        }
+        lcd_sim_advance(lcd_sim_now_us() + LV_MAX(wait_ms, 1) * 1000);
+    }
+    host_disp_drain();
+}
+
+static void host_report(int64_t start_us)
+{
+    lcd_sim_stats_t st;
+    host_disp_stats_t ds;
+    lcd_sim_get_stats(&st);
+    host_disp_get_stats(&ds);
+
+    const double secs = (lcd_sim_now_us() - start_us) / 1e6;
+    const double frames = ds.frames ? ds.frames : 1;
+    printf("%"PRIu32" frames, %"PRIu32" flushes in %.3f s virtual: %.1f FPS\n", ds.frames, ds.flushes, secs,
+           ds.frames / secs);
+    printf("wire: %.0f B/frame (%.0f pixel, %.0f command), %.1f transactions/frame\n",
+           (st.px_bytes + st.cmd_bytes) / frames, st.px_bytes / frames, st.cmd_bytes / frames, st.trans / frames);
+    printf("bus: %.1f %% busy, %.1f FPS when bus bound\n", st.busy_ns / 1e7 / secs,
+           st.busy_ns ? 1e9 * frames / st.busy_ns : 0.0);
+    printf("host render: %.3f ms/frame\n", host.render_ns / 1e6 / frames);
+    if (ds.dedup.bands) {
+        printf("dedup: %"PRIu32"/%"PRIu32" bands, %"PRIu32"/%"PRIu32" flushes skipped, %.0f B/s saved\n",
+               ds.dedup.bands_skipped, ds.dedup.bands, ds.dedup.areas_skipped, ds.dedup.areas,
+               ds.dedup.bytes_saved / secs);
+    }
+    if (ds.diff.frames) {
+        printf("diff: %"PRIu32" frames, %"PRIu32" unchanged, %.1f tiles/frame, %.1f windows/frame, %.0f B/s saved\n",
+               ds.diff.frames, ds.diff.frames_skipped, ds.diff.tiles_changed / frames, ds.diff.rects / frames,
+               ds.diff.bytes_saved / secs);
+    }
+    if (st.timing_errors) {
+        printf("panel timing errors: %"PRIu32"\n", st.timing_errors);
+    }
+}
+
+static void host_usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --seconds S       virtual time to run (5)\n"
+            "  --pclk HZ         SPI clock (80000000)\n"
+            "  --trans-ns NS     overhead per SPI transaction (2000)\n"
+            "  --chunk BYTES     largest color transaction (51200)\n"
+            "  --queue N         color transactions in flight (10)\n"
+            "  --partial         partial refresh instead of full refresh\n"
+            "  --rows N          draw buffer rows (160)\n"
+            "  --single          one draw buffer\n"
+            "  --pipe N          flush through lcd_pipe with N buffers (0, 2 with --dedup or --diff)\n"
+            "  --dedup ROWS      lcd_pipe skips unchanged bands of ROWS rows (0)\n"
+            "  --diff TILE       lcd_pipe sends only changed TILExTILE tiles, full refresh (0)\n"
+            "  --cpu-scale X     add host render time x X to the virtual clock (0)\n"
+            "  --anim NAME       a565, gif-cache or gif (a565)\n"
+            "  --ppm DIR         write frames to DIR/frame_NNNNN.ppm\n"
+            "  --ppm-every N     only every Nth frame (1)\n"
+            "  --shm NAME        publish frames to shared memory, e.g. /lcd_sim\n"
+            "  --mem-report FILE write the LVGL heap profile to FILE\n"
+            "  --mem-trace FILE  write every LVGL heap call to FILE, for tools/alloc_replay.c\n", prog);
+    exit(2);
+}
+
+static void host_parse(int argc, char **argv)
+{
+    static const struct option opts[] = {
+        { "seconds", required_argument, NULL, 's' },
+        { "pclk", required_argument, NULL, 'p' },
+        { "trans-ns", required_argument, NULL, 't' },
+        { "chunk", required_argument, NULL, 'c' },
+        { "queue", required_argument, NULL, 'q' },
+        { "partial", no_argument, NULL, 'P' },
+        { "rows", required_argument, NULL, 'r' },
+        { "single", no_argument, NULL, '1' },
+        { "pipe", required_argument, NULL, 'b' },
+        { "dedup", required_argument, NULL, 'd' },
+        { "diff", required_argument, NULL, 'D' },
+        { "cpu-scale", required_argument, NULL, 'x' },
+        { "anim", required_argument, NULL, 'a' },
+        { "ppm", required_argument, NULL, 'o' },
+        { "ppm-every", required_argument, NULL, 'e' },
+        { "shm", required_argument, NULL, 'm' },
+        { "mem-report", required_argument, NULL, 'M' },
+        { "mem-trace", required_argument, NULL, 'T' },
+        { NULL, 0, NULL, 0 },
+    };
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "", opts, NULL)) != -1) {
+        switch (opt) {
+        case 's': host.seconds = strtod(optarg, NULL); break;
+        case 'p': host.disp_cfg.pclk_hz = strtoul(optarg, NULL, 0); break;
+        case 't': host.disp_cfg.trans_ns = strtoul(optarg, NULL, 0); break;
+        case 'c': host.disp_cfg.chunk_bytes = strtoul(optarg, NULL, 0); break;
+        case 'q': host.disp_cfg.queue_depth = strtoul(optarg, NULL, 0); break;
+        case 'P': host.disp_cfg.partial = true; break;
+        case 'r': host.disp_cfg.rows = strtoul(optarg, NULL, 0); break;
+        case '1': host.disp_cfg.single_buf = true; break;
+        case 'b': host.disp_cfg.pipe_bufs = strtoul(optarg, NULL, 0); break;
+        case 'd': host.disp_cfg.dedup_rows = strtoul(optarg, NULL, 0); break;
+        case 'D': host.disp_cfg.diff_tile = strtoul(optarg, NULL, 0); break;
+        case 'x': host.cpu_scale = strtod(optarg, NULL); break;
+        case 'o': host.ppm_dir = optarg; break;
+        case 'e': host.ppm_every = LV_MAX(strtoul(optarg, NULL, 0), 1); break;
+        case 'm': host.disp_cfg.shm_name = optarg; break;
+        case 'M': host.mem_report = optarg; break;
+        case 'T':
+            host.mem_trace = fopen(optarg, "w");
+            if (!host.mem_trace) {
+                perror(optarg);
+                exit(2);
+            }
+            break;
+        case 'a':
+            if (strcmp(optarg, "a565") == 0) {
+                host.anim = APP_UI_ANIM_A565;
+            } else if (strcmp(optarg, "gif-cache") == 0) {
+                host.anim = APP_UI_ANIM_GIF_CACHE;
+            } else if (strcmp(optarg, "gif") == 0) {
+                host.anim = APP_UI_ANIM_GIF;
+            } else {
+                host_usage(argv[0]);
+            }
+            break;
+        default:
+            host_usage(argv[0]);
+        }
+    }
+    if (optind != argc || host.seconds <= 0) {
+        host_usage(argv[0]);
+    }
+    /* The filters live in the pipeline, like EXAMPLE_LCD_PIPE_BUFS in main.c */
+    if (!host.disp_cfg.pipe_bufs && (host.disp_cfg.dedup_rows || host.disp_cfg.diff_tile)) {
+        host.disp_cfg.pipe_bufs = 2;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    host_parse(argc, argv);
+
+    if (host.mem_report && lv_mem_prof_start(HOST_MEM_PROF_BLOCKS) != LV_RESULT_OK) {
+        ESP_LOGE(TAG, "Heap profiler start failed");
+        return 1;
+    }
+    lv_init();
+
+    lv_display_t *disp;
+    host.disp_cfg.on_frame = host_frame_cb;
+    ESP_ERROR_CHECK(host_disp_init(&host.disp_cfg, &disp));
+
+    const int64_t start_us = lcd_sim_now_us();
+    const app_ui_cfg_t ui_cfg = {
+        .anim = host.anim,
+        .gif = &img_bulb_gif0,
+        .gif_cfg = {
+            .budget_bytes = 512 * 1024,
+        },
+    };
+    if (!app_ui_create(lv_display_get_screen_active(disp), &ui_cfg)) {
+        return 1;
+    }
+
+    host_run();
+    host_report(start_us);
+
+    if (host.mem_report && lv_mem_prof_dump_file(host.mem_report) != LV_RESULT_OK) {
+        ESP_LOGE(TAG, "Write %s failed", host.mem_report);
+        return 1;
+    }
+    if (host.mem_trace && fclose(host.mem_trace) != 0) {
+        ESP_LOGE(TAG, "Write the heap trace failed");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Host test of rendering in the panel's byte order (main/lcd_native.h).
+ *
+ * The firmware's first screen over the C565 background, with a translucent gradient card,
+ * rounded corners, a shadow and anti-aliased text on top, runs for a number of frames. Each
+ * frame is drawn twice on the simulated panel: as RGB565 swapped on flush, the port's
+ * swap_bytes path, and as RGB565_SWAPPED sent untouched after lcd_native_attach(). The
+ * panel has to show the same pixels both ways.
+ *
+ * Exits with 1 on the first frame that differs.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include "lvgl.h"
+#include "app_ui.h"
+#include "img_c565.h"
+#include "bg_bulb.h"
+#include "lcd_native.h"
+#include "lcd_sim.h"
+#include "host_disp.h"
+
+#define NATIVE_TEST_FRAMES      (40)
+
+static void native_test_scene(lv_obj_t *scr)
+{
+    const app_ui_cfg_t cfg = {
+        .anim = APP_UI_ANIM_A565,
+    };
+    lv_obj_t *bg = lv_image_create(scr);
+
+    lv_image_set_src(bg, &bg_bulb);
+    lv_obj_center(bg);
+    app_ui_create(scr, &cfg);
+
+    lv_obj_t *card = lv_obj_create(scr);
+    lv_obj_remove_flag(card, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_size(card, 90, 36);
+    lv_obj_align(card, LV_ALIGN_BOTTOM_MID, 0, -6);
+    lv_obj_set_style_radius(card, 10, 0);
+    lv_obj_set_style_bg_opa(card, LV_OPA_60, 0);
+    lv_obj_set_style_bg_color(card, lv_color_hex(0x3080F0), 0);
+    lv_obj_set_style_bg_grad_color(card, lv_color_hex(0xF0A010), 0);
+    lv_obj_set_style_bg_grad_dir(card, LV_GRAD_DIR_HOR, 0);
+    lv_obj_set_style_shadow_width(card, 12, 0);
+
+    lv_obj_t *label = lv_label_create(card);
+    lv_label_set_text(label, "Ag 0123");
+    lv_obj_set_style_text_color(label, lv_color_white(), 0);
+    lv_obj_center(label);
+}
+
+/* The screen drawn as a whole in one color format, as the panel then shows it */
+static uint32_t native_test_draw(lv_display_t *disp, lv_color_format_t cf)
+{
+    lv_display_set_color_format(disp, cf);
+    lv_obj_invalidate(lv_screen_active());
+    lv_refr_now(disp);
+    host_disp_drain();
+    return lcd_sim_crc32();
+}
+
+int main(void)
+{
+    host_disp_cfg_t cfg = HOST_DISP_CFG_DEFAULT();
+    lv_display_t *disp;
+
+    lv_init();
+    if (host_disp_init(&cfg, &disp) != ESP_OK || img_c565_init() != ESP_OK) {
+        printf("FAIL setup\n");
+        return 1;
+    }
+    native_test_scene(lv_screen_active());
+
+    /* What the firmware does at boot, the host display then stops swapping on flush */
+    if (!lcd_native_attach(disp) || lv_display_get_color_format(disp) != LV_COLOR_FORMAT_RGB565_SWAPPED) {
+        printf("FAIL LVGL renders no RGB565_SWAPPED\n");
+        return 1;
+    }
+
+    const int64_t start_us = lcd_sim_now_us();
+    for (uint32_t f = 0; f < NATIVE_TEST_FRAMES; f++) {
+        lcd_sim_advance(start_us + (int64_t)f * LV_DEF_REFR_PERIOD * 1000);
+        lv_timer_handler();
+        host_disp_drain();
+
+        const uint32_t swapped = native_test_draw(disp, LV_COLOR_FORMAT_RGB565);
+        const uint32_t native = native_test_draw(disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+        if (swapped != native) {
+            printf("FAIL frame %"PRIu32": %08"PRIx32" swapped on flush, %08"PRIx32" in panel order\n", f, swapped,
+                   native);
+            return 1;
+        }
+    }
+    printf("ok   %d frames identical in both byte orders\n", NATIVE_TEST_FRAMES);
+    return 0;
+}
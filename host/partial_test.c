@@ -0,0 +1,102 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Host test of the partial refresh rounder (main/lcd_partial.h).
+ *
+ * Rectangles at odd positions and sizes move, resize and recolor on a partial refresh
+ * display of the simulated panel with lcd_partial attached. Every flushed window has to
+ * lie on the CASET / RASET grid, and after each frame the panel's GRAM, built only from
+ * those aligned windows, has to match a full redraw of the same screen.
+ *
+ * lcd_sim writes any window exactly, it does not model the stray pixels the panel shows for
+ * windows off the grid. So this checks the window grid and that aligned windows still
+ * rebuild the screen, not the panel artifact itself.
+ *
+ * Exits with 1 on the first failure.
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "lvgl.h"
+#include "lcd_partial.h"
+#include "lcd_sim.h"
+#include "host_disp.h"
+
+#define PARTIAL_TEST_FRAMES     (300)
+#define PARTIAL_TEST_ROWS       (40)    /* Draw buffer rows, windows taller than this are split */
+
+static const lcd_partial_cfg_t partial_cfg = {
+    .align_x = 2,
+    .align_y = 2,
+    .window_cost_px = 256,
+};
+
+static uint32_t off_grid;
+
+static void partial_test_flush_start_cb(lv_event_t *e)
+{
+    const lv_area_t *a = lv_event_get_param(e);
+    const int32_t ax = partial_cfg.align_x;
+    const int32_t ay = partial_cfg.align_y;
+
+    if (a->x1 % ax || a->y1 % ay || (a->x2 + 1) % ax || (a->y2 + 1) % ay) {
+        printf("FAIL window (%"PRId32",%"PRId32")-(%"PRId32",%"PRId32") off the %"PRId32"x%"PRId32" grid\n",
+               a->x1, a->y1, a->x2, a->y2, ax, ay);
+        off_grid++;
+    }
+}
+
+static uint32_t partial_test_refresh(void)
+{
+    lv_refr_now(NULL);
+    host_disp_drain();
+    return lcd_sim_crc32();
+}
+
+int main(void)
+{
+    host_disp_cfg_t cfg = HOST_DISP_CFG_DEFAULT();
+    lv_display_t *disp;
+    lv_obj_t *objs[HOST_DISP_SCENE_OBJS];
+
+    cfg.partial = true;
+    cfg.rows = PARTIAL_TEST_ROWS;
+    lv_init();
+    if (host_disp_init(&cfg, &disp) != ESP_OK || lcd_partial_attach(disp, &partial_cfg) != ESP_OK) {
+        printf("FAIL setup\n");
+        return 1;
+    }
+    lv_display_add_event_cb(disp, partial_test_flush_start_cb, LV_EVENT_FLUSH_START, NULL);
+
+    lv_obj_t *scr = lv_screen_active();
+    host_disp_scene_create(scr, objs, 0x2545F491);
+    partial_test_refresh();
+
+    for (uint32_t f = 0; f < PARTIAL_TEST_FRAMES; f++) {
+        const int n = 1 + host_disp_rand() % 3;
+        for (int i = 0; i < n; i++) {
+            host_disp_scene_mutate(objs);
+        }
+        const uint32_t partial = partial_test_refresh();
+
+        /* The same screen drawn as a whole */
+        lv_obj_invalidate(scr);
+        const uint32_t full = partial_test_refresh();
+        if (off_grid) {
+            return 1;
+        }
+        if (partial != full) {
+            printf("FAIL frame %"PRIu32": GRAM %08"PRIx32" from the windows, %08"PRIx32" redrawn\n", f, partial, full);
+            return 1;
+        }
+    }
+
+    lcd_partial_stats_t st;
+    lcd_partial_get_stats(disp, &st);
+    printf("ok   %ux%u grid, cost %"PRIu32": %"PRIu32" frames, %"PRIu32" areas merged\n", partial_cfg.align_x,
+           partial_cfg.align_y, partial_cfg.window_cost_px, st.frames, st.merged);
+    return 0;
+}
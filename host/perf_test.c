@@ -0,0 +1,125 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Host test of the frame timing ring (main/lcd_perf.h).
+ *
+ * A producer thread plays the display events of many frames, half of them finishing their
+ * last flush after the render is done like the port's DMA does, while the main thread keeps
+ * copying the ring. Each frame has its own number of flushes and a flush size that depends
+ * on it, so a copy mixing two frames or slots shows as a byte count that does not fit, and
+ * the copied frames have to be in order.
+ *
+ *   ./perf_test [frames]
+ *
+ * Exits with 1 on the first torn or misordered copy.
+ */
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "lvgl.h"
+#include "lcd_perf.h"
+
+#define PERF_TEST_ROWS      (10)    /* Rows of every flush, the width is the frame's flush count */
+#define PERF_TEST_FLUSHES   (7)
+
+typedef struct {
+    lv_display_t *disp;
+    uint32_t frames;
+    atomic_bool done;
+} perf_test_ctx_t;
+
+static void *perf_test_producer(void *arg)
+{
+    perf_test_ctx_t *ctx = arg;
+
+    for (uint32_t k = 0; k < ctx->frames; k++) {
+        const int32_t flushes = 1 + k % PERF_TEST_FLUSHES;
+        const bool late = k & 1;
+        lv_area_t area;
+
+        lv_area_set(&area, 0, 0, flushes - 1, PERF_TEST_ROWS - 1);
+        lv_display_send_event(ctx->disp, LV_EVENT_RENDER_START, NULL);
+        for (int32_t i = 0; i < flushes; i++) {
+            lv_display_send_event(ctx->disp, LV_EVENT_FLUSH_START, &area);
+            if (!late || i + 1 < flushes) {
+                lcd_perf_flush_done(ctx->disp);
+            }
+        }
+        lv_display_send_event(ctx->disp, LV_EVENT_RENDER_READY, NULL);
+        if (late) {
+            lcd_perf_flush_done(ctx->disp);
+        }
+    }
+    atomic_store(&ctx->done, true);
+    return NULL;
+}
+
+static bool perf_test_check(const lcd_perf_frame_t *frames, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        const lcd_perf_frame_t *f = &frames[i];
+        if (f->flushes < 1 || f->flushes > PERF_TEST_FLUSHES ||
+                f->bytes != (uint32_t)f->flushes * f->flushes * PERF_TEST_ROWS * sizeof(uint16_t)) {
+            printf("FAIL frame %"PRIu32" of %"PRIu32": %u flushes, %"PRIu32" bytes\n", i, n, f->flushes, f->bytes);
+            return false;
+        }
+        if (f->flush_start < f->render_start || f->render_end < f->flush_start || f->dma_done < f->flush_start) {
+            printf("FAIL frame %"PRIu32" of %"PRIu32": timestamps out of order\n", i, n);
+            return false;
+        }
+        if (i && (f->render_start < frames[i - 1].render_start ||
+                  f->flushes != frames[i - 1].flushes % PERF_TEST_FLUSHES + 1)) {
+            printf("FAIL frame %"PRIu32" of %"PRIu32": does not follow the one before\n", i, n);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    static lcd_perf_frame_t frames[LCD_PERF_RING_SIZE];
+    perf_test_ctx_t ctx = {
+        .frames = argc > 1 ? strtoul(argv[1], NULL, 10) : 200000,
+    };
+    pthread_t producer;
+    uint32_t copies = 0;
+
+    lv_init();
+    ctx.disp = lv_display_create(160, 160);
+    if (!ctx.disp || lcd_perf_attach(ctx.disp) != ESP_OK) {
+        printf("FAIL setup\n");
+        return 1;
+    }
+    if (pthread_create(&producer, NULL, perf_test_producer, &ctx) != 0) {
+        printf("FAIL thread\n");
+        return 1;
+    }
+
+    bool ok = true;
+    while (ok && !atomic_load(&ctx.done)) {
+        ok = perf_test_check(frames, lcd_perf_get_frames(frames, LCD_PERF_RING_SIZE));
+        copies++;
+    }
+    pthread_join(producer, NULL);
+    if (!ok) {
+        return 1;
+    }
+
+    lcd_perf_summary_t s;
+    const uint32_t n = lcd_perf_get_frames(frames, LCD_PERF_RING_SIZE);
+    if (!perf_test_check(frames, n) || n != LV_MIN(ctx.frames, LCD_PERF_RING_SIZE) ||
+            lcd_perf_get_summary(&s) != ESP_OK || s.frames != n) {
+        printf("FAIL final ring of %"PRIu32" frames\n", n);
+        return 1;
+    }
+    printf("ok   %"PRIu32" frames, %"PRIu32" ring copies while producing, %"PRIu32" B/frame on average\n",
+           ctx.frames, copies, s.bytes_avg);
+    return 0;
+}
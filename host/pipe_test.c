@@ -0,0 +1,148 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Host test of the render-ahead flush pipeline (main/lcd_pipe.h).
+ *
+ * lcd_pipe takes the flush of the simulated panel's display over, its transfer task runs on
+ * its own thread (host/freertos_host.c) while LVGL renders ahead into the pool. Rectangles
+ * move, resize and recolor (host_disp_scene_mutate()). Every buffer LVGL flushes has to be one of
+ * the pool's own aligned descriptors, the display's descriptors have to keep their memory,
+ * and after each frame the panel has to match a full redraw through the pipeline.
+ *
+ *   ./pipe_test [partial|full]
+ *
+ * In full refresh the pipeline also drops stale frames and sends only the changed tiles.
+ * Exits with 1 on the first failure.
+ */
+
+#include <inttypes.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "lvgl.h"
+#include "lcd_pipe.h"
+#include "lcd_sim.h"
+#include "host_disp.h"
+
+#define PIPE_TEST_FRAMES    (300)
+#define PIPE_TEST_ROWS      (40)    /* Draw buffer rows in partial refresh, a frame is several flushes */
+#define PIPE_TEST_BUFS      (3)     /* The display's two buffers and one of the pipeline's */
+
+static lv_draw_buf_t *seen[PIPE_TEST_BUFS];
+static uint32_t bad_bufs;
+
+/* The buffer about to be queued, LVGL renders the next area elsewhere */
+static void pipe_test_flush_start_cb(lv_event_t *e)
+{
+    lv_display_t *disp = lv_event_get_target(e);
+    lv_draw_buf_t *orig = lv_event_get_user_data(e);
+    lv_draw_buf_t *buf = lv_display_get_buf_active(disp);
+    int i = 0;
+
+    while (i < PIPE_TEST_BUFS && seen[i] && seen[i] != buf) {
+        i++;
+    }
+    if (buf == orig || i == PIPE_TEST_BUFS || (uintptr_t)buf->data % LV_DRAW_BUF_ALIGN) {
+        printf("FAIL flush from %p (data %p), not an aligned buffer of the pool\n", (void *)buf, buf->data);
+        bad_bufs++;
+        return;
+    }
+    seen[i] = buf;
+}
+
+/* The transfer task sends on its own thread, the clock runs until every buffer is back */
+static uint32_t pipe_test_refresh(void)
+{
+    lcd_pipe_stats_t st;
+
+    lv_refr_now(NULL);
+    while (lcd_pipe_get_stats(&st) == ESP_OK && st.depth) {
+        if (!lcd_sim_wait()) {
+            sched_yield();
+        }
+    }
+    return lcd_sim_crc32();
+}
+
+int main(int argc, char **argv)
+{
+    const bool full = argc > 1 && strcmp(argv[1], "full") == 0;
+    host_disp_cfg_t cfg = HOST_DISP_CFG_DEFAULT();
+    lv_display_t *disp;
+    lv_obj_t *objs[HOST_DISP_SCENE_OBJS];
+
+    cfg.partial = !full;
+    cfg.rows = full ? HOST_DISP_V_RES : PIPE_TEST_ROWS;
+    lv_init();
+    if (host_disp_init(&cfg, &disp) != ESP_OK) {
+        printf("FAIL setup\n");
+        return 1;
+    }
+
+    /* The port's descriptors, the pipeline may use their memory but not rewrite them */
+    lv_draw_buf_t *orig = lv_display_get_buf_active(disp);
+    uint8_t *orig_data = orig->data;
+    lcd_pipe_cfg_t pipe_cfg = {
+        .disp = disp,
+        .buf_num = PIPE_TEST_BUFS,
+        .buf_caps = MALLOC_CAP_DEFAULT,
+        .drop_stale = full,
+        .swap_bytes = true,
+        .diff_tile = full ? 8 : 0,
+        .diff_max_rects = 8,
+        .diff_window_cost_px = 256,
+        .task_priority = 5,
+        .task_stack = 4096,
+        .task_affinity = -1,
+    };
+    host_disp_get_panel(&pipe_cfg.io, &pipe_cfg.panel);
+    if (lcd_pipe_init(&pipe_cfg) != ESP_OK) {
+        printf("FAIL pipeline init\n");
+        return 1;
+    }
+    lv_display_add_event_cb(disp, pipe_test_flush_start_cb, LV_EVENT_FLUSH_START, orig);
+
+    lv_obj_t *scr = lv_screen_active();
+    host_disp_scene_create(scr, objs, 0x2545F491);
+    pipe_test_refresh();
+
+    for (uint32_t f = 0; f < PIPE_TEST_FRAMES; f++) {
+        const int n = 1 + host_disp_rand() % 3;
+        for (int i = 0; i < n; i++) {
+            host_disp_scene_mutate(objs);
+        }
+        const uint32_t piped = pipe_test_refresh();
+
+        /* The same screen drawn as a whole */
+        lv_obj_invalidate(scr);
+        const uint32_t whole = pipe_test_refresh();
+        if (bad_bufs) {
+            return 1;
+        }
+        if (piped != whole) {
+            printf("FAIL frame %"PRIu32": GRAM %08"PRIx32" through the pipeline, %08"PRIx32" redrawn\n", f, piped,
+                   whole);
+            return 1;
+        }
+    }
+
+    lcd_pipe_stats_t st;
+    lcd_pipe_get_stats(&st);
+    if (orig->data != orig_data) {
+        printf("FAIL the display's draw buffer was pointed at %p\n", orig->data);
+        return 1;
+    }
+    if (st.depth || st.max_depth > PIPE_TEST_BUFS || st.sent + st.dropped > st.flushes ||
+            (!full && st.sent != st.flushes)) {
+        printf("FAIL %"PRIu32" flushes, %"PRIu32" sent, %"PRIu32" dropped, depth %u of at most %u\n", st.flushes,
+               st.sent, st.dropped, st.depth, st.max_depth);
+        return 1;
+    }
+    printf("ok   %s refresh: %"PRIu32" flushes, %"PRIu32" sent, %"PRIu32" dropped, %"PRIu32" stalls, depth up to %u\n",
+           full ? "full" : "partial", st.flushes, st.sent, st.dropped, st.stalls, st.max_depth);
+    return 0;
+}
@@ -0,0 +1,126 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Host test of striped full refresh (main/lcd_stripe.h).
+ *
+ * The same frames of moving rectangles are drawn twice on the simulated panel: first with
+ * the port's flush, a CASET / RASET / RAMWR window per band, then with lcd_stripe, which
+ * opens one window per frame and continues it with RAMWRC. Before every striped frame the
+ * panel is filled with noise, so each frame has to be rebuilt whole from the RAMWRC
+ * sequence and match the port's, with exactly one window opened.
+ *
+ * Exits with 1 on the first failure.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include "esp_lcd_panel_ops.h"
+#include "lvgl.h"
+#include "lcd_stripe.h"
+#include "lcd_sim.h"
+#include "host_disp.h"
+
+#define STRIPE_TEST_FRAMES      (100)
+#define STRIPE_TEST_ROWS        (24)    /* Band height, 160 rows do not divide into it */
+#define STRIPE_TEST_BANDS       ((HOST_DISP_V_RES + STRIPE_TEST_ROWS - 1) / STRIPE_TEST_ROWS)
+
+static uint32_t ref_crc[STRIPE_TEST_FRAMES];
+
+static uint32_t stripe_test_refresh(void)
+{
+    lv_refr_now(NULL);
+    host_disp_drain();
+    return lcd_sim_crc32();
+}
+
+/* The port's completion: flush ready from the transfer-done callback */
+static bool stripe_test_color_done_cb(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+{
+    lv_display_flush_ready(user_ctx);
+    return false;
+}
+
+/* The transfer-done callback releases the flush, so the bus running dry is the flush done */
+static void stripe_test_flush_wait_cb(lv_display_t *disp)
+{
+    while (lcd_sim_wait()) {
+    }
+}
+
+int main(void)
+{
+    static uint16_t noise[HOST_DISP_H_RES * HOST_DISP_V_RES];
+    host_disp_cfg_t cfg = HOST_DISP_CFG_DEFAULT();
+    esp_lcd_panel_io_handle_t io;
+    esp_lcd_panel_handle_t panel;
+    lv_display_t *disp;
+    lv_obj_t *objs[HOST_DISP_SCENE_OBJS];
+
+    cfg.partial = true;
+    cfg.rows = STRIPE_TEST_ROWS;
+    cfg.single_buf = true;
+    lv_init();
+    if (host_disp_init(&cfg, &disp) != ESP_OK) {
+        printf("FAIL setup\n");
+        return 1;
+    }
+    host_disp_get_panel(&io, &panel);
+    lv_obj_t *scr = lv_screen_active();
+
+    /* Reference: the port's flush, a window per band */
+    host_disp_scene_create(scr, objs, 0x2545F491);
+    stripe_test_refresh();
+    for (uint32_t f = 0; f < STRIPE_TEST_FRAMES; f++) {
+        host_disp_scene_mutate(objs);
+        ref_crc[f] = stripe_test_refresh();
+    }
+
+    const esp_lcd_panel_io_callbacks_t cbs = {
+        .on_color_trans_done = stripe_test_color_done_cb,
+    };
+    const lcd_stripe_cfg_t stripe_cfg = {
+        .io = io,
+        .disp = disp,
+        .swap_bytes = true,
+    };
+    if (esp_lcd_panel_io_register_event_callbacks(io, &cbs, disp) != ESP_OK || lcd_stripe_attach(&stripe_cfg) != ESP_OK) {
+        printf("FAIL stripe attach\n");
+        return 1;
+    }
+    lv_display_set_flush_wait_cb(disp, stripe_test_flush_wait_cb);
+
+    host_disp_scene_create(scr, objs, 0x2545F491);
+    stripe_test_refresh();
+    for (uint32_t f = 0; f < STRIPE_TEST_FRAMES; f++) {
+        /* Noise of its own, the mutations have to follow the reference run */
+        for (uint32_t i = 0; i < HOST_DISP_H_RES * HOST_DISP_V_RES; i++) {
+            noise[i] = (uint16_t)(((i + f * 7919) * 2654435761u) >> 16);
+        }
+        esp_lcd_panel_draw_bitmap(panel, 0, 0, HOST_DISP_H_RES, HOST_DISP_V_RES, noise);
+        host_disp_drain();
+        host_disp_scene_mutate(objs);
+        lv_obj_invalidate(scr);
+
+        lcd_sim_stats_t before, after;
+        lcd_sim_get_stats(&before);
+        const uint32_t crc = stripe_test_refresh();
+        lcd_sim_get_stats(&after);
+
+        /* CASET and RASET with 4 bytes each, RAMWR, then RAMWRC for every further band */
+        const uint64_t cmd_bytes = after.cmd_bytes - before.cmd_bytes;
+        if (cmd_bytes != 2 * 5 + 1 + (STRIPE_TEST_BANDS - 1)) {
+            printf("FAIL frame %"PRIu32": %"PRIu64" command bytes, not one window continued for %d bands\n", f,
+                   cmd_bytes, STRIPE_TEST_BANDS);
+            return 1;
+        }
+        if (crc != ref_crc[f]) {
+            printf("FAIL frame %"PRIu32": GRAM %08"PRIx32" striped, %08"PRIx32" with a window per band\n", f, crc,
+                   ref_crc[f]);
+            return 1;
+        }
+    }
+    printf("ok   %d frames of %d bands rebuilt from RAMWR + RAMWRC\n", STRIPE_TEST_FRAMES, STRIPE_TEST_BANDS);
+    return 0;
+}
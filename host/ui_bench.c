@@ -0,0 +1,516 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Headless UI benchmark on the simulated panel (host_disp.h).
+ *
+ * A fixed set of 160x160 scenes is rendered for a fixed number of frames each. Time is
+ * injected: frame N of a scene is rendered at exactly N frame periods after the scene
+ * started, unless the bus is still busy, so animations land on the same pixels every run.
+ * Per scene it records the host render time per frame, the bytes flushed per frame, the
+ * peak of LVGL's heap (lv_mem_prof.h) and the CRC of every frame as the panel shows it.
+ *
+ * The CRCs are compared with a golden file, which --update-golden writes. Recorded against
+ * the pinned LVGL it is meant to live in host/ui_bench.golden:
+ *
+ *   ./ui_bench --json bench.json --golden ui_bench.golden
+ *
+ * Exits with 1 when a frame differs from the golden one or a scene has no golden CRCs.
+ */
+
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "esp_check.h"
+#include "lvgl.h"
+#include "app_ui.h"
+#include "img_bulb_gif.h"
+#include "img_c565.h"
+#include "bg_bulb.h"
+#include "lv_mem_prof.h"
+#include "scene_bench.h"
+#include "lcd_sim.h"
+#include "host_disp.h"
+
+#define UI_BENCH_PROF_BLOCKS    (4096)
+#define UI_BENCH_GOLDEN_LINE    (64 * 1024)
+
+static const char *TAG = "ui_bench";
+
+typedef struct {
+    const char *name;
+    void (*build)(lv_obj_t *scr);
+    void (*step)(uint32_t frame);       /* Before each frame, NULL for scenes animating themselves */
+} ui_bench_scene_t;
+
+typedef enum {
+    UI_BENCH_GOLDEN_NONE,               /* Not checked, no --golden */
+    UI_BENCH_GOLDEN_MISSING,            /* No golden CRCs for the scene and frame count */
+    UI_BENCH_GOLDEN_PASS,
+    UI_BENCH_GOLDEN_FAIL,
+} ui_bench_golden_t;
+
+typedef struct {
+    uint32_t rendered;                  /* Frames that reached the panel */
+    int64_t render_ns;                  /* Host time in LVGL timers and rendering */
+    uint64_t wire_bytes;
+    uint32_t trans;
+    int64_t busy_ns;
+    uint32_t peak_heap;
+    uint32_t *crc;
+    ui_bench_golden_t golden;
+    int32_t first_mismatch;
+} ui_bench_result_t;
+
+typedef struct {
+    /* Options */
+    uint32_t frames;
+    uint32_t frame_ms;
+    host_disp_cfg_t disp_cfg;
+    const char *only;
+    const char *json_path;
+    const char *golden_path;
+    bool update_golden;
+
+    char *golden;                       /* Golden file contents */
+} ui_bench_ctx_t;
+
+static ui_bench_ctx_t bench = {
+    .frames = 60,
+    .frame_ms = LV_DEF_REFR_PERIOD,
+    .disp_cfg = HOST_DISP_CFG_DEFAULT(),
+};
+
+/* Objects of the running scene, for its step function */
+static lv_obj_t *scene_obj[8];
+static int32_t scene_range;
+
+static void scene_anim(lv_obj_t *scr, app_ui_anim_t anim)
+{
+    const app_ui_cfg_t cfg = {
+        .anim = anim,
+        .gif = &img_bulb_gif0,
+        .gif_cfg = {
+            .budget_bytes = 512 * 1024,
+        },
+    };
+    app_ui_create(scr, &cfg);
+}
+
+/* The firmware's first screen */
+static void scene_a565(lv_obj_t *scr)
+{
+    scene_anim(scr, APP_UI_ANIM_A565);
+}
+
+static void scene_gif(lv_obj_t *scr)
+{
+    scene_anim(scr, APP_UI_ANIM_GIF_CACHE);
+}
+
+/* The A565 animation over a C565 background, drawn from the compressed rows it overlaps */
+static void scene_c565(lv_obj_t *scr)
+{
+    lv_obj_t *bg = lv_image_create(scr);
+
+    lv_image_set_src(bg, &bg_bulb);
+    lv_obj_center(bg);
+    scene_anim(scr, APP_UI_ANIM_A565);
+}
+
+static void scene_list(lv_obj_t *scr)
+{
+    lv_obj_t *list = lv_list_create(scr);
+
+    lv_obj_set_size(list, LV_PCT(100), LV_PCT(100));
+    for (int i = 0; i < 24; i++) {
+        char text[16];
+        snprintf(text, sizeof(text), "Item %d", i);
+        lv_list_add_button(list, i % 2 ? LV_SYMBOL_FILE : LV_SYMBOL_DIRECTORY, text);
+    }
+    lv_obj_update_layout(list);
+    scene_obj[0] = list;
+    scene_range = lv_obj_get_scroll_bottom(list);
+}
+
+/* Down and back up, 4 px per frame */
+static void scene_list_step(uint32_t frame)
+{
+    const int32_t pos = (int32_t)(frame * 4) % LV_MAX(2 * scene_range, 1);
+
+    lv_obj_scroll_to_y(scene_obj[0], pos <= scene_range ? pos : 2 * scene_range - pos, LV_ANIM_OFF);
+}
+
+/* scene_bench.c's cards over a gradient screen */
+static void scene_gradients(lv_obj_t *scr)
+{
+    lv_obj_set_style_bg_color(scr, lv_palette_main(LV_PALETTE_BLUE_GREY), 0);
+    lv_obj_set_style_bg_grad_color(scr, lv_palette_darken(LV_PALETTE_INDIGO, 4), 0);
+    lv_obj_set_style_bg_grad_dir(scr, LV_GRAD_DIR_HOR, 0);
+    scene_bench_build_cards(scr, scene_obj);
+}
+
+/* The gradient stops sweep through the cards */
+static void scene_gradients_step(uint32_t frame)
+{
+    for (int i = 0; i < 6; i++) {
+        const int32_t stop = (int32_t)(frame * 8 + i * 40) % 256;
+
+        lv_obj_set_style_bg_main_stop(scene_obj[i], stop / 2, 0);
+        lv_obj_set_style_bg_grad_stop(scene_obj[i], 128 + stop / 2, 0);
+    }
+}
+
+static void scene_text(lv_obj_t *scr)
+{
+    scene_bench_build_text(scr, 3);
+    scene_obj[0] = lv_label_create(scr);
+    lv_obj_set_pos(scene_obj[0], 5, 125);
+}
+
+/* A readout rewritten every frame, as a status line would be */
+static void scene_text_step(uint32_t frame)
+{
+    lv_label_set_text_fmt(scene_obj[0], "Frame %"PRIu32"  %"PRIu32".%02"PRIu32" V", frame, 3 + frame % 2,
+                          frame * 7 % 100);
+}
+
+static void scene_arcs(lv_obj_t *scr)
+{
+    for (int i = 0; i < 3; i++) {
+        lv_obj_t *arc = lv_arc_create(scr);
+
+        lv_obj_set_size(arc, 150 - i * 34, 150 - i * 34);
+        lv_obj_center(arc);
+        lv_obj_remove_style(arc, NULL, LV_PART_KNOB);
+        lv_obj_set_style_arc_width(arc, 10, LV_PART_MAIN);
+        lv_obj_set_style_arc_width(arc, 10, LV_PART_INDICATOR);
+        lv_obj_set_style_arc_rounded(arc, true, LV_PART_INDICATOR);
+        scene_obj[i] = arc;
+    }
+
+    /* Meter in the middle */
+    lv_obj_t *scale = lv_scale_create(scr);
+    lv_obj_set_size(scale, 60, 60);
+    lv_obj_center(scale);
+    lv_scale_set_mode(scale, LV_SCALE_MODE_ROUND_INNER);
+    lv_scale_set_range(scale, 0, 100);
+    lv_scale_set_total_tick_count(scale, 11);
+    lv_scale_set_major_tick_every(scale, 5);
+    lv_scale_set_label_show(scale, false);
+    lv_scale_set_angle_range(scale, 270);
+    lv_scale_set_rotation(scale, 135);
+    scene_obj[3] = scale;
+    scene_obj[4] = lv_line_create(scale);
+    lv_obj_set_style_line_width(scene_obj[4], 3, 0);
+    lv_obj_set_style_line_rounded(scene_obj[4], true, 0);
+}
+
+static void scene_arcs_step(uint32_t frame)
+{
+    for (int i = 0; i < 3; i++) {
+        lv_arc_set_value(scene_obj[i], (int32_t)(frame * (i + 2) + i * 30) % 101);
+    }
+    lv_scale_set_line_needle_value(scene_obj[3], scene_obj[4], 24, (int32_t)(frame * 3) % 101);
+}
+
+static const ui_bench_scene_t scenes[] = {
+    { "a565", scene_a565, NULL },
+    { "gif", scene_gif, NULL },
+    { "c565", scene_c565, NULL },
+    { "list", scene_list, scene_list_step },
+    { "gradients", scene_gradients, scene_gradients_step },
+    { "text", scene_text, scene_text_step },
+    { "arcs", scene_arcs, scene_arcs_step },
+};
+
+#define UI_BENCH_SCENES (sizeof(scenes) / sizeof(scenes[0]))
+
+static int64_t ui_bench_cpu_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void ui_bench_run_scene(const ui_bench_scene_t *scene, ui_bench_result_t *res)
+{
+    lv_obj_t *prev = lv_screen_active();
+    lv_obj_t *scr = lv_obj_create(NULL);
+    lcd_sim_stats_t st0, st1;
+    host_disp_stats_t ds0, ds1;
+    lv_mem_prof_totals_t heap;
+
+    /* The previous scene is gone before this one allocates anything */
+    lv_screen_load(scr);
+    lv_obj_delete(prev);
+    memset(scene_obj, 0, sizeof(scene_obj));
+    lv_mem_prof_reset_peak();
+    lcd_sim_get_stats(&st0);
+    host_disp_get_stats(&ds0);
+
+    scene->build(scr);
+    const int64_t start_us = lcd_sim_now_us();
+    for (uint32_t i = 0; i < bench.frames; i++) {
+        lcd_sim_advance(start_us + (int64_t)i * bench.frame_ms * 1000);
+        if (scene->step) {
+            scene->step(i);
+        }
+        /* Every invalidated area is rendered now rather than on the refresh timer */
+        const int64_t t0 = ui_bench_cpu_ns();
+        lv_timer_handler();
+        lv_refr_now(NULL);
+        res->render_ns += ui_bench_cpu_ns() - t0;
+        host_disp_drain();
+        res->crc[i] = lcd_sim_crc32();
+    }
+
+    lcd_sim_get_stats(&st1);
+    host_disp_get_stats(&ds1);
+    lv_mem_prof_get_totals(&heap);
+    res->rendered = ds1.frames - ds0.frames;
+    res->wire_bytes = st1.px_bytes + st1.cmd_bytes - st0.px_bytes - st0.cmd_bytes;
+    res->trans = st1.trans - st0.trans;
+    res->busy_ns = st1.busy_ns - st0.busy_ns;
+    res->peak_heap = heap.peak_bytes;
+}
+
+/* Golden line of a scene: "<name> <frames> <crc>..." */
+static const char *ui_bench_golden_line(const char *name)
+{
+    const size_t len = strlen(name);
+
+    for (const char *line = bench.golden; line && *line; line = strchr(line, '\n'), line = line ? line + 1 : NULL) {
+        if (strncmp(line, name, len) == 0 && line[len] == ' ') {
+            return line + len + 1;
+        }
+    }
+    return NULL;
+}
+
+static void ui_bench_check(const ui_bench_scene_t *scene, ui_bench_result_t *res)
+{
+    const char *line = ui_bench_golden_line(scene->name);
+    char *end;
+
+    res->first_mismatch = -1;
+    if (!bench.golden_path || bench.update_golden) {
+        res->golden = UI_BENCH_GOLDEN_NONE;
+        return;
+    }
+    if (!line || strtoul(line, &end, 10) != bench.frames) {
+        res->golden = UI_BENCH_GOLDEN_MISSING;
+        return;
+    }
+    res->golden = UI_BENCH_GOLDEN_PASS;
+    for (uint32_t i = 0; i < bench.frames; i++) {
+        const uint32_t crc = strtoul(end, &end, 16);
+        if (crc != res->crc[i]) {
+            res->golden = UI_BENCH_GOLDEN_FAIL;
+            res->first_mismatch = i;
+            return;
+        }
+    }
+}
+
+static char *ui_bench_read_file(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    char *buf = NULL;
+    size_t len = 0;
+
+    if (!f) {
+        return NULL;
+    }
+    for (size_t n = 1; n;) {
+        char *p = realloc(buf, len + UI_BENCH_GOLDEN_LINE + 1);
+        if (!p) {
+            break;
+        }
+        buf = p;
+        n = fread(buf + len, 1, UI_BENCH_GOLDEN_LINE, f);
+        len += n;
+        buf[len] = '\0';
+    }
+    fclose(f);
+    return buf;
+}
+
+static esp_err_t ui_bench_write_golden(const ui_bench_result_t *res)
+{
+    FILE *f = fopen(bench.golden_path, "w");
+
+    ESP_RETURN_ON_FALSE(f, ESP_FAIL, TAG, "Open %s failed", bench.golden_path);
+    fprintf(f, "# ui_bench frame CRCs, LVGL %d.%d.%d, %s refresh: scene frames crc...\n", LVGL_VERSION_MAJOR,
+            LVGL_VERSION_MINOR, LVGL_VERSION_PATCH, bench.disp_cfg.partial ? "partial" : "full");
+    for (size_t s = 0; s < UI_BENCH_SCENES; s++) {
+        if (!res[s].crc) {
+            continue;
+        }
+        fprintf(f, "%s %"PRIu32, scenes[s].name, bench.frames);
+        for (uint32_t i = 0; i < bench.frames; i++) {
+            fprintf(f, " %08"PRIx32, res[s].crc[i]);
+        }
+        fprintf(f, "\n");
+    }
+    return fclose(f) == 0 ? ESP_OK : ESP_FAIL;
+}
+
+static void ui_bench_write_json(FILE *f, const ui_bench_result_t *res, uint32_t failures)
+{
+    static const char *golden_names[] = { "none", "missing", "pass", "fail" };
+
+    fprintf(f, "{\n  \"bench\": \"ui_bench\",\n  \"lvgl\": \"%d.%d.%d\",\n", LVGL_VERSION_MAJOR, LVGL_VERSION_MINOR,
+            LVGL_VERSION_PATCH);
+    fprintf(f, "  \"width\": %d,\n  \"height\": %d,\n  \"refresh\": \"%s\",\n  \"rows\": %"PRIu32",\n",
+            HOST_DISP_H_RES, HOST_DISP_V_RES, bench.disp_cfg.partial ? "partial" : "full", bench.disp_cfg.rows);
+    fprintf(f, "  \"pclk_hz\": %"PRIu32",\n  \"frame_ms\": %"PRIu32",\n  \"frames\": %"PRIu32",\n",
+            bench.disp_cfg.pclk_hz, bench.frame_ms, bench.frames);
+    fprintf(f, "  \"golden_failures\": %"PRIu32",\n  \"scenes\": [", failures);
+
+    bool first = true;
+    for (size_t s = 0; s < UI_BENCH_SCENES; s++) {
+        const ui_bench_result_t *r = &res[s];
+        const double rendered = r->rendered ? r->rendered : 1;
+
+        if (!r->crc) {
+            continue;
+        }
+        fprintf(f, "%s\n    {\n      \"name\": \"%s\",\n      \"rendered\": %"PRIu32",\n", first ? "" : ",",
+                scenes[s].name, r->rendered);
+        fprintf(f, "      \"render_ms_per_frame\": %.4f,\n", r->render_ns / 1e6 / rendered);
+        fprintf(f, "      \"flush_bytes_per_frame\": %.1f,\n", r->wire_bytes / rendered);
+        fprintf(f, "      \"transactions_per_frame\": %.2f,\n", r->trans / rendered);
+        fprintf(f, "      \"bus_ms_per_frame\": %.4f,\n", r->busy_ns / 1e6 / rendered);
+        fprintf(f, "      \"peak_heap_bytes\": %"PRIu32",\n", r->peak_heap);
+        fprintf(f, "      \"golden\": \"%s\",\n      \"first_mismatch\": %"PRId32",\n", golden_names[r->golden],
+                r->first_mismatch);
+        fprintf(f, "      \"crc\": [");
+        for (uint32_t i = 0; i < bench.frames; i++) {
+            fprintf(f, "%s\"%08"PRIx32"\"", i ? ", " : "", r->crc[i]);
+        }
+        fprintf(f, "]\n    }");
+        first = false;
+    }
+    fprintf(f, "\n  ]\n}\n");
+}
+
+static void ui_bench_usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --frames N        frames per scene (60)\n"
+            "  --frame-ms MS     virtual time between frames (%d)\n"
+            "  --scene NAME      run only this scene\n"
+            "  --partial         partial refresh instead of full refresh\n"
+            "  --rows N          draw buffer rows (160)\n"
+            "  --pclk HZ         SPI clock (80000000)\n"
+            "  --json FILE       write the results as JSON, - for stdout\n"
+            "  --golden FILE     compare the frame CRCs with FILE\n"
+            "  --update-golden   write the frame CRCs to the golden file instead\n", prog, LV_DEF_REFR_PERIOD);
+    exit(2);
+}
+
+static void ui_bench_parse(int argc, char **argv)
+{
+    static const struct option opts[] = {
+        { "frames", required_argument, NULL, 'n' },
+        { "frame-ms", required_argument, NULL, 'f' },
+        { "scene", required_argument, NULL, 's' },
+        { "partial", no_argument, NULL, 'P' },
+        { "rows", required_argument, NULL, 'r' },
+        { "pclk", required_argument, NULL, 'p' },
+        { "json", required_argument, NULL, 'j' },
+        { "golden", required_argument, NULL, 'g' },
+        { "update-golden", no_argument, NULL, 'u' },
+        { NULL, 0, NULL, 0 },
+    };
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "", opts, NULL)) != -1) {
+        switch (opt) {
+        case 'n': bench.frames = strtoul(optarg, NULL, 0); break;
+        case 'f': bench.frame_ms = strtoul(optarg, NULL, 0); break;
+        case 's': bench.only = optarg; break;
+        case 'P': bench.disp_cfg.partial = true; break;
+        case 'r': bench.disp_cfg.rows = strtoul(optarg, NULL, 0); break;
+        case 'p': bench.disp_cfg.pclk_hz = strtoul(optarg, NULL, 0); break;
+        case 'j': bench.json_path = optarg; break;
+        case 'g': bench.golden_path = optarg; break;
+        case 'u': bench.update_golden = true; break;
+        default: ui_bench_usage(argv[0]);
+        }
+    }
+    if (optind != argc || !bench.frames || !bench.frame_ms || (bench.update_golden && !bench.golden_path)) {
+        ui_bench_usage(argv[0]);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    static ui_bench_result_t res[UI_BENCH_SCENES];
+    uint32_t failures = 0;
+    lv_display_t *disp;
+
+    ui_bench_parse(argc, argv);
+    /* The table goes to stderr when the JSON goes to stdout */
+    FILE *out = bench.json_path && strcmp(bench.json_path, "-") == 0 ? stderr : stdout;
+    if (bench.golden_path && !bench.update_golden) {
+        bench.golden = ui_bench_read_file(bench.golden_path);
+        if (!bench.golden) {
+            ESP_LOGE(TAG, "No golden file %s, write it with --update-golden", bench.golden_path);
+            return 1;
+        }
+    }
+
+    if (lv_mem_prof_start(UI_BENCH_PROF_BLOCKS) != LV_RESULT_OK) {
+        ESP_LOGE(TAG, "Heap profiler start failed");
+        return 1;
+    }
+    lv_init();
+    ESP_ERROR_CHECK(img_c565_init());
+    ESP_ERROR_CHECK(host_disp_init(&bench.disp_cfg, &disp));
+
+    fprintf(out, "%-10s %8s %10s %10s %9s %9s  %s\n", "scene", "rendered", "render ms", "flush B", "bus ms", "heap B",
+           "golden");
+    for (size_t s = 0; s < UI_BENCH_SCENES; s++) {
+        ui_bench_result_t *r = &res[s];
+
+        if (bench.only && strcmp(bench.only, scenes[s].name) != 0) {
+            continue;
+        }
+        r->crc = calloc(bench.frames, sizeof(uint32_t));
+        ESP_RETURN_ON_FALSE(r->crc, 1, TAG, "No memory for the CRCs");
+        ui_bench_run_scene(&scenes[s], r);
+        ui_bench_check(&scenes[s], r);
+        failures += r->golden == UI_BENCH_GOLDEN_FAIL || r->golden == UI_BENCH_GOLDEN_MISSING;
+
+        const double rendered = r->rendered ? r->rendered : 1;
+        fprintf(out, "%-10s %8"PRIu32" %10.3f %10.0f %9.3f %9"PRIu32"  %s", scenes[s].name, r->rendered,
+               r->render_ns / 1e6 / rendered, r->wire_bytes / rendered, r->busy_ns / 1e6 / rendered, r->peak_heap,
+               r->golden == UI_BENCH_GOLDEN_PASS ? "pass" : r->golden == UI_BENCH_GOLDEN_FAIL ? "FAIL" :
+               r->golden == UI_BENCH_GOLDEN_MISSING ? "MISSING" : "-");
+        if (r->golden == UI_BENCH_GOLDEN_FAIL) {
+            fprintf(out, " at frame %"PRId32, r->first_mismatch);
+        }
+        fprintf(out, "\n");
+    }
+
+    if (bench.update_golden && ui_bench_write_golden(res) != ESP_OK) {
+        return 1;
+    }
+    if (bench.json_path) {
+        FILE *f = strcmp(bench.json_path, "-") == 0 ? stdout : fopen(bench.json_path, "w");
+        ESP_RETURN_ON_FALSE(f, 1, TAG, "Open %s failed", bench.json_path);
+        ui_bench_write_json(f, res, failures);
+        if (f != stdout) {
+            fclose(f);
+        }
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,119 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "anim565.h"
+
+typedef struct {
+    const uint8_t *stream;      /* Whole A565 stream */
+    const uint8_t *next;        /* Header of the frame to show next */
+    const anim565_header_t *header;
+    uint32_t frame_idx;         /* Index of the frame to show next */
+    lv_image_dsc_t dsc;         /* Frame buffer shown by the image */
+    lv_timer_t *timer;
+} anim565_t;
+
+static const char *TAG = "anim565";
+
+static const anim565_frame_t *anim565_apply_frame(anim565_t *anim)
+{
+    const anim565_header_t *header = anim->header;
+    const anim565_frame_t *frame = (const anim565_frame_t *)anim->next;
+    const uint8_t *px = anim->next + sizeof(anim565_frame_t);
+    const uint32_t rect_px = frame->w * frame->h;
+    uint8_t *rgb = (uint8_t *)anim->dsc.data;
+
+    for (uint32_t row = 0; row < frame->h; row++) {
+        memcpy(rgb + ((frame->y + row) * header->w + frame->x) * 2, px + row * frame->w * 2, frame->w * 2);
+    }
+    uint32_t size = rect_px * 2;
+    if (header->flags & ANIM565_FLAG_HAS_ALPHA) {
+        uint8_t *alpha = rgb + header->w * header->h * 2;
+        for (uint32_t row = 0; row < frame->h; row++) {
+            memcpy(alpha + (frame->y + row) * header->w + frame->x, px + size + row * frame->w, frame->w);
+        }
+        size += rect_px;
+    }
+
+    /* Advance, the first frame is a full key frame so the loop restarts cleanly */
+    if (++anim->frame_idx == header->frame_cnt) {
+        anim->frame_idx = 0;
+        anim->next = anim->stream + sizeof(anim565_header_t);
+    } else {
+        anim->next = px + ((size + 3) & ~3U);
+    }
+    return frame;
+}
+
+static void anim565_timer_cb(lv_timer_t *timer)
+{
+    lv_obj_t *img = lv_timer_get_user_data(timer);
+    anim565_t *anim = lv_obj_get_user_data(img);
+
+    const anim565_frame_t *frame = anim565_apply_frame(anim);
+    if (frame->w && frame->h) {
+        /* Only the changed rectangle is redrawn and, with partial refresh, flushed */
+        lv_area_t area;
+        lv_obj_get_coords(img, &area);
+        lv_area_set(&area, area.x1 + frame->x, area.y1 + frame->y,
+                    area.x1 + frame->x + frame->w - 1, area.y1 + frame->y + frame->h - 1);
+        lv_image_cache_drop(&anim->dsc);
+        lv_obj_invalidate_area(img, &area);
+    }
+    lv_timer_set_period(timer, LV_MAX(frame->delay_ms, 10));
+}
+
+static void anim565_delete_cb(lv_event_t *e)
+{
+    anim565_t *anim = lv_event_get_user_data(e);
+
+    lv_timer_delete(anim->timer);
+    free((void *)anim->dsc.data);
+    free(anim);
+}
+
+lv_obj_t *anim565_create(lv_obj_t *parent, const lv_image_dsc_t *src)
+{
+    const anim565_header_t *header = (const anim565_header_t *)src->data;
+
+    if (src->data_size < sizeof(anim565_header_t) || memcmp(header->magic, "A565", 4) != 0 ||
+            header->version != ANIM565_VERSION || header->frame_cnt == 0) {
+        ESP_LOGE(TAG, "Not an A565 v%d stream", ANIM565_VERSION);
+        return NULL;
+    }
+
+    const bool has_alpha = header->flags & ANIM565_FLAG_HAS_ALPHA;
+    const uint32_t size = header->w * header->h * (has_alpha ? 3 : 2);
+    anim565_t *anim = calloc(1, sizeof(anim565_t));
+    uint8_t *buf = malloc(size);
+    if (!anim || !buf) {
+        ESP_LOGE(TAG, "Not enough memory for a %ux%u frame buffer", header->w, header->h);
+        free(anim);
+        free(buf);
+        return NULL;
+    }
+
+    anim->stream = src->data;
+    anim->header = header;
+    anim->next = anim->stream + sizeof(anim565_header_t);
+    anim->dsc.header.magic = LV_IMAGE_HEADER_MAGIC;
+    anim->dsc.header.cf = has_alpha ? LV_COLOR_FORMAT_RGB565A8 : LV_COLOR_FORMAT_RGB565;
+    anim->dsc.header.w = header->w;
+    anim->dsc.header.h = header->h;
+    anim->dsc.header.stride = header->w * 2;
+    anim->dsc.data_size = size;
+    anim->dsc.data = buf;
+
+    /* Show the key frame right away */
+    const anim565_frame_t *frame = anim565_apply_frame(anim);
+
+    lv_obj_t *img = lv_image_create(parent);
+    lv_obj_set_user_data(img, anim);
+    lv_image_set_src(img, &anim->dsc);
+    lv_obj_add_event_cb(img, anim565_delete_cb, LV_EVENT_DELETE, anim);
+    anim->timer = lv_timer_create(anim565_timer_cb, LV_MAX(frame->delay_ms, 10), img);
+    return img;
+}
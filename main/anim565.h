@@ -0,0 +1,55 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ANIM565_VERSION         (1)
+#define ANIM565_FLAG_HAS_ALPHA  (0x01)
+
+/**
+ * @brief A565 stream header, see tools/anim_conv.py for the layout
+ */
+typedef struct __attribute__((packed)) {
+    char magic[4];              /* "A565" */
+    uint8_t version;
+    uint8_t flags;
+    uint16_t w;
+    uint16_t h;
+    uint16_t frame_cnt;
+} anim565_header_t;
+
+/**
+ * @brief A565 frame header, followed by w * h RGB565 pixels (and w * h alpha bytes), padded to 4 bytes
+ */
+typedef struct __attribute__((packed)) {
+    uint16_t delay_ms;
+    uint16_t x;                 /* Changed rectangle, 0x0 when the frame repeats the previous one */
+    uint16_t y;
+    uint16_t w;
+    uint16_t h;
+    uint16_t reserved;
+} anim565_frame_t;
+
+/**
+ * @brief Create an image playing an A565 animation converted at build time
+ *
+ * The frames are pre-quantized to RGB565 and stored as changed rectangles, playback only copies
+ * those rectangles into one RGB565 (or RGB565A8) frame buffer: no LZW and no palette lookup.
+ *
+ * @param parent Parent object
+ * @param src    Descriptor generated by tools/anim_conv.py (`LV_COLOR_FORMAT_RAW`, data is the A565 stream)
+ * @return The created object, NULL on error
+ */
+lv_obj_t *anim565_create(lv_obj_t *parent, const lv_image_dsc_t *src);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,36 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "esp_log.h"
+#include "lv_examples.h"
+#include "app_ui.h"
+#include "anim565.h"
+#include "anim_bulb.h"
+
+static const char *TAG = "app_ui";
+
+lv_obj_t *app_ui_create(lv_obj_t *scr, const app_ui_cfg_t *cfg)
+{
+    lv_obj_t *obj = NULL;
+
+    switch (cfg->anim) {
+    case APP_UI_ANIM_A565:
+        obj = anim565_create(scr, &anim_bulb);
+        break;
+    case APP_UI_ANIM_GIF_CACHE:
+        obj = gif_cache_create(scr, cfg->gif, &cfg->gif_cfg);
+        break;
+    case APP_UI_ANIM_GIF:
+        /* The example builds on lv_screen_active() and keeps the object to itself */
+        lv_example_gif_1();
+        return lv_obj_get_child(lv_screen_active(), -1);
+    }
+
+    if (!obj) {
+        ESP_LOGE(TAG, "Create animation failed");
+        return NULL;
+    }
+    lv_obj_center(obj);
+    return obj;
+}
@@ -0,0 +1,47 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "lvgl.h"
+#include "gif_cache.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Animation shown on the first screen
+ */
+typedef enum {
+    APP_UI_ANIM_A565,           /* RGB565 difference frames converted at build time (anim565.h) */
+    APP_UI_ANIM_GIF_CACHE,      /* GIF pre-decoded into PSRAM (gif_cache.h) */
+    APP_UI_ANIM_GIF,            /* LVGL's GIF example, decoded while it plays */
+} app_ui_anim_t;
+
+/**
+ * @brief First screen configuration
+ */
+typedef struct {
+    app_ui_anim_t anim;
+    const lv_image_dsc_t *gif;  /* GIF of APP_UI_ANIM_GIF_CACHE */
+    gif_cache_cfg_t gif_cfg;
+} app_ui_cfg_t;
+
+/**
+ * @brief Build the first screen
+ *
+ * Shared by the firmware and the host build (host/), so both render the same UI.
+ * APP_UI_ANIM_GIF always draws on the default display's active screen, set the default
+ * display before calling it for another one. Must be called with the LVGL lock held.
+ *
+ * @param scr Screen to build on
+ * @param cfg Configuration
+ * @return The animation object, NULL on error
+ */
+lv_obj_t *app_ui_create(lv_obj_t *scr, const app_ui_cfg_t *cfg);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,160 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_timer.h"
+#include "boot_graph.h"
+
+#define BOOT_GRAPH_STACK        (4096)
+#define BOOT_GRAPH_FAIL_SHIFT   (BOOT_GRAPH_MAX_STEPS)  /* Done bits first, failed bits above them */
+
+typedef struct {
+    const boot_graph_step_t *step;
+    int idx;
+    int core;
+    int64_t start_us;
+    int64_t end_us;
+    esp_err_t err;
+} boot_graph_task_t;
+
+static const char *TAG = "boot_graph";
+
+/* Boot runs once, nothing is deleted so a late finishing task never touches freed memory */
+static StaticEventGroup_t boot_events_buf;
+static EventGroupHandle_t boot_events;
+static boot_graph_task_t boot_tasks[BOOT_GRAPH_MAX_STEPS];
+
+static void boot_graph_exec(boot_graph_task_t *t, EventBits_t failed)
+{
+    t->core = xPortGetCoreID();
+    t->start_us = esp_timer_get_time();
+    if ((failed >> BOOT_GRAPH_FAIL_SHIFT) & t->step->deps) {
+        t->err = ESP_ERR_INVALID_STATE;     /* Skipped, a dependency failed */
+    } else {
+        t->err = t->step->fn();
+    }
+    t->end_us = esp_timer_get_time();
+    if (t->err != ESP_OK) {
+        ESP_LOGE(TAG, "%s failed: %s", t->step->name, esp_err_to_name(t->err));
+    }
+}
+
+static void boot_graph_task(void *arg)
+{
+    boot_graph_task_t *t = arg;
+
+    if (t->step->deps) {
+        xEventGroupWaitBits(boot_events, t->step->deps, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+    boot_graph_exec(t, xEventGroupGetBits(boot_events));
+
+    EventBits_t bits = BOOT_GRAPH_DEP(t->idx);
+    if (t->err != ESP_OK) {
+        bits |= BOOT_GRAPH_DEP(t->idx) << BOOT_GRAPH_FAIL_SHIFT;
+    }
+    xEventGroupSetBits(boot_events, bits);
+    vTaskDelete(NULL);
+}
+
+static void boot_graph_report(int step_cnt, bool serial, int64_t t0_us, int64_t end_us)
+{
+    int64_t busy_us = 0;
+    int last = 0;
+
+    ESP_LOGI(TAG, "step       core  start us    end us   took us");
+    for (int i = 0; i < step_cnt; i++) {
+        const boot_graph_task_t *t = &boot_tasks[i];
+        const int64_t took_us = t->end_us - t->start_us;
+
+        ESP_LOGI(TAG, "%-10s %4d %9"PRId64" %9"PRId64" %9"PRId64"%s", t->step->name, t->core, t->start_us - t0_us,
+                 t->end_us - t0_us, took_us, t->err == ESP_OK ? "" : "  failed");
+        busy_us += took_us;
+        if (t->end_us > boot_tasks[last].end_us) {
+            last = i;
+        }
+    }
+
+    /* Walk back from the step finishing last through the dependency finishing last, run serially
+     * every step also waits for the one before it */
+    char path[BOOT_GRAPH_MAX_STEPS * 12] = "";
+    int len = 0;
+    int chain[BOOT_GRAPH_MAX_STEPS];
+    int chain_len = 0;
+    for (int i = last; i >= 0;) {
+        chain[chain_len++] = i;
+        const uint32_t deps = boot_tasks[i].step->deps | (serial && i ? BOOT_GRAPH_DEP(i - 1) : 0);
+        int prev = -1;
+        for (int d = 0; d < i; d++) {
+            if ((deps & BOOT_GRAPH_DEP(d)) && (prev < 0 || boot_tasks[d].end_us > boot_tasks[prev].end_us)) {
+                prev = d;
+            }
+        }
+        i = prev;
+    }
+    for (int i = chain_len - 1; i >= 0 && len < sizeof(path); i--) {
+        len += snprintf(path + len, sizeof(path) - len, "%s%s", boot_tasks[chain[i]].step->name, i ? " > " : "");
+    }
+
+    ESP_LOGI(TAG, "critical path %s, done after %"PRId64" us, steps took %"PRId64" us together",
+             path, end_us - t0_us, busy_us);
+}
+
+esp_err_t boot_graph_run(const boot_graph_step_t *steps, int step_cnt, bool serial)
+{
+    ESP_RETURN_ON_FALSE(steps && step_cnt > 0 && step_cnt <= BOOT_GRAPH_MAX_STEPS, ESP_ERR_INVALID_ARG, TAG, "invalid step table");
+    for (int i = 0; i < step_cnt; i++) {
+        ESP_RETURN_ON_FALSE(steps[i].fn, ESP_ERR_INVALID_ARG, TAG, "%s has no function", steps[i].name);
+        ESP_RETURN_ON_FALSE((steps[i].deps & ~(BOOT_GRAPH_DEP(i) - 1)) == 0, ESP_ERR_INVALID_ARG, TAG,
+                            "%s depends on a later step", steps[i].name);
+        boot_tasks[i] = (boot_graph_task_t) {
+            .step = &steps[i],
+            .idx = i,
+        };
+    }
+
+    const int64_t t0_us = esp_timer_get_time();
+    if (serial) {
+        EventBits_t failed = 0;
+        for (int i = 0; i < step_cnt; i++) {
+            boot_graph_exec(&boot_tasks[i], failed);
+            if (boot_tasks[i].err != ESP_OK) {
+                failed |= BOOT_GRAPH_DEP(i) << BOOT_GRAPH_FAIL_SHIFT;
+            }
+        }
+    } else {
+        if (!boot_events) {
+            boot_events = xEventGroupCreateStatic(&boot_events_buf);
+        }
+        xEventGroupClearBits(boot_events, (BOOT_GRAPH_DEP(BOOT_GRAPH_FAIL_SHIFT * 2) - 1));
+
+        const UBaseType_t prio = uxTaskPriorityGet(NULL);
+        for (int i = 0; i < step_cnt; i++) {
+            const BaseType_t core = steps[i].core < 0 ? tskNO_AFFINITY : steps[i].core;
+            const uint32_t stack = steps[i].stack ? steps[i].stack : BOOT_GRAPH_STACK;
+            if (xTaskCreatePinnedToCore(boot_graph_task, steps[i].name, stack, &boot_tasks[i], prio, NULL, core) != pdPASS) {
+                /* Count it as failed so the join and the steps depending on it still finish */
+                boot_tasks[i].err = ESP_ERR_NO_MEM;
+                boot_tasks[i].start_us = boot_tasks[i].end_us = esp_timer_get_time();
+                boot_tasks[i].core = -1;
+                xEventGroupSetBits(boot_events, BOOT_GRAPH_DEP(i) | (BOOT_GRAPH_DEP(i) << BOOT_GRAPH_FAIL_SHIFT));
+            }
+        }
+        /* Join */
+        xEventGroupWaitBits(boot_events, BOOT_GRAPH_DEP(step_cnt) - 1, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+    boot_graph_report(step_cnt, serial, t0_us, esp_timer_get_time());
+
+    for (int i = 0; i < step_cnt; i++) {
+        if (boot_tasks[i].err != ESP_OK) {
+            return boot_tasks[i].err;
+        }
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,49 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BOOT_GRAPH_MAX_STEPS    (12)
+#define BOOT_GRAPH_DEP(idx)     (1UL << (idx))
+
+/**
+ * @brief One initialization step
+ *
+ * A step only depends on steps listed before it in the table, which also keeps the graph acyclic.
+ */
+typedef struct {
+    const char *name;           /* Also the task name */
+    esp_err_t (*fn)(void);
+    uint32_t deps;              /* BOOT_GRAPH_DEP() of the steps that have to finish first */
+    int core;                   /* Core to run on, -1 for either */
+    uint32_t stack;             /* Task stack size, 0 for the default */
+} boot_graph_step_t;
+
+/**
+ * @brief Run initialization steps in dependency order and wait for all of them
+ *
+ * Every step gets its own task, pinned to its core and started at the caller's priority. It
+ * waits for its dependencies, so independent steps overlap on both cores. A failed step
+ * fails every step depending on it without running them, the others still run. The call
+ * returns once all steps are finished and logs each step's core and start / end time, the
+ * critical path and the summed step time, which is what a serial boot would take.
+ *
+ * @param steps    Step table
+ * @param step_cnt Number of steps, at most BOOT_GRAPH_MAX_STEPS
+ * @param serial   Run the steps one by one in the calling task instead, as a timing baseline
+ * @return ESP_OK when all steps succeeded, otherwise the error of the first failed step
+ */
+esp_err_t boot_graph_run(const boot_graph_step_t *steps, int step_cnt, bool serial);
+
+#ifdef __cplusplus
+}
+#endif
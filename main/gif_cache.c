@@ -0,0 +1,328 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "gif_cache.h"
+#include "src/libs/gif/gifdec.h"
+
+typedef struct {
+    const uint8_t *data;        /* RGB565A8 pixels */
+    lv_area_t dirty;            /* Pixels changed since the previous frame, relative to the image */
+    uint32_t delay_ms;
+} gif_cache_frame_t;
+
+/* One decoded GIF, shared by every image showing the same GIF bytes */
+typedef struct gif_asset_t {
+    const void *data;           /* Registry key */
+    lv_obj_t **imgs;            /* Images showing the asset */
+    uint32_t img_cnt;
+    lv_timer_t *timer;          /* Advances all images at once */
+    lv_image_dsc_t dsc;         /* Shown by all images, only its data changes between frames */
+    /* Pre-decoded frames */
+    gif_cache_frame_t *frames;
+    uint8_t *pixels;            /* All frames, one PSRAM block */
+    uint32_t frame_cnt;
+    uint32_t cur;
+    /* On-the-fly decoding, used when the frames do not fit */
+    gd_GIF *gif;
+    lv_area_t prev_rect;        /* Rectangle of the previous GIF frame, it may be disposed */
+    struct gif_asset_t *next;
+} gif_asset_t;
+
+static const char *TAG = "gif_cache";
+
+static gif_asset_t *gif_assets = NULL;
+
+/* Invalidate only the changed rectangle of every image showing the asset */
+static void gif_cache_invalidate(gif_asset_t *asset, const lv_area_t *dirty)
+{
+    if (lv_area_get_width(dirty) <= 0 || lv_area_get_height(dirty) <= 0) {
+        return;
+    }
+    lv_image_cache_drop(&asset->dsc);
+    for (uint32_t i = 0; i < asset->img_cnt; i++) {
+        lv_area_t coords;
+        lv_area_t area = *dirty;
+
+        lv_obj_get_coords(asset->imgs[i], &coords);
+        lv_area_move(&area, coords.x1, coords.y1);
+        lv_obj_invalidate_area(asset->imgs[i], &area);
+    }
+}
+
+static void gif_cache_timer_cb(lv_timer_t *timer)
+{
+    gif_asset_t *asset = lv_timer_get_user_data(timer);
+
+    if (asset->frames) {
+        asset->cur = (asset->cur + 1) % asset->frame_cnt;
+        asset->dsc.data = asset->frames[asset->cur].data;
+        gif_cache_invalidate(asset, &asset->frames[asset->cur].dirty);
+        lv_timer_set_period(timer, asset->frames[asset->cur].delay_ms);
+        return;
+    }
+
+    /* Decode once per tick, however many images show the asset */
+    gd_GIF *gif = asset->gif;
+    if (gd_get_frame(gif) != 1) {
+        gd_rewind(gif);
+        if (gd_get_frame(gif) != 1) {
+            return;
+        }
+    }
+    gd_render_frame(gif, (uint8_t *)asset->dsc.data);
+
+    /* The new frame's rectangle plus the previous one, which the disposal may have cleared */
+    lv_area_t rect = { gif->fx, gif->fy, gif->fx + gif->fw - 1, gif->fy + gif->fh - 1 };
+    lv_area_t dirty;
+    lv_area_join(&dirty, &rect, &asset->prev_rect);
+    asset->prev_rect = rect;
+    gif_cache_invalidate(asset, &dirty);
+    lv_timer_set_period(timer, LV_MAX(gif->gce.delay * 10, 10));
+}
+
+static uint32_t gif_cache_count_frames(gd_GIF *gif)
+{
+    uint32_t cnt = 0;
+
+    while (gd_get_frame(gif) == 1) {
+        cnt++;
+    }
+    gd_rewind(gif);
+    return cnt;
+}
+
+/* Bounding box of the pixels that differ between two RGB565A8 frames */
+static void gif_cache_diff(const uint8_t *a, const uint8_t *b, uint16_t w, uint16_t h, lv_area_t *dirty)
+{
+    const uint16_t *rgb_a = (const uint16_t *)a;
+    const uint16_t *rgb_b = (const uint16_t *)b;
+    const uint8_t *alpha_a = a + w * h * 2;
+    const uint8_t *alpha_b = b + w * h * 2;
+
+    lv_area_set(dirty, w, h, -1, -1);
+    for (int32_t y = 0; y < h; y++) {
+        for (int32_t x = 0; x < w; x++) {
+            uint32_t i = y * w + x;
+            if (rgb_a[i] != rgb_b[i] || alpha_a[i] != alpha_b[i]) {
+                dirty->x1 = LV_MIN(dirty->x1, x);
+                dirty->y1 = LV_MIN(dirty->y1, y);
+                dirty->x2 = LV_MAX(dirty->x2, x);
+                dirty->y2 = LV_MAX(dirty->y2, y);
+            }
+        }
+    }
+}
+
+/* gifdec renders ARGB8888, keep RGB565 plus the alpha plane */
+static void gif_cache_convert(const lv_color32_t *argb, uint8_t *dst, uint32_t px_cnt)
+{
+    uint16_t *rgb = (uint16_t *)dst;
+    uint8_t *alpha = dst + px_cnt * 2;
+
+    for (uint32_t i = 0; i < px_cnt; i++) {
+        rgb[i] = lv_color_to_u16(lv_color_make(argb[i].red, argb[i].green, argb[i].blue));
+        alpha[i] = argb[i].alpha;
+    }
+}
+
+static bool gif_cache_predecode(gif_asset_t *asset, gd_GIF *gif, uint32_t budget_bytes)
+{
+    const uint32_t px_cnt = gif->width * gif->height;
+    const uint32_t frame_size = px_cnt * 3;
+    const uint32_t frame_cnt = gif_cache_count_frames(gif);
+
+    if (frame_cnt == 0) {
+        return false;
+    }
+    if ((uint64_t)frame_cnt * frame_size > budget_bytes) {
+        ESP_LOGW(TAG, "%"PRIu32" frames need %"PRIu32" bytes, budget is %"PRIu32, frame_cnt, frame_cnt * frame_size, budget_bytes);
+        return false;
+    }
+
+    lv_color32_t *canvas = malloc(px_cnt * sizeof(lv_color32_t));
+    asset->frames = calloc(frame_cnt, sizeof(gif_cache_frame_t));
+    asset->pixels = heap_caps_malloc(frame_cnt * frame_size, MALLOC_CAP_SPIRAM);
+    if (!canvas || !asset->frames || !asset->pixels) {
+        ESP_LOGW(TAG, "Not enough memory for %"PRIu32" decoded frames", frame_cnt);
+        heap_caps_free(asset->pixels);
+        free(asset->frames);
+        free(canvas);
+        asset->pixels = NULL;
+        asset->frames = NULL;
+        return false;
+    }
+
+    for (uint32_t i = 0; i < frame_cnt && gd_get_frame(gif) == 1; i++) {
+        gif_cache_frame_t *frame = &asset->frames[i];
+        uint8_t *data = asset->pixels + i * frame_size;
+
+        gd_render_frame(gif, (uint8_t *)canvas);
+        gif_cache_convert(canvas, data, px_cnt);
+
+        frame->data = data;
+        frame->delay_ms = LV_MAX(gif->gce.delay * 10, 10);
+        asset->frame_cnt++;
+    }
+    free(canvas);
+
+    /* The first frame is compared with the last one, the animation loops */
+    uint32_t dirty_px = 0;
+    for (uint32_t i = 0; i < asset->frame_cnt; i++) {
+        const uint8_t *prev = asset->frames[(i + asset->frame_cnt - 1) % asset->frame_cnt].data;
+        gif_cache_diff(prev, asset->frames[i].data, gif->width, gif->height, &asset->frames[i].dirty);
+        if (asset->frames[i].dirty.x2 >= 0) {
+            dirty_px += lv_area_get_size(&asset->frames[i].dirty);
+        }
+    }
+
+    asset->dsc.header.magic = LV_IMAGE_HEADER_MAGIC;
+    asset->dsc.header.cf = LV_COLOR_FORMAT_RGB565A8;
+    asset->dsc.header.w = gif->width;
+    asset->dsc.header.h = gif->height;
+    asset->dsc.header.stride = gif->width * 2;
+    asset->dsc.data_size = frame_size;
+    asset->dsc.data = asset->frames[0].data;
+    ESP_LOGI(TAG, "%"PRIu32" of %"PRIu32" pixels change per frame on average", dirty_px / asset->frame_cnt, px_cnt);
+
+    ESP_LOGI(TAG, "Pre-decoded %"PRIu32" frames %ux%u, %"PRIu32" bytes in PSRAM", asset->frame_cnt, gif->width, gif->height, asset->frame_cnt * frame_size);
+    return true;
+}
+
+static bool gif_cache_stream(gif_asset_t *asset, gd_GIF *gif)
+{
+    const uint32_t size = gif->width * gif->height * sizeof(lv_color32_t);
+    uint8_t *canvas = malloc(size);
+
+    if (!canvas || gd_get_frame(gif) != 1) {
+        free(canvas);
+        return false;
+    }
+    gd_render_frame(gif, canvas);
+
+    asset->gif = gif;
+    lv_area_set(&asset->prev_rect, 0, 0, gif->width - 1, gif->height - 1);
+    asset->dsc.header.magic = LV_IMAGE_HEADER_MAGIC;
+    asset->dsc.header.cf = LV_COLOR_FORMAT_ARGB8888;
+    asset->dsc.header.w = gif->width;
+    asset->dsc.header.h = gif->height;
+    asset->dsc.header.stride = gif->width * sizeof(lv_color32_t);
+    asset->dsc.data_size = size;
+    asset->dsc.data = canvas;
+
+    ESP_LOGI(TAG, "GIF decoded on the fly");
+    return true;
+}
+
+static void gif_cache_asset_free(gif_asset_t *asset)
+{
+    if (asset->timer) {
+        lv_timer_delete(asset->timer);
+    }
+    if (asset->gif) {
+        gd_close_gif(asset->gif);
+    }
+    if (asset->gif) {
+        free((void *)asset->dsc.data);
+    }
+    heap_caps_free(asset->pixels);
+    free(asset->frames);
+    free(asset->imgs);
+    free(asset);
+}
+
+static gif_asset_t *gif_cache_asset_get(const lv_image_dsc_t *src, uint32_t budget_bytes)
+{
+    for (gif_asset_t *asset = gif_assets; asset; asset = asset->next) {
+        if (asset->data == src->data) {
+            return asset;
+        }
+    }
+
+    gif_asset_t *asset = calloc(1, sizeof(gif_asset_t));
+    gd_GIF *gif = gd_open_gif_data(src->data);
+    if (!asset || !gif) {
+        ESP_LOGE(TAG, "Open GIF failed");
+        if (gif) {
+            gd_close_gif(gif);
+        }
+        free(asset);
+        return NULL;
+    }
+    asset->data = src->data;
+
+    if (gif_cache_predecode(asset, gif, budget_bytes)) {
+        gd_close_gif(gif);
+    } else if (!gif_cache_stream(asset, gif)) {
+        gd_close_gif(gif);
+        gif_cache_asset_free(asset);
+        return NULL;
+    }
+
+    asset->next = gif_assets;
+    gif_assets = asset;
+    return asset;
+}
+
+static void gif_cache_delete_cb(lv_event_t *e)
+{
+    gif_asset_t *asset = lv_event_get_user_data(e);
+    lv_obj_t *img = lv_event_get_target(e);
+
+    for (uint32_t i = 0; i < asset->img_cnt; i++) {
+        if (asset->imgs[i] == img) {
+            asset->imgs[i] = asset->imgs[--asset->img_cnt];
+            break;
+        }
+    }
+    if (asset->img_cnt) {
+        return;
+    }
+
+    /* Last reference gone */
+    gif_asset_t **pp = &gif_assets;
+    while (*pp != asset) {
+        pp = &(*pp)->next;
+    }
+    *pp = asset->next;
+    gif_cache_asset_free(asset);
+}
+
+lv_obj_t *gif_cache_create(lv_obj_t *parent, const lv_image_dsc_t *src, const gif_cache_cfg_t *cfg)
+{
+    gif_asset_t *asset = gif_cache_asset_get(src, cfg->budget_bytes);
+    if (!asset) {
+        return NULL;
+    }
+    if (!asset->timer) {
+        /* Created with the first image, a preloaded asset does not animate before it is shown */
+        asset->timer = lv_timer_create(gif_cache_timer_cb, asset->frames ? asset->frames[0].delay_ms : LV_MAX(asset->gif->gce.delay * 10, 10), asset);
+        if (!asset->timer) {
+            return NULL;
+        }
+    }
+
+    lv_obj_t **imgs = realloc(asset->imgs, (asset->img_cnt + 1) * sizeof(lv_obj_t *));
+    if (!imgs) {
+        return NULL;
+    }
+    asset->imgs = imgs;
+
+    lv_obj_t *img = lv_image_create(parent);
+    lv_image_set_src(img, &asset->dsc);
+    lv_obj_add_event_cb(img, gif_cache_delete_cb, LV_EVENT_DELETE, asset);
+    asset->imgs[asset->img_cnt++] = img;
+
+    ESP_LOGD(TAG, "GIF %p shown by %"PRIu32" images", asset->data, asset->img_cnt);
+    return img;
+}
+
+esp_err_t gif_cache_preload(const lv_image_dsc_t *src, const gif_cache_cfg_t *cfg)
+{
+    return gif_cache_asset_get(src, cfg->budget_bytes) ? ESP_OK : ESP_FAIL;
+}
@@ -0,0 +1,55 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief GIF frame cache configuration
+ */
+typedef struct {
+    uint32_t budget_bytes;      /* PSRAM allowed for the decoded frames, above it the GIF is decoded on the fly */
+} gif_cache_cfg_t;
+
+/**
+ * @brief Create an animated image from a GIF, pre-decoding all frames when they fit
+ *
+ * All frames are decoded once into RGB565A8 buffers in PSRAM and played back by swapping
+ * image descriptors from an LVGL timer, so no LZW decoding happens while the animation runs.
+ * When the frames do not fit into the budget (or PSRAM), the GIF is decoded on the fly instead.
+ *
+ * Images created from the same GIF bytes (e.g. `img_bulb_gif0` and `img_bulb_gif1`) share one
+ * reference-counted asset: one decoder, one set of frames and one timer advancing them together.
+ * The asset is freed with its last image. The budget is only used when the asset is created.
+ *
+ * @param parent Parent object
+ * @param src    GIF image descriptor (`LV_COLOR_FORMAT_RAW`, data is the GIF file)
+ * @param cfg    Cache configuration
+ * @return The created object, NULL on error
+ */
+lv_obj_t *gif_cache_create(lv_obj_t *parent, const lv_image_dsc_t *src, const gif_cache_cfg_t *cfg);
+
+/**
+ * @brief Decode a GIF into the cache ahead of the first gif_cache_create() showing it
+ *
+ * Lets the decoding run during boot, before any display exists. The asset stays in the
+ * cache until an image showing it is created and deleted again. Must be called with the
+ * LVGL lock held, the decoder allocates from the LVGL heap.
+ *
+ * @param src GIF image descriptor (`LV_COLOR_FORMAT_RAW`, data is the GIF file)
+ * @param cfg Cache configuration
+ * @return ESP_OK once the asset is in the cache
+ */
+esp_err_t gif_cache_preload(const lv_image_dsc_t *src, const gif_cache_cfg_t *cfg);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,188 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <inttypes.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "img_c565.h"
+#include "src/draw/lv_image_decoder_private.h"
+
+/* Ops, a QOI variant on RGB565 (tools/img_conv.py) */
+#define IMG_C565_OP_RUN     (0x00)  /* 00nnnnnn           previous pixel n + 1 times */
+#define IMG_C565_OP_INDEX   (0x40)  /* 01iiiiii           pixel from the hash table */
+#define IMG_C565_OP_DIFF    (0x80)  /* 10rrggbb           -2..1 added to every channel */
+#define IMG_C565_OP_LUMA    (0xC0)  /* 110ggggg rrrrbbbb  green -16..15, red and blue -8..7 off green */
+#define IMG_C565_OP_LIT     (0xE0)  /* 111nnnnn           n + 1 little-endian pixels follow */
+
+static const char *TAG = "img_c565";
+
+static inline uint32_t img_c565_hash(uint16_t px)
+{
+    return ((px >> 11) * 3 + ((px >> 5) & 0x3F) * 5 + (px & 0x1F) * 7) & 0x3F;
+}
+
+/* Channel deltas wrap within their channel */
+static inline uint16_t img_c565_add(uint16_t px, int32_t dr, int32_t dg, int32_t db)
+{
+    return ((((px >> 11) + dr) & 0x1F) << 11) | ((((px >> 5) + dg) & 0x3F) << 5) | ((px + db) & 0x1F);
+}
+
+/* Decodes pixels 0 to end - 1 of a row, stores those from x on */
+static void img_c565_row(const uint8_t *in, uint16_t *out, int32_t x, int32_t end)
+{
+    uint16_t index[64] = { 0 };
+    uint16_t px = 0;
+    int32_t i = 0;
+
+    while (i < end) {
+        const uint8_t op = *in++;
+
+        if (op < IMG_C565_OP_INDEX) {
+            const int32_t n = LV_MIN(i + (op & 0x3F) + 1, end);
+            for (int32_t k = LV_MAX(i, x); k < n; k++) {
+                out[k - x] = px;
+            }
+            i = n;
+            continue;
+        }
+        if (op >= IMG_C565_OP_LIT) {
+            const int32_t n = LV_MIN(i + (op & 0x1F) + 1, end);
+            for (; i < n; i++, in += 2) {
+                px = in[0] | in[1] << 8;
+                index[img_c565_hash(px)] = px;
+                if (i >= x) {
+                    out[i - x] = px;
+                }
+            }
+            continue;
+        }
+
+        if (op < IMG_C565_OP_DIFF) {
+            px = index[op & 0x3F];
+        } else {
+            if (op < IMG_C565_OP_LUMA) {
+                px = img_c565_add(px, ((op >> 4) & 3) - 2, ((op >> 2) & 3) - 2, (op & 3) - 2);
+            } else {
+                const int32_t dg = (op & 0x1F) - 16;
+                const uint8_t rb = *in++;
+                px = img_c565_add(px, dg + (rb >> 4) - 8, dg, dg + (rb & 0x0F) - 8);
+            }
+            index[img_c565_hash(px)] = px;
+        }
+        if (i >= x) {
+            out[i - x] = px;
+        }
+        i++;
+    }
+}
+
+bool img_c565_is_valid(const lv_image_dsc_t *src)
+{
+    const img_c565_header_t *hdr = (const img_c565_header_t *)src->data;
+
+    if (src->header.cf != LV_COLOR_FORMAT_RAW || src->data_size < sizeof(img_c565_header_t) ||
+            memcmp(hdr->magic, "C565", 4) != 0 || hdr->version != IMG_C565_VERSION || !hdr->w || !hdr->h) {
+        return false;
+    }
+    const uint32_t table_end = sizeof(img_c565_header_t) + hdr->h * sizeof(uint32_t);
+    const uint32_t *offsets = (const uint32_t *)(src->data + sizeof(img_c565_header_t));
+    return src->data_size > table_end && offsets[hdr->h - 1] < src->data_size - table_end;
+}
+
+void img_c565_decode_rows(const lv_image_dsc_t *src, int32_t y, int32_t rows, int32_t x, int32_t w,
+                          uint8_t *dst, uint32_t stride)
+{
+    const img_c565_header_t *hdr = (const img_c565_header_t *)src->data;
+    const uint32_t *offsets = (const uint32_t *)(src->data + sizeof(img_c565_header_t));
+    const uint8_t *data = (const uint8_t *)(offsets + hdr->h);
+
+    for (int32_t r = 0; r < rows; r++) {
+        img_c565_row(data + offsets[y + r], (uint16_t *)(dst + r * stride), x, x + w);
+    }
+}
+
+static lv_result_t img_c565_info(lv_image_decoder_t *decoder, lv_image_decoder_dsc_t *dsc, lv_image_header_t *header)
+{
+    if (lv_image_src_get_type(dsc->src) != LV_IMAGE_SRC_VARIABLE || !img_c565_is_valid(dsc->src)) {
+        return LV_RESULT_INVALID;
+    }
+    const img_c565_header_t *hdr = (const img_c565_header_t *)((const lv_image_dsc_t *)dsc->src)->data;
+
+    lv_memzero(header, sizeof(lv_image_header_t));
+    header->magic = LV_IMAGE_HEADER_MAGIC;
+    header->cf = LV_COLOR_FORMAT_RGB565;
+    header->w = hdr->w;
+    header->h = hdr->h;
+    header->stride = hdr->w * sizeof(uint16_t);
+    return LV_RESULT_OK;
+}
+
+/* No whole decoded image, the renderer asks for the rows it draws through img_c565_get_area() */
+static lv_result_t img_c565_open(lv_image_decoder_t *decoder, lv_image_decoder_dsc_t *dsc)
+{
+    const uint32_t rows = LV_MAX(IMG_C565_CHUNK_BYTES / dsc->header.stride, 1);
+    lv_draw_buf_t *buf = lv_draw_buf_create(dsc->header.w, rows, LV_COLOR_FORMAT_RGB565, LV_STRIDE_AUTO);
+
+    if (!buf) {
+        ESP_LOGE(TAG, "no memory for %"PRIu32" rows", rows);
+        return LV_RESULT_INVALID;
+    }
+    dsc->user_data = buf;
+    dsc->decoded = NULL;
+    return LV_RESULT_OK;
+}
+
+/* The next band of rows of full_area, as many as fit into the buffer at its width */
+static lv_result_t img_c565_get_area(lv_image_decoder_t *decoder, lv_image_decoder_dsc_t *dsc,
+                                     const lv_area_t *full_area, lv_area_t *decoded_area)
+{
+    lv_draw_buf_t *buf = dsc->user_data;
+    lv_area_t area;
+
+    /* Transformed images ask for their bounding box, only the image itself can be decoded */
+    lv_area_set(&area, 0, 0, dsc->header.w - 1, dsc->header.h - 1);
+    if (!lv_area_intersect(&area, &area, full_area)) {
+        return LV_RESULT_INVALID;
+    }
+
+    decoded_area->y1 = decoded_area->y1 == LV_COORD_MIN ? area.y1 : decoded_area->y2 + 1;
+    if (decoded_area->y1 > area.y2) {
+        return LV_RESULT_INVALID;
+    }
+
+    const int32_t w = lv_area_get_width(&area);
+    const uint32_t stride = lv_draw_buf_width_to_stride(w, LV_COLOR_FORMAT_RGB565);
+    const int32_t rows = LV_MIN((int32_t)(buf->data_size / stride), area.y2 - decoded_area->y1 + 1);
+    decoded_area->x1 = area.x1;
+    decoded_area->x2 = area.x2;
+    decoded_area->y2 = decoded_area->y1 + rows - 1;
+
+    if (!lv_draw_buf_reshape(buf, LV_COLOR_FORMAT_RGB565, w, rows, stride)) {
+        return LV_RESULT_INVALID;
+    }
+    img_c565_decode_rows(dsc->src, decoded_area->y1, rows, area.x1, w, buf->data, stride);
+    dsc->decoded = buf;
+    return LV_RESULT_OK;
+}
+
+static void img_c565_close(lv_image_decoder_t *decoder, lv_image_decoder_dsc_t *dsc)
+{
+    lv_draw_buf_destroy(dsc->user_data);
+    dsc->user_data = NULL;
+    dsc->decoded = NULL;
+}
+
+esp_err_t img_c565_init(void)
+{
+    lv_image_decoder_t *decoder = lv_image_decoder_create();
+
+    ESP_RETURN_ON_FALSE(decoder, ESP_ERR_NO_MEM, TAG, "no memory for the decoder");
+    lv_image_decoder_set_info_cb(decoder, img_c565_info);
+    lv_image_decoder_set_open_cb(decoder, img_c565_open);
+    lv_image_decoder_set_get_area_cb(decoder, img_c565_get_area);
+    lv_image_decoder_set_close_cb(decoder, img_c565_close);
+    decoder->name = "C565";
+    return ESP_OK;
+}
@@ -0,0 +1,74 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IMG_C565_VERSION        (1)
+#define IMG_C565_CHUNK_BYTES    (4096)  /* Decoded rows handed to the renderer at a time */
+
+/**
+ * @brief C565 image header, see tools/img_conv.py for the layout
+ *
+ * Followed by `h` 32-bit row offsets counted from the end of the table, then the rows.
+ * Every row is compressed on its own, so any band of rows decodes without the ones above.
+ */
+typedef struct __attribute__((packed)) {
+    char magic[4];              /* "C565" */
+    uint8_t version;
+    uint8_t flags;
+    uint16_t w;
+    uint16_t h;
+    uint16_t reserved;
+} img_c565_header_t;
+
+/**
+ * @brief Check a descriptor holds a C565 image
+ *
+ * @param src Descriptor generated by tools/img_conv.py (`LV_COLOR_FORMAT_RAW`, data is the C565 stream)
+ * @return true when it does
+ */
+bool img_c565_is_valid(const lv_image_dsc_t *src);
+
+/**
+ * @brief Decompress rows of a C565 image into RGB565 pixels
+ *
+ * Only columns `x` to `x + w - 1` are stored, the pixels left of them are decoded and dropped.
+ *
+ * @param src    C565 descriptor, see img_c565_is_valid()
+ * @param y      First row
+ * @param rows   Rows to decode
+ * @param x      First column to store
+ * @param w      Columns to store, `x + w` at most the image width
+ * @param dst    Destination of pixel `x` of the first row
+ * @param stride Destination bytes per row
+ */
+void img_c565_decode_rows(const lv_image_dsc_t *src, int32_t y, int32_t rows, int32_t x, int32_t w,
+                          uint8_t *dst, uint32_t stride);
+
+/**
+ * @brief Register the C565 image decoder with LVGL
+ *
+ * Images whose source is a C565 descriptor then show as plain RGB565 images. They are never
+ * decoded as a whole: while rendering, the rows of the area being drawn are decompressed
+ * IMG_C565_CHUNK_BYTES at a time straight from flash into a small buffer and blended from
+ * there, so a large background costs no RAM beyond that buffer. Transformed (rotated or
+ * scaled) images need the whole image and are not supported.
+ *
+ * Must be called after lv_init(), with the LVGL lock held.
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t img_c565_init(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,115 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <inttypes.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "lcd_buf.h"
+
+#ifdef ESP_PLATFORM
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "lcd_simd.h"
+
+#define LCD_BUF_INTERNAL_CAPS   (MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL)
+#define LCD_BUF_PROBE_INTERNAL  (16 * 1024)
+#define LCD_BUF_PROBE_PSRAM     (128 * 1024)    /* Larger than the data cache */
+
+static const char *TAG = "lcd_buf";
+#endif
+
+static bool lcd_buf_fits(const lcd_buf_req_t *req, uint32_t rows, uint32_t internal_free, uint32_t internal_largest)
+{
+    const uint32_t buf_bytes = req->hres * rows * req->px_size;
+
+    return buf_bytes <= internal_largest &&
+           (uint64_t)buf_bytes * req->buf_num + req->reserve_bytes <= internal_free;
+}
+
+void lcd_buf_place(const lcd_buf_req_t *req, uint32_t internal_free, uint32_t internal_largest, lcd_buf_plan_t *plan)
+{
+    memset(plan, 0, sizeof(lcd_buf_plan_t));
+    plan->internal_free = internal_free;
+    plan->internal_largest = internal_largest;
+    plan->place = LCD_BUF_PLACE_PSRAM;
+    plan->rows = req->rows;
+
+    if (req->policy != LCD_BUF_POLICY_PSRAM && lcd_buf_fits(req, req->rows, internal_free, internal_largest)) {
+        plan->place = LCD_BUF_PLACE_INTERNAL;
+    } else if (req->policy == LCD_BUF_POLICY_AUTO && !req->full_refresh && req->min_rows) {
+        /* Tallest stripe that still fits, more render passes per frame but no PSRAM traffic */
+        for (uint32_t rows = (req->rows / req->min_rows) * req->min_rows; rows >= req->min_rows; rows -= req->min_rows) {
+            if (lcd_buf_fits(req, rows, internal_free, internal_largest)) {
+                plan->place = LCD_BUF_PLACE_STRIPE;
+                plan->rows = rows;
+                break;
+            }
+        }
+    }
+    plan->buf_bytes = req->hres * plan->rows * req->px_size;
+}
+
+const char *lcd_buf_place_name(lcd_buf_place_t place)
+{
+    switch (place) {
+    case LCD_BUF_PLACE_INTERNAL:
+        return "internal";
+    case LCD_BUF_PLACE_STRIPE:
+        return "internal stripe";
+    case LCD_BUF_PLACE_PSRAM:
+        return "PSRAM";
+    }
+    return "?";
+}
+
+#ifdef ESP_PLATFORM
+esp_err_t lcd_buf_plan(const lcd_buf_req_t *req, lcd_buf_plan_t *plan)
+{
+    ESP_RETURN_ON_FALSE(req && plan && req->hres && req->rows && req->px_size && req->buf_num, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    lcd_buf_place(req, heap_caps_get_free_size(LCD_BUF_INTERNAL_CAPS),
+                  heap_caps_get_largest_free_block(LCD_BUF_INTERNAL_CAPS), plan);
+
+    ESP_LOGI(TAG, "%d x %"PRIu32" rows (%"PRIu32" B) in %s, internal DMA free %"PRIu32" B, largest %"PRIu32" B",
+             req->buf_num, plan->rows, plan->buf_bytes, lcd_buf_place_name(plan->place),
+             plan->internal_free, plan->internal_largest);
+    return ESP_OK;
+}
+
+uint32_t lcd_buf_caps(const lcd_buf_plan_t *plan)
+{
+    return plan->place == LCD_BUF_PLACE_PSRAM ? (MALLOC_CAP_DMA | MALLOC_CAP_SPIRAM) : LCD_BUF_INTERNAL_CAPS;
+}
+
+static uint32_t lcd_buf_probe_one(uint32_t caps, size_t size)
+{
+    uint16_t *buf = heap_caps_malloc(size, caps);
+    if (!buf) {
+        return 0;
+    }
+
+    /* Byte swap reads and writes every pixel once, like a blend pass */
+    lcd_simd_rgb565_swap(buf, size / 2);
+    const int64_t start = esp_timer_get_time();
+    for (int i = 0; i < 4; i++) {
+        lcd_simd_rgb565_swap(buf, size / 2);
+    }
+    const int64_t us = esp_timer_get_time() - start;
+    heap_caps_free(buf);
+    return us ? (uint32_t)(4ULL * size * 1000 / us) : 0;
+}
+
+esp_err_t lcd_buf_probe(lcd_buf_plan_t *plan)
+{
+    ESP_RETURN_ON_FALSE(plan, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    plan->internal_bytes_ms = lcd_buf_probe_one(LCD_BUF_INTERNAL_CAPS, LCD_BUF_PROBE_INTERNAL);
+    plan->psram_bytes_ms = lcd_buf_probe_one(MALLOC_CAP_SPIRAM, LCD_BUF_PROBE_PSRAM);
+
+    ESP_LOGI(TAG, "Pixel pass throughput: internal %"PRIu32" B/ms, PSRAM %"PRIu32" B/ms",
+             plan->internal_bytes_ms, plan->psram_bytes_ms);
+    return ESP_OK;
+}
+#endif
@@ -0,0 +1,97 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Where the draw buffers may go
+ */
+typedef enum {
+    LCD_BUF_POLICY_AUTO,        /* Internal, else a shorter internal stripe, else PSRAM */
+    LCD_BUF_POLICY_INTERNAL,    /* Internal at the requested height, else PSRAM */
+    LCD_BUF_POLICY_PSRAM,       /* Always PSRAM */
+} lcd_buf_policy_t;
+
+/**
+ * @brief Where the draw buffers went
+ */
+typedef enum {
+    LCD_BUF_PLACE_INTERNAL,     /* Internal DMA SRAM at the requested height */
+    LCD_BUF_PLACE_STRIPE,       /* Internal DMA SRAM, fewer rows per render pass */
+    LCD_BUF_PLACE_PSRAM,        /* PSRAM at the requested height */
+} lcd_buf_place_t;
+
+/**
+ * @brief Draw buffer requirements
+ */
+typedef struct {
+    lcd_buf_policy_t policy;
+    uint32_t hres;              /* Pixels per row */
+    uint32_t rows;              /* Requested rows per buffer */
+    uint32_t min_rows;          /* Shortest stripe still worth rendering, rows are kept a multiple of it */
+    uint8_t px_size;            /* Bytes per pixel */
+    uint8_t buf_num;            /* Buffers the flush path allocates */
+    bool full_refresh;          /* Whole-screen buffers, stripes are not possible */
+    uint32_t reserve_bytes;     /* Internal DMA SRAM left for drivers, queues and stacks */
+} lcd_buf_req_t;
+
+/**
+ * @brief Chosen placement, with the measurements it was based on
+ */
+typedef struct {
+    lcd_buf_place_t place;
+    uint32_t rows;              /* Rows per buffer */
+    uint32_t buf_bytes;         /* Bytes per buffer */
+    uint32_t internal_free;     /* Free internal DMA SRAM at planning time */
+    uint32_t internal_largest;  /* Largest free internal DMA block at planning time */
+    uint32_t internal_bytes_ms; /* Read-modify-write throughput of internal SRAM, 0 if not probed */
+    uint32_t psram_bytes_ms;    /* Read-modify-write throughput of PSRAM, 0 if not probed */
+} lcd_buf_plan_t;
+
+/**
+ * @brief Place the draw buffers for the given free internal memory
+ *
+ * Pure function, usable on the host to compare policies for a given heap state.
+ */
+void lcd_buf_place(const lcd_buf_req_t *req, uint32_t internal_free, uint32_t internal_largest, lcd_buf_plan_t *plan);
+
+#ifdef ESP_PLATFORM
+/**
+ * @brief Measure internal DMA SRAM and place the draw buffers
+ *
+ * Call right before the buffers are allocated, the result is only valid for the current heap state.
+ *
+ * @param req  Buffer requirements
+ * @param plan Chosen placement
+ * @return ESP_OK on success
+ */
+esp_err_t lcd_buf_plan(const lcd_buf_req_t *req, lcd_buf_plan_t *plan);
+
+/**
+ * @brief Time a byte swap pass over internal SRAM and PSRAM, fills the throughput fields of the plan
+ */
+esp_err_t lcd_buf_probe(lcd_buf_plan_t *plan);
+
+/**
+ * @brief Heap capabilities for further buffers of the same placement
+ */
+uint32_t lcd_buf_caps(const lcd_buf_plan_t *plan);
+#endif
+
+/**
+ * @brief Placement name for logs
+ */
+const char *lcd_buf_place_name(lcd_buf_place_t place);
+
+#ifdef __cplusplus
+}
+#endif
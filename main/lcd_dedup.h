@@ -0,0 +1,97 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Unchanged band filter configuration
+ *
+ * The screen is split into bands of `band_rows` full-width rows. A flushed band whose
+ * hash matches the one last sent to the same rows is left out of the transfer, the panel
+ * keeps showing it from its GRAM. `band_rows` should be a multiple of the panel's RASET
+ * granularity, the rows sent always start on a band or area boundary.
+ */
+typedef struct {
+    uint16_t hres;
+    uint16_t vres;
+    uint16_t band_rows;         /* Rows per band, e.g. 16 */
+    uint8_t px_size;            /* Bytes per pixel */
+} lcd_dedup_cfg_t;
+
+/**
+ * @brief Rows of a flushed area that have to go on the wire, screen coordinates, inclusive
+ */
+typedef struct {
+    int32_t y1;
+    int32_t y2;
+} lcd_dedup_run_t;
+
+/**
+ * @brief Filter statistics since creation
+ */
+typedef struct {
+    uint32_t areas;             /* Areas filtered */
+    uint32_t areas_skipped;     /* Areas with nothing left to send */
+    uint32_t bands;             /* Whole bands hashed */
+    uint32_t bands_skipped;     /* Bands left out as unchanged */
+    uint64_t bytes_saved;       /* Pixel bytes left out */
+} lcd_dedup_stats_t;
+
+typedef struct lcd_dedup_t lcd_dedup_t;
+
+/**
+ * @brief Create an unchanged band filter
+ *
+ * Every band starts unknown, so the first frame is sent whole.
+ *
+ * @param cfg       Configuration
+ * @param ret_dedup Returned filter
+ * @return ESP_OK on success
+ */
+esp_err_t lcd_dedup_new(const lcd_dedup_cfg_t *cfg, lcd_dedup_t **ret_dedup);
+
+/**
+ * @brief Delete a filter
+ */
+void lcd_dedup_del(lcd_dedup_t *dedup);
+
+/**
+ * @brief Find the rows of an area that differ from what the panel shows
+ *
+ * The area must lie on the screen. Only bands lying wholly inside a full-width area are
+ * compared, rows of partial bands and of narrower areas are always sent and the bands
+ * they touch become unknown. The returned runs are valid until the next call; send each
+ * as its own window of area->x1..x2, starting at `px + (run.y1 - area->y1) * width * px_size`.
+ *
+ * Must be called in the order the areas go on the wire, after any byte swapping.
+ *
+ * @param dedup Filter
+ * @param area  Flushed area
+ * @param px    Its pixels, as they are sent
+ * @param runs  Returned runs, ascending
+ * @return Number of runs, 0 if the panel already shows the whole area
+ */
+int lcd_dedup_filter(lcd_dedup_t *dedup, const lv_area_t *area, const uint8_t *px, const lcd_dedup_run_t **runs);
+
+/**
+ * @brief Forget every band, e.g. after the panel lost its GRAM, so the next frame is sent whole
+ */
+void lcd_dedup_invalidate(lcd_dedup_t *dedup);
+
+/**
+ * @brief Get a copy of the statistics, from the task calling lcd_dedup_filter()
+ */
+void lcd_dedup_get_stats(const lcd_dedup_t *dedup, lcd_dedup_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
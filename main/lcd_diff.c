@@ -0,0 +1,305 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "lcd_diff.h"
+#include "lcd_simd.h"
+
+#define LCD_DIFF_ALIGN      (16)    /* Lets the vector compare and copy run on the previous frame */
+#define LCD_DIFF_MERGE_MAX  (32)    /* Boxes the pairwise search starts from, it is cubic in their number */
+
+/* Window in tile units, inclusive */
+typedef struct {
+    int16_t x1;
+    int16_t y1;
+    int16_t x2;
+    int16_t y2;
+} lcd_diff_box_t;
+
+struct lcd_diff_t {
+    lcd_diff_cfg_t cfg;
+    int16_t tiles_x;
+    int16_t tiles_y;
+    uint8_t *dirty;             /* Changed tiles of the current frame, row-major */
+    uint16_t *prev;             /* What the panel shows */
+    uint16_t *pack;             /* Pixels of windows narrower than the screen */
+    lcd_diff_box_t *boxes;
+    lcd_diff_rect_t *rects;
+    bool valid;                 /* False until a frame was sent whole */
+    lcd_diff_stats_t stats;
+};
+
+static const char *TAG = "lcd_diff";
+
+static inline int32_t lcd_diff_box_size(const lcd_diff_box_t *b)
+{
+    return (int32_t)(b->x2 - b->x1 + 1) * (b->y2 - b->y1 + 1);
+}
+
+static inline void lcd_diff_box_join(lcd_diff_box_t *out, const lcd_diff_box_t *a, const lcd_diff_box_t *b)
+{
+    out->x1 = LV_MIN(a->x1, b->x1);
+    out->y1 = LV_MIN(a->y1, b->y1);
+    out->x2 = LV_MAX(a->x2, b->x2);
+    out->y2 = LV_MAX(a->y2, b->y2);
+}
+
+static inline bool lcd_diff_box_inside(const lcd_diff_box_t *in, const lcd_diff_box_t *out)
+{
+    return in->x1 >= out->x1 && in->y1 >= out->y1 && in->x2 <= out->x2 && in->y2 <= out->y2;
+}
+
+/* Marks the tiles of one tile row that differ, whole screen rows are compared first */
+static int lcd_diff_scan_row(lcd_diff_t *diff, const uint16_t *px, int16_t ty)
+{
+    const int32_t hres = diff->cfg.hres;
+    const int32_t tile = diff->cfg.tile;
+    const int32_t y2 = LV_MIN((ty + 1) * tile, diff->cfg.vres);
+    uint8_t *dirty = &diff->dirty[ty * diff->tiles_x];
+    int changed = 0;
+
+    for (int32_t y = ty * tile; y < y2 && changed < diff->tiles_x; y++) {
+        const uint16_t *cur = px + y * hres;
+        const uint16_t *old = diff->prev + y * hres;
+        if (lcd_simd_rgb565_equal(cur, old, hres)) {
+            continue;
+        }
+        for (int16_t tx = 0; tx < diff->tiles_x; tx++) {
+            const int32_t x = tx * tile;
+            if (!dirty[tx] && !lcd_simd_rgb565_equal(cur + x, old + x, LV_MIN(tile, hres - x))) {
+                dirty[tx] = 1;
+                changed++;
+            }
+        }
+    }
+    return changed;
+}
+
+/* Runs of changed tiles, stacked onto the box above when they span the same columns */
+static int lcd_diff_collect(lcd_diff_t *diff)
+{
+    int n = 0;
+
+    for (int16_t ty = 0; ty < diff->tiles_y; ty++) {
+        const uint8_t *dirty = &diff->dirty[ty * diff->tiles_x];
+        for (int16_t tx = 0; tx < diff->tiles_x;) {
+            if (!dirty[tx]) {
+                tx++;
+                continue;
+            }
+            const int16_t x1 = tx;
+            while (tx < diff->tiles_x && dirty[tx]) {
+                tx++;
+            }
+            const int16_t x2 = tx - 1;
+
+            int i = 0;
+            while (i < n && !(diff->boxes[i].y2 == ty - 1 && diff->boxes[i].x1 == x1 && diff->boxes[i].x2 == x2)) {
+                i++;
+            }
+            if (i == n) {
+                diff->boxes[n++] = (lcd_diff_box_t) { x1, ty, x2, ty };
+            } else {
+                diff->boxes[i].y2 = ty;
+            }
+        }
+    }
+    return n;
+}
+
+/* Join the cheapest pair while it wastes less than a window costs or there are too many windows */
+static int lcd_diff_merge(lcd_diff_t *diff, int n)
+{
+    const int64_t tile_px = (int64_t)diff->cfg.tile * diff->cfg.tile;
+    lcd_diff_box_t *boxes = diff->boxes;
+
+    /* Scattered changes: neighbours in scan order are joined pairwise until the search is cheap */
+    while (n > LCD_DIFF_MERGE_MAX) {
+        int m = 0;
+        for (int i = 0; i < n; i += 2, m++) {
+            if (i + 1 < n) {
+                lcd_diff_box_join(&boxes[m], &boxes[i], &boxes[i + 1]);
+            } else {
+                boxes[m] = boxes[i];
+            }
+        }
+        n = m;
+    }
+
+    while (n > 1) {
+        int64_t best = INT64_MAX;
+        int bi = 0, bj = 0;
+        for (int i = 0; i < n; i++) {
+            for (int j = i + 1; j < n; j++) {
+                lcd_diff_box_t joined;
+                lcd_diff_box_join(&joined, &boxes[i], &boxes[j]);
+                const int64_t waste = lcd_diff_box_size(&joined) - lcd_diff_box_size(&boxes[i]) - lcd_diff_box_size(&boxes[j]);
+                if (waste < best) {
+                    best = waste;
+                    bi = i;
+                    bj = j;
+                }
+            }
+        }
+        if (best * tile_px > (int64_t)diff->cfg.window_cost_px && n <= diff->cfg.max_rects) {
+            break;
+        }
+
+        lcd_diff_box_join(&boxes[bi], &boxes[bi], &boxes[bj]);
+        boxes[bj] = boxes[--n];
+        /* Boxes the joined one now covers go away */
+        for (int k = 0; k < n;) {
+            if (k != bi && lcd_diff_box_inside(&boxes[k], &boxes[bi])) {
+                boxes[k] = boxes[--n];
+                if (bi == n) {
+                    bi = k;
+                }
+            } else {
+                k++;
+            }
+        }
+    }
+    return n;
+}
+
+/* Screen area of every box, pixels packed unless full-width, and the previous frame updated */
+static int lcd_diff_emit(lcd_diff_t *diff, const uint16_t *px, int n)
+{
+    const int32_t hres = diff->cfg.hres;
+    const int32_t tile = diff->cfg.tile;
+    uint32_t packed = 0;
+
+    for (int i = 0; i < n; i++) {
+        lcd_diff_rect_t *rect = &diff->rects[i];
+        rect->area.x1 = diff->boxes[i].x1 * tile;
+        rect->area.y1 = diff->boxes[i].y1 * tile;
+        rect->area.x2 = LV_MIN((diff->boxes[i].x2 + 1) * tile, hres) - 1;
+        rect->area.y2 = LV_MIN((diff->boxes[i].y2 + 1) * tile, diff->cfg.vres) - 1;
+        if (rect->area.x1 != 0 || rect->area.x2 != hres - 1) {
+            packed += lv_area_get_size(&rect->area);
+        }
+    }
+
+    /* Overlapping windows could outgrow the packing buffer, the whole frame is cheaper by then */
+    if (packed > (uint32_t)hres * diff->cfg.vres) {
+        n = 1;
+        lv_area_set(&diff->rects[0].area, 0, 0, hres - 1, diff->cfg.vres - 1);
+    }
+
+    uint16_t *dst = diff->pack;
+    for (int i = 0; i < n; i++) {
+        lcd_diff_rect_t *rect = &diff->rects[i];
+        const int32_t w = lv_area_get_width(&rect->area);
+        const uint16_t *src = px + rect->area.y1 * hres + rect->area.x1;
+
+        if (w == hres) {
+            rect->px = (const uint8_t *)src;
+            lcd_simd_rgb565_copy(diff->prev + rect->area.y1 * hres, src, w * lv_area_get_height(&rect->area));
+        } else {
+            rect->px = (const uint8_t *)dst;
+            for (int32_t y = rect->area.y1; y <= rect->area.y2; y++) {
+                lcd_simd_rgb565_copy(dst, src, w);
+                lcd_simd_rgb565_copy(diff->prev + y * hres + rect->area.x1, src, w);
+                dst += w;
+                src += hres;
+            }
+        }
+        diff->stats.bytes_sent += lv_area_get_size(&rect->area) * sizeof(uint16_t);
+    }
+    return n;
+}
+
+esp_err_t lcd_diff_new(const lcd_diff_cfg_t *cfg, lcd_diff_t **ret_diff)
+{
+    ESP_RETURN_ON_FALSE(cfg && ret_diff && cfg->hres && cfg->vres && cfg->tile && cfg->max_rects,
+                        ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    lcd_diff_t *diff = calloc(1, sizeof(lcd_diff_t));
+    ESP_RETURN_ON_FALSE(diff, ESP_ERR_NO_MEM, TAG, "no memory for the diff");
+    diff->cfg = *cfg;
+    diff->tiles_x = (cfg->hres + cfg->tile - 1) / cfg->tile;
+    diff->tiles_y = (cfg->vres + cfg->tile - 1) / cfg->tile;
+
+    const size_t tiles = (size_t)diff->tiles_x * diff->tiles_y;
+    const size_t frame_size = (size_t)cfg->hres * cfg->vres * sizeof(uint16_t);
+    diff->dirty = calloc(tiles, 1);
+    diff->boxes = calloc(tiles, sizeof(lcd_diff_box_t));
+    diff->rects = calloc(tiles, sizeof(lcd_diff_rect_t));
+    /* Only the CPU reads the previous frame, internal DMA SRAM is kept for what goes on the wire */
+    diff->prev = heap_caps_aligned_alloc(LCD_DIFF_ALIGN, frame_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!diff->prev) {
+        diff->prev = heap_caps_aligned_alloc(LCD_DIFF_ALIGN, frame_size, cfg->buf_caps);
+    }
+    diff->pack = heap_caps_aligned_alloc(LCD_DIFF_ALIGN, frame_size, cfg->buf_caps);
+    if (!diff->dirty || !diff->boxes || !diff->rects || !diff->prev || !diff->pack) {
+        ESP_LOGE(TAG, "no memory for %dx%d tiles", diff->tiles_x, diff->tiles_y);
+        lcd_diff_del(diff);
+        return ESP_ERR_NO_MEM;
+    }
+
+    *ret_diff = diff;
+    return ESP_OK;
+}
+
+void lcd_diff_del(lcd_diff_t *diff)
+{
+    if (diff) {
+        free(diff->dirty);
+        free(diff->boxes);
+        free(diff->rects);
+        heap_caps_free(diff->prev);
+        heap_caps_free(diff->pack);
+        free(diff);
+    }
+}
+
+int lcd_diff_frame(lcd_diff_t *diff, const uint8_t *px, const lcd_diff_rect_t **rects)
+{
+    const uint16_t *frame = (const uint16_t *)px;
+    const uint64_t frame_bytes = (uint64_t)diff->cfg.hres * diff->cfg.vres * sizeof(uint16_t);
+    const uint64_t sent = diff->stats.bytes_sent;
+    int n;
+
+    diff->stats.frames++;
+    *rects = diff->rects;
+    if (!diff->valid) {
+        diff->boxes[0] = (lcd_diff_box_t) { 0, 0, diff->tiles_x - 1, diff->tiles_y - 1 };
+        diff->stats.tiles_changed += diff->tiles_x * diff->tiles_y;
+        diff->valid = true;
+        n = 1;
+    } else {
+        int changed = 0;
+        memset(diff->dirty, 0, (size_t)diff->tiles_x * diff->tiles_y);
+        for (int16_t ty = 0; ty < diff->tiles_y; ty++) {
+            changed += lcd_diff_scan_row(diff, frame, ty);
+        }
+        diff->stats.tiles_changed += changed;
+        if (changed == 0) {
+            diff->stats.frames_skipped++;
+            diff->stats.bytes_saved += frame_bytes;
+            return 0;
+        }
+        n = lcd_diff_merge(diff, lcd_diff_collect(diff));
+    }
+
+    n = lcd_diff_emit(diff, frame, n);
+    diff->stats.rects += n;
+    diff->stats.bytes_saved += frame_bytes - LV_MIN(frame_bytes, diff->stats.bytes_sent - sent);
+    return n;
+}
+
+void lcd_diff_invalidate(lcd_diff_t *diff)
+{
+    diff->valid = false;
+}
+
+void lcd_diff_get_stats(const lcd_diff_t *diff, lcd_diff_stats_t *stats)
+{
+    *stats = diff->stats;
+}
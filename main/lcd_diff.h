@@ -0,0 +1,100 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Tile diff configuration
+ *
+ * Every full RGB565 frame is compared with the previous one in `tile` x `tile` squares.
+ * Changed tiles are merged into at most `max_rects` windows, neighbours closer than
+ * `window_cost_px` wasted pixels share one. `tile` should be a multiple of the panel's
+ * CASET / RASET granularity, windows always start and end on the tile grid or the screen edge.
+ * The diff holds two frames: a copy of the previous one, only read by the CPU and placed in
+ * PSRAM when there is any, and a packing buffer that goes out by DMA.
+ */
+typedef struct {
+    uint16_t hres;
+    uint16_t vres;
+    uint8_t tile;               /* Tile edge in pixels, e.g. 16 */
+    uint8_t max_rects;          /* Most windows per frame */
+    uint32_t window_cost_px;    /* Per-window overhead (commands + transaction setup) expressed in pixels */
+    uint32_t buf_caps;          /* Heap capabilities of the packing buffer, and of the previous frame without PSRAM */
+} lcd_diff_cfg_t;
+
+/**
+ * @brief A window to send, its pixels contiguous
+ */
+typedef struct {
+    lv_area_t area;
+    const uint8_t *px;
+} lcd_diff_rect_t;
+
+/**
+ * @brief Diff statistics since creation
+ */
+typedef struct {
+    uint32_t frames;            /* Frames compared */
+    uint32_t frames_skipped;    /* Frames without a changed tile */
+    uint32_t tiles_changed;     /* Changed tiles over all frames */
+    uint32_t rects;             /* Windows emitted */
+    uint64_t bytes_sent;        /* Pixel bytes in the windows */
+    uint64_t bytes_saved;       /* Pixel bytes of whole frames left out */
+} lcd_diff_stats_t;
+
+typedef struct lcd_diff_t lcd_diff_t;
+
+/**
+ * @brief Create a tile diff
+ *
+ * The previous frame starts unknown, so the first frame is sent whole.
+ *
+ * @param cfg      Configuration
+ * @param ret_diff Returned diff
+ * @return ESP_OK on success
+ */
+esp_err_t lcd_diff_new(const lcd_diff_cfg_t *cfg, lcd_diff_t **ret_diff);
+
+/**
+ * @brief Delete a diff
+ */
+void lcd_diff_del(lcd_diff_t *diff);
+
+/**
+ * @brief Find the windows of a full frame that differ from the previous one
+ *
+ * The returned windows are valid until the next call, full-width ones point into `px`,
+ * the others into the diff's packing buffer. Sent in any order they turn what the panel
+ * showed after the previous frame into this one.
+ *
+ * Must be called in the order the frames go on the wire, after any byte swapping.
+ *
+ * @param diff  Diff
+ * @param px    The frame, hres x vres pixels
+ * @param rects Returned windows
+ * @return Number of windows, 0 if the frame did not change
+ */
+int lcd_diff_frame(lcd_diff_t *diff, const uint8_t *px, const lcd_diff_rect_t **rects);
+
+/**
+ * @brief Forget the previous frame, e.g. after the panel lost its GRAM, so the next one is sent whole
+ */
+void lcd_diff_invalidate(lcd_diff_t *diff);
+
+/**
+ * @brief Get a copy of the statistics, from the task calling lcd_diff_frame()
+ */
+void lcd_diff_get_stats(const lcd_diff_t *diff, lcd_diff_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
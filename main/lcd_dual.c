@@ -0,0 +1,223 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_timer.h"
+#include "lcd_dual.h"
+
+typedef struct {
+    esp_lcd_panel_handle_t panel;
+    lv_display_t *disp;
+    const uint8_t *px;          /* Buffer of the flush in progress */
+    lv_area_t area;             /* Area of the flush in progress */
+    int32_t next_y;             /* First row of the next chunk */
+    volatile bool busy;         /* A chunk is on the wire */
+    bool pending;               /* A flush is in progress */
+    uint64_t bytes;
+    uint32_t chunks;
+    uint32_t frames;
+} lcd_dual_lane_t;
+
+typedef struct {
+    lcd_dual_lane_t lane[LCD_DUAL_PANEL_NUM];
+    TaskHandle_t task;
+    portMUX_TYPE lock;
+    bool swap_bytes;
+    uint16_t chunk_rows;
+    uint32_t pclk_hz;
+    int next_lane;              /* Lane served first in the next pass */
+    int64_t active_since;
+    uint64_t active_us;
+} lcd_dual_ctx_t;
+
+static const char *TAG = "lcd_dual";
+
+static lcd_dual_ctx_t dual_ctx = {
+    .lock = portMUX_INITIALIZER_UNLOCKED,
+};
+
+static bool lcd_dual_color_done_cb(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+{
+    lcd_dual_lane_t *lane = (lcd_dual_lane_t *)user_ctx;
+    BaseType_t need_yield = pdFALSE;
+
+    lane->busy = false;
+    vTaskNotifyGiveFromISR(dual_ctx.task, &need_yield);
+    return (need_yield == pdTRUE);
+}
+
+static void lcd_dual_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    if (dual_ctx.swap_bytes) {
+        lv_draw_sw_rgb565_swap(px_map, lv_area_get_size(area));
+    }
+
+    portENTER_CRITICAL(&dual_ctx.lock);
+    for (int i = 0; i < LCD_DUAL_PANEL_NUM; i++) {
+        lcd_dual_lane_t *lane = &dual_ctx.lane[i];
+        if (lane->disp != disp) {
+            continue;
+        }
+        lane->px = px_map;
+        lane->area = *area;
+        lane->next_y = area->y1;
+        lane->pending = true;
+    }
+    if (dual_ctx.active_since == 0) {
+        dual_ctx.active_since = esp_timer_get_time();
+    }
+    portEXIT_CRITICAL(&dual_ctx.lock);
+
+    xTaskNotifyGive(dual_ctx.task);
+}
+
+static void lcd_dual_flush_done(lv_display_t *disp)
+{
+    /* In mirror mode the buffer is released only when every panel fed by it is done */
+    for (int i = 0; i < LCD_DUAL_PANEL_NUM; i++) {
+        if (dual_ctx.lane[i].disp == disp && dual_ctx.lane[i].pending) {
+            return;
+        }
+    }
+    lv_display_flush_ready(disp);
+}
+
+static void lcd_dual_issue_chunk(lcd_dual_lane_t *lane)
+{
+    const uint32_t px_size = lv_color_format_get_size(lv_display_get_color_format(lane->disp));
+    const int32_t w = lv_area_get_width(&lane->area);
+    int32_t y1 = lane->next_y;
+    int32_t y2 = LV_MIN(y1 + dual_ctx.chunk_rows - 1, lane->area.y2);
+    const uint8_t *src = lane->px + (size_t)(y1 - lane->area.y1) * w * px_size;
+
+    lane->next_y = y2 + 1;
+    lane->busy = true;
+    lane->bytes += (uint64_t)w * (y2 - y1 + 1) * px_size;
+    lane->chunks++;
+    esp_lcd_panel_draw_bitmap(lane->panel, lane->area.x1, y1, lane->area.x2 + 1, y2 + 1, src);
+}
+
+static void lcd_dual_task(void *arg)
+{
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        bool idle = true;
+        for (int n = 0; n < LCD_DUAL_PANEL_NUM; n++) {
+            int i = (dual_ctx.next_lane + n) % LCD_DUAL_PANEL_NUM;
+            lcd_dual_lane_t *lane = &dual_ctx.lane[i];
+
+            if (!lane->pending) {
+                continue;
+            }
+            idle = false;
+            if (lane->busy) {
+                continue;
+            }
+            if (lane->next_y > lane->area.y2) {
+                portENTER_CRITICAL(&dual_ctx.lock);
+                lane->pending = false;
+                portEXIT_CRITICAL(&dual_ctx.lock);
+                lane->frames++;
+                lcd_dual_flush_done(lane->disp);
+                continue;
+            }
+            /* The commands take the bus lock, this waits while the other panel's chunk is on the wire */
+            lcd_dual_issue_chunk(lane);
+            dual_ctx.next_lane = (i + 1) % LCD_DUAL_PANEL_NUM;
+        }
+
+        if (idle) {
+            portENTER_CRITICAL(&dual_ctx.lock);
+            if (dual_ctx.active_since) {
+                dual_ctx.active_us += esp_timer_get_time() - dual_ctx.active_since;
+                dual_ctx.active_since = 0;
+            }
+            portEXIT_CRITICAL(&dual_ctx.lock);
+        }
+    }
+}
+
+esp_err_t lcd_dual_init(const lcd_dual_cfg_t *cfg)
+{
+    ESP_RETURN_ON_FALSE(cfg && cfg->chunk_rows && cfg->pclk_hz, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(dual_ctx.task == NULL, ESP_ERR_INVALID_STATE, TAG, "already initialized");
+
+    dual_ctx.swap_bytes = cfg->swap_bytes;
+    dual_ctx.chunk_rows = cfg->chunk_rows;
+    dual_ctx.pclk_hz = cfg->pclk_hz;
+
+    for (int i = 0; i < LCD_DUAL_PANEL_NUM; i++) {
+        lcd_dual_lane_t *lane = &dual_ctx.lane[i];
+        lane->panel = cfg->panel[i];
+        lane->disp = cfg->mirror ? cfg->disp[0] : cfg->disp[i];
+        ESP_RETURN_ON_FALSE(cfg->io[i] && lane->panel && lane->disp, ESP_ERR_INVALID_ARG, TAG, "panel %d not set", i);
+    }
+
+    BaseType_t res;
+    if (cfg->task_affinity < 0) {
+        res = xTaskCreate(lcd_dual_task, "lcd_dual", cfg->task_stack, NULL, cfg->task_priority, &dual_ctx.task);
+    } else {
+        res = xTaskCreatePinnedToCore(lcd_dual_task, "lcd_dual", cfg->task_stack, NULL, cfg->task_priority, &dual_ctx.task, cfg->task_affinity);
+    }
+    ESP_RETURN_ON_FALSE(res == pdPASS, ESP_ERR_NO_MEM, TAG, "create scheduler task failed");
+
+    /* Replace the port's transfer-done callbacks, the scheduler releases the buffers now */
+    esp_err_t ret = ESP_OK;
+    for (int i = 0; i < LCD_DUAL_PANEL_NUM; i++) {
+        const esp_lcd_panel_io_callbacks_t cbs = {
+            .on_color_trans_done = lcd_dual_color_done_cb,
+        };
+        ESP_GOTO_ON_ERROR(esp_lcd_panel_io_register_event_callbacks(cfg->io[i], &cbs, &dual_ctx.lane[i]), err, TAG,
+                          "register IO callback failed");
+    }
+    for (int i = 0; i < LCD_DUAL_PANEL_NUM; i++) {
+        lv_display_set_flush_cb(dual_ctx.lane[i].disp, lcd_dual_flush_cb);
+    }
+
+    ESP_LOGI(TAG, "Dual panel scheduler started (%s, %u rows per chunk)", cfg->mirror ? "mirror" : "independent", cfg->chunk_rows);
+    return ESP_OK;
+
+err:
+    /* No callback may notify the deleted task, the port's ones are gone either way and the boot fails */
+    for (int i = 0; i < LCD_DUAL_PANEL_NUM; i++) {
+        const esp_lcd_panel_io_callbacks_t cbs = { 0 };
+        esp_lcd_panel_io_register_event_callbacks(cfg->io[i], &cbs, NULL);
+    }
+    vTaskDelete(dual_ctx.task);
+    dual_ctx.task = NULL;
+    return ret;
+}
+
+esp_err_t lcd_dual_get_stats(lcd_dual_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(stats, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(dual_ctx.task, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+
+    memset(stats, 0, sizeof(lcd_dual_stats_t));
+    uint64_t total_bytes = 0;
+    for (int i = 0; i < LCD_DUAL_PANEL_NUM; i++) {
+        stats->bytes[i] = dual_ctx.lane[i].bytes;
+        stats->chunks[i] = dual_ctx.lane[i].chunks;
+        stats->frames[i] = dual_ctx.lane[i].frames;
+        total_bytes += stats->bytes[i];
+    }
+
+    portENTER_CRITICAL(&dual_ctx.lock);
+    stats->active_us = dual_ctx.active_us;
+    if (dual_ctx.active_since) {
+        stats->active_us += esp_timer_get_time() - dual_ctx.active_since;
+    }
+    portEXIT_CRITICAL(&dual_ctx.lock);
+
+    if (stats->active_us) {
+        uint64_t wire_us = total_bytes * 8 * 1000000ULL / dual_ctx.pclk_hz;
+        stats->bus_utilization = (uint8_t)LV_MIN(100, wire_us * 100 / stats->active_us);
+    }
+    return ESP_OK;
+}
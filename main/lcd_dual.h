@@ -0,0 +1,75 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LCD_DUAL_PANEL_NUM  (2)
+
+/**
+ * @brief Dual panel flush scheduler configuration
+ *
+ * Both panels sit on the same SPI bus with their own CS line. The scheduler takes over
+ * the flush callback of the LVGL display(s) and feeds the panels in row chunks, always
+ * issuing the next chunk to the panel that is not currently transferring, so neither
+ * display waits for a whole frame of the other.
+ *
+ * Nothing runs on the wire at the same time: the CASET / RASET / RAMWR commands of a chunk
+ * are polling transactions that take the SPI bus lock, so they wait until the other
+ * panel's pixel DMA is done. What overlaps that DMA is the CPU side only, the task wakeup,
+ * the byte swap and the rendering of the next area.
+ */
+typedef struct {
+    esp_lcd_panel_io_handle_t io[LCD_DUAL_PANEL_NUM];
+    esp_lcd_panel_handle_t panel[LCD_DUAL_PANEL_NUM];
+    lv_display_t *disp[LCD_DUAL_PANEL_NUM]; /* In mirror mode only disp[0] is used */
+    bool mirror;                /* Send the buffer rendered by disp[0] to both panels */
+    bool swap_bytes;            /* Swap RGB565 bytes before sending, replaces the port's swap */
+    uint16_t chunk_rows;        /* Rows per draw_bitmap call */
+    uint32_t pclk_hz;           /* SPI pixel clock, used for the utilization estimate */
+    int task_priority;          /* Scheduler task priority, should be above the LVGL task */
+    int task_stack;             /* Scheduler task stack size */
+    int task_affinity;          /* Scheduler task core (-1 is no affinity) */
+} lcd_dual_cfg_t;
+
+/**
+ * @brief Dual panel statistics
+ */
+typedef struct {
+    uint64_t bytes[LCD_DUAL_PANEL_NUM];     /* Pixel bytes sent per panel */
+    uint32_t chunks[LCD_DUAL_PANEL_NUM];    /* Chunks sent per panel */
+    uint32_t frames[LCD_DUAL_PANEL_NUM];    /* Flushes completed per panel */
+    uint64_t active_us;                     /* Time with at least one flush in progress */
+    uint8_t bus_utilization;                /* Pixel time on the wire / active time, in percent */
+} lcd_dual_stats_t;
+
+/**
+ * @brief Start the dual panel flush scheduler
+ *
+ * Must be called after the display(s) have been added to the LVGL port, it replaces
+ * their flush callbacks and the panel IO transfer-done callbacks.
+ *
+ * @param cfg Scheduler configuration
+ * @return ESP_OK on success
+ */
+esp_err_t lcd_dual_init(const lcd_dual_cfg_t *cfg);
+
+/**
+ * @brief Get a copy of the scheduler statistics
+ */
+esp_err_t lcd_dual_get_stats(lcd_dual_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,235 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "lcd_link.h"
+
+#ifdef ESP_PLATFORM
+#include "nvs.h"
+#include "esp_rom_gpio.h"
+#include "soc/gpio_periph.h"
+#include "soc/spi_periph.h"
+
+#define LCD_LINK_NVS_NAMESPACE  "lcd_link"
+#define LCD_LINK_NVS_KEY        "tune"
+
+typedef struct {
+    uint32_t ladder_hash;
+    uint32_t pclk_hz;
+    uint32_t chunk_bytes;
+} lcd_link_stored_t;
+
+typedef struct {
+    lcd_link_probe_t base;
+    spi_host_device_t host;
+    spi_device_handle_t dev;
+    int mosi_io_num;
+} lcd_link_spi_probe_t;
+#endif
+
+static const char *TAG = "lcd_link";
+
+static void lcd_link_pattern(uint8_t *buf, size_t len, uint32_t seed)
+{
+    uint32_t x = seed * 2654435761U + 1;
+
+    for (size_t i = 0; i < len; i++) {
+        x = x * 1664525 + 1013904223;
+        buf[i] = (uint8_t)(x >> 24);
+    }
+}
+
+static bool lcd_link_try(lcd_link_probe_t *probe, uint32_t pclk_hz, uint32_t chunk, uint16_t rounds, uint8_t *tx, uint8_t *rx)
+{
+    if (probe->configure(probe, pclk_hz, chunk) != ESP_OK) {
+        return false;
+    }
+    for (uint16_t r = 0; r < rounds; r++) {
+        lcd_link_pattern(tx, chunk, r);
+        memset(rx, 0, chunk);
+        if (probe->transfer(probe, tx, rx, chunk) != ESP_OK || memcmp(tx, rx, chunk) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+esp_err_t lcd_link_tune(lcd_link_probe_t *probe, const lcd_link_ladder_t *ladder, uint8_t *tx, uint8_t *rx,
+                        lcd_link_result_t *result)
+{
+    ESP_RETURN_ON_FALSE(probe && ladder && tx && rx && result && ladder->pclk_hz[0] && ladder->chunk_bytes[0],
+                        ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    memset(result, 0, sizeof(lcd_link_result_t));
+    for (int c = 0; c < LCD_LINK_MAX_STEPS && ladder->pclk_hz[c]; c++) {
+        for (int s = 0; s < LCD_LINK_MAX_STEPS && ladder->chunk_bytes[s]; s++) {
+            /* Slowest and smallest tried so far, the fallback if nothing passes */
+            result->pclk_hz = ladder->pclk_hz[c];
+            result->chunk_bytes = ladder->chunk_bytes[s];
+            result->tried++;
+            if (lcd_link_try(probe, ladder->pclk_hz[c], ladder->chunk_bytes[s], ladder->rounds ? ladder->rounds : 1, tx, rx)) {
+                ESP_LOGI(TAG, "%"PRIu32" Hz, %"PRIu32" B chunks passed the probe after %u tries",
+                         result->pclk_hz, result->chunk_bytes, result->tried);
+                return ESP_OK;
+            }
+            ESP_LOGD(TAG, "%"PRIu32" Hz, %"PRIu32" B chunks failed", ladder->pclk_hz[c], ladder->chunk_bytes[s]);
+        }
+    }
+    ESP_LOGW(TAG, "No combination passed, falling back to %"PRIu32" Hz, %"PRIu32" B chunks",
+             result->pclk_hz, result->chunk_bytes);
+    return ESP_ERR_NOT_FOUND;
+}
+
+static uint32_t lcd_link_fnv(uint32_t h, uint32_t v)
+{
+    for (int b = 0; b < 4; b++) {
+        h = (h ^ ((v >> (b * 8)) & 0xFF)) * 16777619U;
+    }
+    return h;
+}
+
+uint32_t lcd_link_ladder_hash(const lcd_link_ladder_t *ladder)
+{
+    /* FNV-1a over the candidates */
+    uint32_t h = 2166136261U;
+
+    for (int i = 0; i < LCD_LINK_MAX_STEPS; i++) {
+        h = lcd_link_fnv(h, ladder->pclk_hz[i]);
+        h = lcd_link_fnv(h, ladder->chunk_bytes[i]);
+    }
+    return lcd_link_fnv(h, ladder->rounds);
+}
+
+#ifdef ESP_PLATFORM
+static esp_err_t lcd_link_spi_configure(lcd_link_probe_t *probe, uint32_t pclk_hz, uint32_t chunk_bytes)
+{
+    lcd_link_spi_probe_t *spi = __containerof(probe, lcd_link_spi_probe_t, base);
+
+    if (spi->dev) {
+        spi_bus_remove_device(spi->dev);
+        spi->dev = NULL;
+    }
+    /* No dummy cycles: the driver would otherwise cap full-duplex clocks, the pattern decides instead */
+    const spi_device_interface_config_t dev_cfg = {
+        .clock_speed_hz = pclk_hz,
+        .mode = 0,
+        .spics_io_num = -1,
+        .queue_size = 1,
+        .flags = SPI_DEVICE_NO_DUMMY,
+    };
+    ESP_RETURN_ON_ERROR(spi_bus_add_device(spi->host, &dev_cfg, &spi->dev), TAG, "add device failed");
+
+    /* Read the MOSI pad back as MISO */
+    PIN_INPUT_ENABLE(GPIO_PIN_MUX_REG[spi->mosi_io_num]);
+    esp_rom_gpio_connect_in_signal(spi->mosi_io_num, spi_periph_signal[spi->host].spiq_in, false);
+    return ESP_OK;
+}
+
+static esp_err_t lcd_link_spi_transfer(lcd_link_probe_t *probe, const uint8_t *tx, uint8_t *rx, size_t len)
+{
+    lcd_link_spi_probe_t *spi = __containerof(probe, lcd_link_spi_probe_t, base);
+    spi_transaction_t t = {
+        .length = len * 8,
+        .rxlength = len * 8,
+        .tx_buffer = tx,
+        .rx_buffer = rx,
+    };
+    return spi_device_transmit(spi->dev, &t);
+}
+
+esp_err_t lcd_link_new_spi_probe(const lcd_link_spi_cfg_t *cfg, lcd_link_probe_t **probe)
+{
+    ESP_RETURN_ON_FALSE(cfg && probe && cfg->max_chunk, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    lcd_link_spi_probe_t *spi = calloc(1, sizeof(lcd_link_spi_probe_t));
+    ESP_RETURN_ON_FALSE(spi, ESP_ERR_NO_MEM, TAG, "no memory for probe");
+
+    const spi_bus_config_t buscfg = {
+        .sclk_io_num = cfg->sclk_io_num,
+        .mosi_io_num = cfg->mosi_io_num,
+        .miso_io_num = GPIO_NUM_NC,
+        .quadwp_io_num = GPIO_NUM_NC,
+        .quadhd_io_num = GPIO_NUM_NC,
+        .max_transfer_sz = cfg->max_chunk,
+    };
+    esp_err_t ret = spi_bus_initialize(cfg->host, &buscfg, SPI_DMA_CH_AUTO);
+    if (ret != ESP_OK) {
+        free(spi);
+        ESP_LOGE(TAG, "SPI init failed");
+        return ret;
+    }
+
+    spi->host = cfg->host;
+    spi->mosi_io_num = cfg->mosi_io_num;
+    spi->base.configure = lcd_link_spi_configure;
+    spi->base.transfer = lcd_link_spi_transfer;
+    *probe = &spi->base;
+    return ESP_OK;
+}
+
+void lcd_link_del_spi_probe(lcd_link_probe_t *probe)
+{
+    if (!probe) {
+        return;
+    }
+    lcd_link_spi_probe_t *spi = __containerof(probe, lcd_link_spi_probe_t, base);
+
+    /* Undo the loopback: SPIQ back to its idle constant input, the MOSI pad output only */
+    esp_rom_gpio_connect_in_signal(GPIO_MATRIX_CONST_ZERO_INPUT, spi_periph_signal[spi->host].spiq_in, false);
+    PIN_INPUT_DISABLE(GPIO_PIN_MUX_REG[spi->mosi_io_num]);
+    if (spi->dev) {
+        spi_bus_remove_device(spi->dev);
+    }
+    spi_bus_free(spi->host);
+    free(spi);
+}
+
+esp_err_t lcd_link_load(const lcd_link_ladder_t *ladder, lcd_link_result_t *result)
+{
+    ESP_RETURN_ON_FALSE(ladder && result, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    nvs_handle_t nvs;
+    lcd_link_stored_t stored;
+    size_t size = sizeof(stored);
+
+    if (nvs_open(LCD_LINK_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    esp_err_t ret = nvs_get_blob(nvs, LCD_LINK_NVS_KEY, &stored, &size);
+    nvs_close(nvs);
+    if (ret != ESP_OK || size != sizeof(stored) || stored.ladder_hash != lcd_link_ladder_hash(ladder)) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    memset(result, 0, sizeof(lcd_link_result_t));
+    result->pclk_hz = stored.pclk_hz;
+    result->chunk_bytes = stored.chunk_bytes;
+    result->from_nvs = true;
+    return ESP_OK;
+}
+
+esp_err_t lcd_link_save(const lcd_link_ladder_t *ladder, const lcd_link_result_t *result)
+{
+    ESP_RETURN_ON_FALSE(ladder && result, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    const lcd_link_stored_t stored = {
+        .ladder_hash = lcd_link_ladder_hash(ladder),
+        .pclk_hz = result->pclk_hz,
+        .chunk_bytes = result->chunk_bytes,
+    };
+    nvs_handle_t nvs;
+    ESP_RETURN_ON_ERROR(nvs_open(LCD_LINK_NVS_NAMESPACE, NVS_READWRITE, &nvs), TAG, "open NVS failed");
+    esp_err_t ret = nvs_set_blob(nvs, LCD_LINK_NVS_KEY, &stored, sizeof(stored));
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    ESP_RETURN_ON_ERROR(ret, TAG, "store result failed");
+    return ESP_OK;
+}
+#endif
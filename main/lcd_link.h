@@ -0,0 +1,124 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef ESP_PLATFORM
+#include "driver/spi_master.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LCD_LINK_MAX_STEPS  (6)
+
+/**
+ * @brief Candidate settings, each list fastest/largest first and ended by 0 or the array end
+ */
+typedef struct {
+    uint32_t pclk_hz[LCD_LINK_MAX_STEPS];       /* Pixel clocks */
+    uint32_t chunk_bytes[LCD_LINK_MAX_STEPS];   /* Bytes per SPI transaction (bus max_transfer_sz) */
+    uint16_t rounds;            /* Pattern transfers per combination, every one has to come back intact */
+} lcd_link_ladder_t;
+
+/**
+ * @brief Link under test
+ *
+ * Anything that can send a buffer and hand back what arrived: the SPI loopback below
+ * on the target, a simulated link on the host.
+ */
+typedef struct lcd_link_probe_t lcd_link_probe_t;
+struct lcd_link_probe_t {
+    /* Switch the link to a clock and transaction size, an error skips the combination */
+    esp_err_t (*configure)(lcd_link_probe_t *probe, uint32_t pclk_hz, uint32_t chunk_bytes);
+    /* Send `len` bytes of `tx` and store what arrived in `rx` */
+    esp_err_t (*transfer)(lcd_link_probe_t *probe, const uint8_t *tx, uint8_t *rx, size_t len);
+    void *user_ctx;
+};
+
+/**
+ * @brief Selected link settings
+ */
+typedef struct {
+    uint32_t pclk_hz;
+    uint32_t chunk_bytes;
+    uint16_t tried;             /* Combinations tried, 0 when loaded from NVS */
+    bool from_nvs;
+} lcd_link_result_t;
+
+/**
+ * @brief Find the fastest combination that passes every round
+ *
+ * Clocks are tried fastest first and, per clock, chunk sizes largest first; the first
+ * combination whose transfers all come back intact is selected. Each round sends a
+ * different pseudo-random pattern of `chunk_bytes`.
+ *
+ * @param probe  Link under test
+ * @param ladder Candidates
+ * @param tx     Pattern buffer of at least the largest chunk
+ * @param rx     Receive buffer of at least the largest chunk
+ * @param result Selected settings, the slowest and smallest candidate if none passed
+ * @return ESP_OK if a combination passed, ESP_ERR_NOT_FOUND if none did
+ */
+esp_err_t lcd_link_tune(lcd_link_probe_t *probe, const lcd_link_ladder_t *ladder, uint8_t *tx, uint8_t *rx,
+                        lcd_link_result_t *result);
+
+/**
+ * @brief Hash of the ladder, a stored result is only reused for the same candidates
+ */
+uint32_t lcd_link_ladder_hash(const lcd_link_ladder_t *ladder);
+
+#ifdef ESP_PLATFORM
+/**
+ * @brief SPI loopback probe configuration
+ *
+ * The panel has no read line on this board. The probe reads the MOSI pad back into the
+ * SPI input through the GPIO matrix while no CS is asserted.
+ *
+ * This is an ESP-side sanity check, not link tuning: the loopback stays inside the chip, so
+ * it covers the SPI clock, the DMA feed (including PSRAM pattern buffers) and the GPIO
+ * matrix, not the pad, the trace, the connector or how the panel samples. A passing clock
+ * can still be too fast for the panel, keep the ladder within the panel's rated clock.
+ * SCLK and MOSI toggle on the panel pins with CS and DC not driven, so run it before the
+ * panel is reset and initialized.
+ */
+typedef struct {
+    spi_host_device_t host;
+    int sclk_io_num;
+    int mosi_io_num;
+    uint32_t max_chunk;         /* Largest chunk of the ladder */
+} lcd_link_spi_cfg_t;
+
+/**
+ * @brief Initialize the SPI bus for the loopback probe, the bus must not be in use yet
+ */
+esp_err_t lcd_link_new_spi_probe(const lcd_link_spi_cfg_t *cfg, lcd_link_probe_t **probe);
+
+/**
+ * @brief Free the probe and the SPI bus, and undo the loopback routing
+ */
+void lcd_link_del_spi_probe(lcd_link_probe_t *probe);
+
+/**
+ * @brief Load a result stored for the same ladder
+ *
+ * @return ESP_OK if found, ESP_ERR_NOT_FOUND if missing or stored for another ladder
+ */
+esp_err_t lcd_link_load(const lcd_link_ladder_t *ladder, lcd_link_result_t *result);
+
+/**
+ * @brief Store a result for the next boots, NVS must be initialized
+ */
+esp_err_t lcd_link_save(const lcd_link_ladder_t *ladder, const lcd_link_result_t *result);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,53 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "esp_log.h"
+#include "lcd_native.h"
+#include "src/display/lv_display_private.h"
+
+#define LCD_NATIVE_MAX_DISPLAYS     (2)
+
+typedef struct {
+    lv_display_t *disp;
+    lv_display_flush_cb_t flush_cb;     /* Port flush callback wrapped by the swap fallback */
+} lcd_native_ctx_t;
+
+static const char *TAG = "lcd_native";
+
+static lcd_native_ctx_t native_ctx[LCD_NATIVE_MAX_DISPLAYS];
+
+static void lcd_native_swap_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    for (int i = 0; i < LCD_NATIVE_MAX_DISPLAYS; i++) {
+        if (native_ctx[i].disp == disp) {
+            lv_draw_sw_rgb565_swap(px_map, lv_area_get_size(area));
+            native_ctx[i].flush_cb(disp, area, px_map);
+            return;
+        }
+    }
+}
+
+bool lcd_native_attach(lv_display_t *disp)
+{
+#if LV_DRAW_SW_SUPPORT_RGB565_SWAPPED
+    /* host/native_test.c checks the output matches the swap path */
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+    ESP_LOGI(TAG, "Rendering in panel byte order, no swap on flush");
+    return true;
+#else
+    ESP_LOGW(TAG, "LVGL built without RGB565_SWAPPED support");
+#endif
+
+    for (int i = 0; i < LCD_NATIVE_MAX_DISPLAYS; i++) {
+        if (native_ctx[i].disp == NULL) {
+            native_ctx[i].disp = disp;
+            native_ctx[i].flush_cb = disp->flush_cb;
+            lv_display_set_flush_cb(disp, lcd_native_swap_flush_cb);
+            ESP_LOGI(TAG, "Swapping bytes on flush");
+            return false;
+        }
+    }
+    ESP_LOGE(TAG, "No free context, display output will have swapped bytes");
+    return false;
+}
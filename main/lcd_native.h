@@ -0,0 +1,36 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include "esp_err.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Render a display directly in the panel's byte order
+ *
+ * The GC9D01 takes RGB565 big-endian. With LV_DRAW_SW_SUPPORT_RGB565_SWAPPED the
+ * software renderer writes LV_COLOR_FORMAT_RGB565_SWAPPED into the draw buffers,
+ * so the flush hands them to the panel untouched instead of swapping every pixel.
+ *
+ * The output is checked against the swap path on the host (host/native_test.c), not at
+ * boot. If LVGL lacks the format, the display stays RGB565 and its flush callback is
+ * wrapped with lv_draw_sw_rgb565_swap(), so the display must be added with
+ * `swap_bytes = false`.
+ *
+ * Must be called with the LVGL lock held.
+ *
+ * @param disp LVGL display
+ * @return true if the display renders in panel byte order, false if it swaps on flush
+ */
+bool lcd_native_attach(lv_display_t *disp);
+
+#ifdef __cplusplus
+}
+#endif
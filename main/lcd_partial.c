@@ -0,0 +1,145 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "lcd_partial.h"
+#include "src/display/lv_display_private.h"
+
+#define LCD_PARTIAL_MAX_DISPLAYS    (2)
+
+typedef struct {
+    lv_display_t *disp;
+    lcd_partial_cfg_t cfg;
+    uint32_t cur_windows;
+    uint32_t cur_bytes;
+    lcd_partial_stats_t stats;
+} lcd_partial_ctx_t;
+
+static const char *TAG = "lcd_partial";
+
+static lcd_partial_ctx_t partial_ctx[LCD_PARTIAL_MAX_DISPLAYS];
+
+static lcd_partial_ctx_t *lcd_partial_find(lv_display_t *disp)
+{
+    for (int i = 0; i < LCD_PARTIAL_MAX_DISPLAYS; i++) {
+        if (partial_ctx[i].disp == disp) {
+            return &partial_ctx[i];
+        }
+    }
+    return NULL;
+}
+
+static void lcd_partial_align(lcd_partial_ctx_t *ctx, lv_area_t *area)
+{
+    const int32_t ax = ctx->cfg.align_x;
+    const int32_t ay = ctx->cfg.align_y;
+    const int32_t hres = lv_display_get_horizontal_resolution(ctx->disp);
+    const int32_t vres = lv_display_get_vertical_resolution(ctx->disp);
+
+    area->x1 = (area->x1 / ax) * ax;
+    area->y1 = (area->y1 / ay) * ay;
+    area->x2 = (area->x2 / ax + 1) * ax - 1;
+    area->y2 = (area->y2 / ay + 1) * ay - 1;
+
+    /* Areas reaching past the screen edge, the resolution is a multiple of the grid (lcd_partial_attach) */
+    if (area->x2 >= hres) {
+        area->x2 = hres - 1;
+    }
+    if (area->y2 >= vres) {
+        area->y2 = vres - 1;
+    }
+}
+
+static void lcd_partial_invalidate_cb(lv_event_t *e)
+{
+    lcd_partial_ctx_t *ctx = lv_event_get_user_data(e);
+    lv_display_t *disp = ctx->disp;
+    lv_area_t *area = lv_event_get_param(e);
+
+    lcd_partial_align(ctx, area);
+
+    /* While rendering, LVGL only asks how a band of the draw buffer rounds, the saved areas are in use */
+    if (disp->rendering_in_progress) {
+        return;
+    }
+
+    /* Fold the new area into a pending window when the extra pixels are cheaper than another window */
+    for (uint32_t i = 0; i < disp->inv_p; i++) {
+        lv_area_t *inv = &disp->inv_areas[i];
+        lv_area_t joined;
+
+        lv_area_join(&joined, inv, area);
+        int64_t waste = (int64_t)lv_area_get_size(&joined) - lv_area_get_size(inv) - lv_area_get_size(area);
+        if (waste <= (int64_t)ctx->cfg.window_cost_px) {
+            /* LVGL drops areas that lie inside an already saved one */
+            lv_area_copy(inv, &joined);
+            lv_area_copy(area, &joined);
+            ctx->stats.merged++;
+            return;
+        }
+    }
+}
+
+static void lcd_partial_flush_start_cb(lv_event_t *e)
+{
+    lcd_partial_ctx_t *ctx = lv_event_get_user_data(e);
+    const lv_area_t *area = lv_event_get_param(e);
+    const uint32_t px_size = lv_color_format_get_size(lv_display_get_color_format(ctx->disp));
+
+    ctx->cur_windows++;
+    ctx->cur_bytes += lv_area_get_size(area) * px_size;
+}
+
+static void lcd_partial_refr_ready_cb(lv_event_t *e)
+{
+    lcd_partial_ctx_t *ctx = lv_event_get_user_data(e);
+
+    if (ctx->cur_windows == 0) {
+        return;
+    }
+    ctx->stats.frames++;
+    ctx->stats.windows = ctx->cur_windows;
+    ctx->stats.bytes = ctx->cur_bytes;
+    ctx->stats.total_bytes += ctx->cur_bytes;
+    ctx->cur_windows = 0;
+    ctx->cur_bytes = 0;
+}
+
+esp_err_t lcd_partial_attach(lv_display_t *disp, const lcd_partial_cfg_t *cfg)
+{
+    ESP_RETURN_ON_FALSE(disp && cfg, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(cfg->align_x && cfg->align_y, ESP_ERR_INVALID_ARG, TAG, "alignment must be non-zero");
+    ESP_RETURN_ON_FALSE(lv_display_get_horizontal_resolution(disp) % cfg->align_x == 0 &&
+                        lv_display_get_vertical_resolution(disp) % cfg->align_y == 0, ESP_ERR_INVALID_ARG, TAG,
+                        "resolution must be a multiple of the window grid");
+    ESP_RETURN_ON_FALSE(lv_display_get_render_mode(disp) == LV_DISPLAY_RENDER_MODE_PARTIAL, ESP_ERR_INVALID_STATE, TAG, "display is not in partial render mode");
+    ESP_RETURN_ON_FALSE(lcd_partial_find(disp) == NULL, ESP_ERR_INVALID_STATE, TAG, "already attached");
+
+    lcd_partial_ctx_t *ctx = lcd_partial_find(NULL);
+    ESP_RETURN_ON_FALSE(ctx, ESP_ERR_NO_MEM, TAG, "no free partial refresh slot");
+
+    memset(ctx, 0, sizeof(lcd_partial_ctx_t));
+    ctx->disp = disp;
+    ctx->cfg = *cfg;
+
+    lv_display_add_event_cb(disp, lcd_partial_invalidate_cb, LV_EVENT_INVALIDATE_AREA, ctx);
+    lv_display_add_event_cb(disp, lcd_partial_flush_start_cb, LV_EVENT_FLUSH_START, ctx);
+    lv_display_add_event_cb(disp, lcd_partial_refr_ready_cb, LV_EVENT_REFR_READY, ctx);
+
+    ESP_LOGI(TAG, "Partial refresh on, window grid %ux%u", cfg->align_x, cfg->align_y);
+    return ESP_OK;
+}
+
+esp_err_t lcd_partial_get_stats(lv_display_t *disp, lcd_partial_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(disp && stats, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    lcd_partial_ctx_t *ctx = lcd_partial_find(disp);
+    ESP_RETURN_ON_FALSE(ctx, ESP_ERR_INVALID_STATE, TAG, "not attached");
+
+    *stats = ctx->stats;
+    return ESP_OK;
+}
@@ -0,0 +1,58 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Partial refresh configuration
+ *
+ * The GC9D01 shows random dots when a CASET/RASET window does not start and end
+ * on the granularity it expects, so every invalidated area is widened to that grid.
+ */
+typedef struct {
+    uint8_t align_x;            /* CASET column granularity in pixels */
+    uint8_t align_y;            /* RASET row granularity in pixels */
+    uint32_t window_cost_px;    /* Per-window overhead (commands + transaction setup) expressed in pixels */
+} lcd_partial_cfg_t;
+
+/**
+ * @brief Partial refresh statistics, updated at the end of every refresh
+ */
+typedef struct {
+    uint32_t frames;            /* Refresh cycles that flushed at least one window */
+    uint32_t windows;           /* Windows sent in the last frame */
+    uint32_t bytes;             /* Pixel bytes sent in the last frame */
+    uint64_t total_bytes;       /* Pixel bytes sent since attach */
+    uint32_t merged;            /* Invalidated areas folded into a pending window since attach */
+} lcd_partial_stats_t;
+
+/**
+ * @brief Attach the partial refresh rounder/coalescer to a display
+ *
+ * The display must be created in partial render mode (`full_refresh = false`), and its
+ * resolution must be a multiple of `align_x` / `align_y`, otherwise the last column or row
+ * could not start a window on the grid.
+ *
+ * @param disp LVGL display
+ * @param cfg  Alignment and coalescing settings
+ * @return ESP_OK on success
+ */
+esp_err_t lcd_partial_attach(lv_display_t *disp, const lcd_partial_cfg_t *cfg);
+
+/**
+ * @brief Get a copy of the partial refresh statistics
+ */
+esp_err_t lcd_partial_get_stats(lv_display_t *disp, lcd_partial_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
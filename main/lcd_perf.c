@@ -0,0 +1,302 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "lcd_perf.h"
+
+#ifdef ESP_PLATFORM
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+
+static portMUX_TYPE perf_lock = portMUX_INITIALIZER_UNLOCKED;
+#define LCD_PERF_LOCK()     portENTER_CRITICAL_SAFE(&perf_lock)
+#define LCD_PERF_UNLOCK()   portEXIT_CRITICAL_SAFE(&perf_lock)
+#define LCD_PERF_NOW_US()   esp_timer_get_time()
+#else
+#include <pthread.h>
+#include <time.h>
+
+/* LVGL's events and lcd_pipe's transfer thread both produce, as the LVGL task and the ISR do */
+static pthread_mutex_t perf_lock = PTHREAD_MUTEX_INITIALIZER;
+#define LCD_PERF_LOCK()     pthread_mutex_lock(&perf_lock)
+#define LCD_PERF_UNLOCK()   pthread_mutex_unlock(&perf_lock)
+
+static int64_t lcd_perf_host_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+#define LCD_PERF_NOW_US()   lcd_perf_host_now_us()
+#endif
+
+/* A frame that is still being rendered or whose flushes are still on the bus */
+typedef struct {
+    lcd_perf_frame_t f;
+    uint16_t pending;
+    bool used;
+} lcd_perf_open_t;
+
+typedef struct {
+    lv_display_t *disp;
+    lcd_perf_open_t rendering;
+    lcd_perf_open_t draining;
+    lcd_perf_frame_t ring[LCD_PERF_RING_SIZE];
+    atomic_uint head;           /* Frames committed since attach */
+    atomic_uint seq;            /* Seqlock of the ring, odd while a frame is written into it */
+} lcd_perf_ctx_t;
+
+static const char *TAG = "lcd_perf";
+
+static lcd_perf_ctx_t perf_ctx;
+
+/*
+ * Called with the lock held. The lock only keeps the producers (LVGL events and the
+ * transfer-done ISR) apart, readers go by the sequence count and never block them.
+ */
+static void lcd_perf_commit(lcd_perf_open_t *open)
+{
+    const unsigned int head = atomic_load_explicit(&perf_ctx.head, memory_order_relaxed);
+    const unsigned int seq = atomic_load_explicit(&perf_ctx.seq, memory_order_relaxed);
+
+    atomic_store_explicit(&perf_ctx.seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    perf_ctx.ring[head % LCD_PERF_RING_SIZE] = open->f;
+    atomic_store_explicit(&perf_ctx.head, head + 1, memory_order_relaxed);
+    atomic_store_explicit(&perf_ctx.seq, seq + 2, memory_order_release);
+    memset(open, 0, sizeof(lcd_perf_open_t));
+}
+
+static void lcd_perf_render_start_cb(lv_event_t *e)
+{
+    int64_t now = LCD_PERF_NOW_US();
+
+    LCD_PERF_LOCK();
+    if (perf_ctx.rendering.used) {
+        lcd_perf_commit(&perf_ctx.rendering);
+    }
+    perf_ctx.rendering.used = true;
+    perf_ctx.rendering.f.render_start = now;
+    LCD_PERF_UNLOCK();
+}
+
+static void lcd_perf_flush_start_cb(lv_event_t *e)
+{
+    const lv_area_t *area = lv_event_get_param(e);
+    const uint32_t px_size = lv_color_format_get_size(lv_display_get_color_format(perf_ctx.disp));
+    int64_t now = LCD_PERF_NOW_US();
+    lcd_perf_open_t *open = &perf_ctx.rendering;
+
+    LCD_PERF_LOCK();
+    if (!open->used) {
+        open->used = true;
+        open->f.render_start = now;
+    }
+    if (open->f.flushes == 0) {
+        open->f.flush_start = now;
+    }
+    open->f.flushes++;
+    open->f.bytes += lv_area_get_size(area) * px_size;
+    open->pending++;
+    LCD_PERF_UNLOCK();
+}
+
+static void lcd_perf_render_ready_cb(lv_event_t *e)
+{
+    int64_t now = LCD_PERF_NOW_US();
+    lcd_perf_open_t *open = &perf_ctx.rendering;
+
+    LCD_PERF_LOCK();
+    if (open->used) {
+        open->f.render_end = now;
+        if (open->pending == 0) {
+            lcd_perf_commit(open);
+        } else {
+            /* Flushes of the previous frame are done in order, so at most one frame drains */
+            if (perf_ctx.draining.used) {
+                lcd_perf_commit(&perf_ctx.draining);
+            }
+            perf_ctx.draining = *open;
+            memset(open, 0, sizeof(lcd_perf_open_t));
+        }
+    }
+    LCD_PERF_UNLOCK();
+}
+
+void lcd_perf_flush_done(lv_display_t *disp)
+{
+    if (disp != perf_ctx.disp) {
+        return;
+    }
+    int64_t now = LCD_PERF_NOW_US();
+
+    LCD_PERF_LOCK();
+    lcd_perf_open_t *open = NULL;
+    if (perf_ctx.draining.used && perf_ctx.draining.pending) {
+        open = &perf_ctx.draining;
+    } else if (perf_ctx.rendering.used && perf_ctx.rendering.pending) {
+        open = &perf_ctx.rendering;
+    }
+    if (open) {
+        open->pending--;
+        open->f.dma_done = now;
+        if (open == &perf_ctx.draining && open->pending == 0) {
+            lcd_perf_commit(open);
+        }
+    }
+    LCD_PERF_UNLOCK();
+}
+
+esp_err_t lcd_perf_attach(lv_display_t *disp)
+{
+    ESP_RETURN_ON_FALSE(disp, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(perf_ctx.disp == NULL, ESP_ERR_INVALID_STATE, TAG, "already attached");
+
+    perf_ctx.disp = disp;
+    lv_display_add_event_cb(disp, lcd_perf_render_start_cb, LV_EVENT_RENDER_START, NULL);
+    lv_display_add_event_cb(disp, lcd_perf_flush_start_cb, LV_EVENT_FLUSH_START, NULL);
+    lv_display_add_event_cb(disp, lcd_perf_render_ready_cb, LV_EVENT_RENDER_READY, NULL);
+    return ESP_OK;
+}
+
+#ifdef ESP_PLATFORM
+static bool lcd_perf_color_done_cb(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+{
+    lv_display_t *disp = (lv_display_t *)user_ctx;
+
+    lcd_perf_flush_done(disp);
+    lv_display_flush_ready(disp);
+    return false;
+}
+
+esp_err_t lcd_perf_attach_io(lv_display_t *disp, esp_lcd_panel_io_handle_t io)
+{
+    ESP_RETURN_ON_FALSE(io, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_ERROR(lcd_perf_attach(disp), TAG, "attach failed");
+
+    const esp_lcd_panel_io_callbacks_t cbs = {
+        .on_color_trans_done = lcd_perf_color_done_cb,
+    };
+    return esp_lcd_panel_io_register_event_callbacks(io, &cbs, disp);
+}
+#endif
+
+uint32_t lcd_perf_get_frames(lcd_perf_frame_t *frames, uint32_t max)
+{
+    unsigned int seq;
+    uint32_t n;
+
+    /* A copy that raced with a commit may hold a half written frame, it is taken again */
+    do {
+        seq = atomic_load_explicit(&perf_ctx.seq, memory_order_acquire);
+        const unsigned int head = atomic_load_explicit(&perf_ctx.head, memory_order_relaxed);
+        n = LV_MIN(LV_MIN(head, LCD_PERF_RING_SIZE), max);
+        for (uint32_t i = 0; i < n; i++) {
+            frames[i] = perf_ctx.ring[(head - n + i) % LCD_PERF_RING_SIZE];
+        }
+        atomic_thread_fence(memory_order_acquire);
+    } while ((seq & 1) || atomic_load_explicit(&perf_ctx.seq, memory_order_relaxed) != seq);
+    return n;
+}
+
+static int lcd_perf_cmp_u32(const void *a, const void *b)
+{
+    uint32_t va = *(const uint32_t *)a;
+    uint32_t vb = *(const uint32_t *)b;
+    return (va > vb) - (va < vb);
+}
+
+static void lcd_perf_percentiles(uint32_t *v, uint32_t n, lcd_perf_pct_t *pct)
+{
+    memset(pct, 0, sizeof(lcd_perf_pct_t));
+    if (n == 0) {
+        return;
+    }
+    qsort(v, n, sizeof(uint32_t), lcd_perf_cmp_u32);
+    pct->p50 = v[(n - 1) * 50 / 100];
+    pct->p95 = v[(n - 1) * 95 / 100];
+    pct->p99 = v[(n - 1) * 99 / 100];
+}
+
+esp_err_t lcd_perf_get_summary(lcd_perf_summary_t *summary)
+{
+    ESP_RETURN_ON_FALSE(summary, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    memset(summary, 0, sizeof(lcd_perf_summary_t));
+
+    lcd_perf_frame_t *frames = malloc(sizeof(lcd_perf_frame_t) * LCD_PERF_RING_SIZE);
+    uint32_t *v = malloc(sizeof(uint32_t) * LCD_PERF_RING_SIZE);
+    if (!frames || !v) {
+        free(frames);
+        free(v);
+        return ESP_ERR_NO_MEM;
+    }
+
+    uint32_t n = lcd_perf_get_frames(frames, LCD_PERF_RING_SIZE);
+    summary->frames = n;
+
+    uint64_t bytes = 0;
+    uint64_t rendered_bytes = 0;
+    uint64_t render_us = 0;
+    uint32_t cnt = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        bytes += frames[i].bytes;
+        if (frames[i].render_end) {
+            v[cnt++] = (uint32_t)(frames[i].render_end - frames[i].render_start);
+            rendered_bytes += frames[i].bytes;
+            render_us += v[cnt - 1];
+        }
+    }
+    lcd_perf_percentiles(v, cnt, &summary->render);
+    if (render_us) {
+        summary->render_bytes_ms = (uint32_t)(rendered_bytes * 1000 / render_us);
+    }
+
+    cnt = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        if (frames[i].dma_done && frames[i].flushes) {
+            v[cnt++] = (uint32_t)(frames[i].dma_done - frames[i].flush_start);
+        }
+    }
+    lcd_perf_percentiles(v, cnt, &summary->flush);
+
+    cnt = 0;
+    for (uint32_t i = 0; i + 1 < n; i++) {
+        if (frames[i].dma_done && frames[i + 1].render_start > frames[i].dma_done) {
+            v[cnt++] = (uint32_t)(frames[i + 1].render_start - frames[i].dma_done);
+        }
+    }
+    lcd_perf_percentiles(v, cnt, &summary->idle);
+
+    if (n > 1 && frames[n - 1].render_start > frames[0].render_start) {
+        summary->fps_x10 = (uint32_t)((uint64_t)(n - 1) * 10000000ULL / (frames[n - 1].render_start - frames[0].render_start));
+    }
+    if (n) {
+        summary->bytes_avg = (uint32_t)(bytes / n);
+    }
+
+    free(frames);
+    free(v);
+    return ESP_OK;
+}
+
+void lcd_perf_dump(void)
+{
+    lcd_perf_summary_t s;
+
+    if (lcd_perf_get_summary(&s) != ESP_OK) {
+        return;
+    }
+    ESP_LOGI(TAG, "%"PRIu32" frames, %"PRIu32".%"PRIu32" FPS, %"PRIu32" B/frame",
+             s.frames, s.fps_x10 / 10, s.fps_x10 % 10, s.bytes_avg);
+    ESP_LOGI(TAG, "render us p50/p95/p99: %"PRIu32"/%"PRIu32"/%"PRIu32", %"PRIu64" B/s of render time",
+             s.render.p50, s.render.p95, s.render.p99, (uint64_t)s.render_bytes_ms * 1000);
+    ESP_LOGI(TAG, "flush  us p50/p95/p99: %"PRIu32"/%"PRIu32"/%"PRIu32, s.flush.p50, s.flush.p95, s.flush.p99);
+    ESP_LOGI(TAG, "idle   us p50/p95/p99: %"PRIu32"/%"PRIu32"/%"PRIu32, s.idle.p50, s.idle.p95, s.idle.p99);
+}
@@ -0,0 +1,104 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "lvgl.h"
+#ifdef ESP_PLATFORM
+#include "esp_lcd_panel_io.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LCD_PERF_RING_SIZE  (128)   /* Frames kept for the percentile statistics */
+
+/**
+ * @brief Timestamps of one frame, in microseconds
+ */
+typedef struct {
+    int64_t render_start;       /* LV_EVENT_RENDER_START */
+    int64_t render_end;         /* LV_EVENT_RENDER_READY */
+    int64_t flush_start;        /* First flush of the frame */
+    int64_t dma_done;           /* Last flush of the frame left the SPI bus, 0 if not measured */
+    uint32_t bytes;             /* Pixel bytes flushed */
+    uint16_t flushes;           /* Flush calls (windows or bands) of the frame */
+} lcd_perf_frame_t;
+
+/**
+ * @brief Percentiles of one timing, in microseconds
+ */
+typedef struct {
+    uint32_t p50;
+    uint32_t p95;
+    uint32_t p99;
+} lcd_perf_pct_t;
+
+/**
+ * @brief Summary over the frames currently held in the ring buffer
+ */
+typedef struct {
+    uint32_t frames;            /* Frames in the summary */
+    uint32_t fps_x10;           /* Frames per second * 10, from the frame start interval */
+    lcd_perf_pct_t render;      /* render_end - render_start */
+    lcd_perf_pct_t flush;       /* dma_done - flush_start */
+    lcd_perf_pct_t idle;        /* next render_start - dma_done */
+    uint32_t bytes_avg;         /* Average pixel bytes per frame */
+    uint32_t render_bytes_ms;   /* Pixel bytes flushed per ms of render time, compares buffer placements */
+} lcd_perf_summary_t;
+
+/**
+ * @brief Start recording frame timing of a display
+ *
+ * Flush completion has to be reported with lcd_perf_flush_done(), e.g. from a simulated
+ * flush on the host. Frames without it have `dma_done` left at 0.
+ *
+ * @param disp LVGL display
+ * @return ESP_OK on success
+ */
+esp_err_t lcd_perf_attach(lv_display_t *disp);
+
+#ifdef ESP_PLATFORM
+/**
+ * @brief Time the SPI DMA of a display through its panel IO
+ *
+ * Takes over the transfer-done callback of the panel IO to record DMA completion and release
+ * the buffer, the same way the LVGL port does. Do not use it when another module owns that
+ * callback (e.g. the dual panel scheduler).
+ */
+esp_err_t lcd_perf_attach_io(lv_display_t *disp, esp_lcd_panel_io_handle_t io);
+#endif
+
+/**
+ * @brief Record the end of a flush, safe to call from ISR
+ */
+void lcd_perf_flush_done(lv_display_t *disp);
+
+/**
+ * @brief Copy the most recent frames, newest last
+ *
+ * Lock-free for the reader: the ring is a seqlock, a copy overlapping a commit is retried,
+ * so the producers (LVGL events, the transfer-done ISR) never wait for it. They share a
+ * spinlock among themselves for the frames still open. Any task may call it.
+ *
+ * @return Number of frames copied
+ */
+uint32_t lcd_perf_get_frames(lcd_perf_frame_t *frames, uint32_t max);
+
+/**
+ * @brief Compute percentiles and FPS over the frames in the ring buffer
+ */
+esp_err_t lcd_perf_get_summary(lcd_perf_summary_t *summary);
+
+/**
+ * @brief Print the summary to the console
+ */
+void lcd_perf_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,328 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <inttypes.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "lcd_pipe.h"
+#include "lcd_perf.h"
+#include "src/display/lv_display_private.h"
+
+typedef struct {
+    lv_draw_buf_t *buf;
+    lv_area_t area;
+    bool last;                  /* Last flush of a frame */
+} lcd_pipe_job_t;
+
+typedef struct {
+    esp_lcd_panel_handle_t panel;
+    lv_display_t *disp;
+    QueueHandle_t free_q;       /* Buffers LVGL may render into next */
+    QueueHandle_t job_q;        /* Rendered buffers waiting for the bus */
+    TaskHandle_t task;
+    lv_draw_buf_t *inflight;    /* Buffer on the wire, released by the transfer-done ISR */
+    uint8_t runs_left;          /* Windows of the inflight buffer still on the wire */
+    bool inflight_last;         /* The inflight buffer ends a frame */
+    void (*on_frame_sent)(lv_display_t *disp, void *user_ctx);
+    void *user_ctx;
+    lcd_dedup_t *dedup;         /* Unchanged band filter, NULL when off */
+    lcd_diff_t *diff;           /* Changed tile diff, NULL when off */
+    uint8_t px_size;
+    lv_draw_buf_t bufs[LCD_PIPE_MAX_BUFS];  /* The pool, each with its own descriptor */
+    uint8_t *extra[LCD_PIPE_MAX_BUFS];      /* Memory of the pool's buffers the display did not bring */
+    portMUX_TYPE lock;
+    bool swap_bytes;
+    bool drop_stale;
+    bool panel_stale;           /* Something else wrote the panel, the filters forget what it shows */
+    uint8_t depth;              /* Buffers queued or in flight */
+    lcd_pipe_stats_t stats;
+} lcd_pipe_ctx_t;
+
+static const char *TAG = "lcd_pipe";
+
+static lcd_pipe_ctx_t pipe_ctx = {
+    .lock = portMUX_INITIALIZER_UNLOCKED,
+};
+
+bool lcd_pipe_color_done_cb(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+{
+    BaseType_t need_yield = pdFALSE;
+
+    /* Nothing of ours on the wire; with a foreign transfer queued behind our runs it could not tell them apart */
+    if (!pipe_ctx.inflight) {
+        return false;
+    }
+    /* A buffer split into several windows goes back to the pool after the last one */
+    if (--pipe_ctx.runs_left) {
+        return false;
+    }
+    lcd_perf_flush_done(pipe_ctx.disp);
+    if (pipe_ctx.inflight_last && pipe_ctx.on_frame_sent) {
+        pipe_ctx.on_frame_sent(pipe_ctx.disp, pipe_ctx.user_ctx);
+    }
+
+    portENTER_CRITICAL_ISR(&pipe_ctx.lock);
+    pipe_ctx.depth--;
+    pipe_ctx.stats.sent++;
+    portEXIT_CRITICAL_ISR(&pipe_ctx.lock);
+
+    xQueueSendFromISR(pipe_ctx.free_q, &pipe_ctx.inflight, &need_yield);
+    pipe_ctx.inflight = NULL;
+    vTaskNotifyGiveFromISR(pipe_ctx.task, &need_yield);
+    return (need_yield == pdTRUE);
+}
+
+static void lcd_pipe_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    const lcd_pipe_job_t job = {
+        .buf = lv_display_get_buf_active(disp),
+        .area = *area,
+        .last = lv_display_flush_is_last(disp),
+    };
+    lcd_pipe_job_t stale;
+    lv_draw_buf_t *next;
+
+    if (pipe_ctx.swap_bytes) {
+        lv_draw_sw_rgb565_swap(px_map, lv_area_get_size(area));
+    }
+
+    /* A whole frame still waiting for the bus is superseded by this one */
+    if (pipe_ctx.drop_stale && xQueueReceive(pipe_ctx.job_q, &stale, 0) == pdTRUE) {
+        xQueueSend(pipe_ctx.free_q, &stale.buf, 0);
+        lcd_perf_flush_done(disp);
+        portENTER_CRITICAL(&pipe_ctx.lock);
+        pipe_ctx.depth--;
+        pipe_ctx.stats.dropped++;
+        portEXIT_CRITICAL(&pipe_ctx.lock);
+    }
+
+    portENTER_CRITICAL(&pipe_ctx.lock);
+    pipe_ctx.depth++;
+    pipe_ctx.stats.flushes++;
+    pipe_ctx.stats.max_depth = LV_MAX(pipe_ctx.stats.max_depth, pipe_ctx.depth);
+    portEXIT_CRITICAL(&pipe_ctx.lock);
+    xQueueSend(pipe_ctx.job_q, &job, portMAX_DELAY);
+
+    /* Backpressure: with every buffer queued or on the wire LVGL waits for the oldest one */
+    if (xQueueReceive(pipe_ctx.free_q, &next, 0) != pdTRUE) {
+        const int64_t start = esp_timer_get_time();
+        xQueueReceive(pipe_ctx.free_q, &next, portMAX_DELAY);
+        portENTER_CRITICAL(&pipe_ctx.lock);
+        pipe_ctx.stats.stalls++;
+        pipe_ctx.stats.stall_us += esp_timer_get_time() - start;
+        portEXIT_CRITICAL(&pipe_ctx.lock);
+    }
+
+    /* LVGL renders the next area into the free buffer, the queued one stays the pipeline's */
+    lv_display_set_draw_buffers(disp, next, NULL);
+    lv_display_flush_ready(disp);
+}
+
+static void lcd_pipe_task(void *arg)
+{
+    lcd_pipe_job_t job;
+
+    for (;;) {
+        xQueueReceive(pipe_ctx.job_q, &job, portMAX_DELAY);
+        uint8_t *px = job.buf->data;
+
+        portENTER_CRITICAL(&pipe_ctx.lock);
+        const bool stale = pipe_ctx.panel_stale;
+        pipe_ctx.panel_stale = false;
+        portEXIT_CRITICAL(&pipe_ctx.lock);
+        if (stale && pipe_ctx.dedup) {
+            lcd_dedup_invalidate(pipe_ctx.dedup);
+        } else if (stale && pipe_ctx.diff) {
+            lcd_diff_invalidate(pipe_ctx.diff);
+        }
+
+        /* Bands or tiles the panel already shows stay out, they are filtered in wire order */
+        const lcd_dedup_run_t whole = { job.area.y1, job.area.y2 };
+        const lcd_dedup_run_t *runs = &whole;
+        const lcd_diff_rect_t *rects = NULL;
+        int run_num = 1;
+        if (pipe_ctx.dedup) {
+            run_num = lcd_dedup_filter(pipe_ctx.dedup, &job.area, px, &runs);
+            portENTER_CRITICAL(&pipe_ctx.lock);
+            lcd_dedup_get_stats(pipe_ctx.dedup, &pipe_ctx.stats.dedup);
+            portEXIT_CRITICAL(&pipe_ctx.lock);
+        } else if (pipe_ctx.diff) {
+            run_num = lcd_diff_frame(pipe_ctx.diff, px, &rects);
+            portENTER_CRITICAL(&pipe_ctx.lock);
+            lcd_diff_get_stats(pipe_ctx.diff, &pipe_ctx.stats.diff);
+            portEXIT_CRITICAL(&pipe_ctx.lock);
+        }
+        if (run_num == 0) {
+            xQueueSend(pipe_ctx.free_q, &job.buf, 0);
+            lcd_perf_flush_done(pipe_ctx.disp);
+            if (job.last && pipe_ctx.on_frame_sent) {
+                pipe_ctx.on_frame_sent(pipe_ctx.disp, pipe_ctx.user_ctx);
+            }
+            portENTER_CRITICAL(&pipe_ctx.lock);
+            pipe_ctx.depth--;
+            portEXIT_CRITICAL(&pipe_ctx.lock);
+            continue;
+        }
+
+        const size_t line_bytes = (size_t)lv_area_get_width(&job.area) * pipe_ctx.px_size;
+        pipe_ctx.runs_left = run_num;
+        pipe_ctx.inflight_last = job.last;
+        pipe_ctx.inflight = job.buf;
+        for (int i = 0; i < run_num; i++) {
+            if (rects) {
+                const lv_area_t *a = &rects[i].area;
+                esp_lcd_panel_draw_bitmap(pipe_ctx.panel, a->x1, a->y1, a->x2 + 1, a->y2 + 1, rects[i].px);
+            } else {
+                esp_lcd_panel_draw_bitmap(pipe_ctx.panel, job.area.x1, runs[i].y1, job.area.x2 + 1, runs[i].y2 + 1,
+                                          px + (size_t)(runs[i].y1 - job.area.y1) * line_bytes);
+            }
+        }
+        /* One buffer at a time, which also keeps the diff's packed windows valid; the next job may still be dropped until it starts */
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+esp_err_t lcd_pipe_init(const lcd_pipe_cfg_t *cfg)
+{
+    esp_err_t ret = ESP_OK;
+
+    ESP_RETURN_ON_FALSE(cfg && cfg->io && cfg->panel && cfg->disp, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(cfg->buf_num >= 2 && cfg->buf_num <= LCD_PIPE_MAX_BUFS, ESP_ERR_INVALID_ARG, TAG, "buf_num must be 2..%d", LCD_PIPE_MAX_BUFS);
+    ESP_RETURN_ON_FALSE(pipe_ctx.task == NULL, ESP_ERR_INVALID_STATE, TAG, "already initialized");
+    ESP_RETURN_ON_FALSE(!cfg->dedup_rows || !cfg->diff_tile, ESP_ERR_INVALID_ARG, TAG, "band filter and tile diff are exclusive");
+
+    lv_display_t *disp = cfg->disp;
+    lv_draw_buf_t *buf1 = disp->buf_1;
+    lv_draw_buf_t *buf2 = disp->buf_2;
+    ESP_RETURN_ON_FALSE(buf1, ESP_ERR_INVALID_STATE, TAG, "display has no draw buffer");
+
+    pipe_ctx.panel = cfg->panel;
+    pipe_ctx.disp = disp;
+    pipe_ctx.swap_bytes = cfg->swap_bytes;
+    pipe_ctx.drop_stale = cfg->drop_stale;
+    pipe_ctx.on_frame_sent = cfg->on_frame_sent;
+    pipe_ctx.user_ctx = cfg->user_ctx;
+    pipe_ctx.px_size = lv_color_format_get_size(lv_display_get_color_format(disp));
+    if (pipe_ctx.drop_stale && disp->render_mode != LV_DISPLAY_RENDER_MODE_FULL) {
+        ESP_LOGW(TAG, "Dropping stale buffers needs full refresh, disabled");
+        pipe_ctx.drop_stale = false;
+    }
+
+    pipe_ctx.free_q = xQueueCreate(cfg->buf_num, sizeof(lv_draw_buf_t *));
+    pipe_ctx.job_q = xQueueCreate(cfg->buf_num, sizeof(lcd_pipe_job_t));
+    ESP_GOTO_ON_FALSE(pipe_ctx.free_q && pipe_ctx.job_q, ESP_ERR_NO_MEM, err, TAG, "create queues failed");
+
+    if (cfg->dedup_rows) {
+        const lcd_dedup_cfg_t dedup_cfg = {
+            .hres = lv_display_get_horizontal_resolution(disp),
+            .vres = lv_display_get_vertical_resolution(disp),
+            .band_rows = cfg->dedup_rows,
+            .px_size = pipe_ctx.px_size,
+        };
+        ESP_GOTO_ON_ERROR(lcd_dedup_new(&dedup_cfg, &pipe_ctx.dedup), err, TAG, "create band filter failed");
+    }
+    if (cfg->diff_tile && disp->render_mode != LV_DISPLAY_RENDER_MODE_FULL) {
+        ESP_LOGW(TAG, "Tile diff needs full refresh, disabled");
+    } else if (cfg->diff_tile) {
+        const lcd_diff_cfg_t diff_cfg = {
+            .hres = lv_display_get_horizontal_resolution(disp),
+            .vres = lv_display_get_vertical_resolution(disp),
+            .tile = cfg->diff_tile,
+            .max_rects = cfg->diff_max_rects,
+            .window_cost_px = cfg->diff_window_cost_px,
+            .buf_caps = cfg->buf_caps,
+        };
+        ESP_GOTO_ON_ERROR(lcd_diff_new(&diff_cfg, &pipe_ctx.diff), err, TAG, "create tile diff failed");
+    }
+
+    /*
+     * Every buffer of the pool gets its own descriptor, the display's buffers stay with their
+     * owner (the port frees them) and only lend their memory. LVGL renders into one buffer at
+     * a time, the others wait in free_q.
+     */
+    for (int i = 0; i < cfg->buf_num; i++) {
+        uint8_t *data = i == 0 ? buf1->data : (i == 1 && buf2) ? buf2->data : NULL;
+        if (!data) {
+            pipe_ctx.extra[i] = heap_caps_aligned_alloc(LV_DRAW_BUF_ALIGN, buf1->data_size, cfg->buf_caps);
+            ESP_GOTO_ON_FALSE(pipe_ctx.extra[i], ESP_ERR_NO_MEM, err, TAG, "no memory for pipeline buffer %d", i);
+            data = pipe_ctx.extra[i];
+        }
+        ESP_GOTO_ON_FALSE(lv_draw_buf_init(&pipe_ctx.bufs[i], buf1->header.w, buf1->header.h, buf1->header.cf,
+                                           buf1->header.stride, data, buf1->data_size) == LV_RESULT_OK,
+                          ESP_ERR_INVALID_STATE, err, TAG, "pipeline buffer %d does not fit the display", i);
+        if (i) {
+            lv_draw_buf_t *free_buf = &pipe_ctx.bufs[i];
+            xQueueSend(pipe_ctx.free_q, &free_buf, 0);
+        }
+    }
+
+    BaseType_t res;
+    if (cfg->task_affinity < 0) {
+        res = xTaskCreate(lcd_pipe_task, "lcd_pipe", cfg->task_stack, NULL, cfg->task_priority, &pipe_ctx.task);
+    } else {
+        res = xTaskCreatePinnedToCore(lcd_pipe_task, "lcd_pipe", cfg->task_stack, NULL, cfg->task_priority, &pipe_ctx.task, cfg->task_affinity);
+    }
+    ESP_GOTO_ON_FALSE(res == pdPASS, ESP_ERR_NO_MEM, err, TAG, "create transfer task failed");
+
+    /* Replace the port's transfer-done callback, the pipeline recycles the buffers now */
+    const esp_lcd_panel_io_callbacks_t cbs = {
+        .on_color_trans_done = lcd_pipe_color_done_cb,
+    };
+    ESP_GOTO_ON_ERROR(esp_lcd_panel_io_register_event_callbacks(cfg->io, &cbs, NULL), err, TAG, "register IO callback failed");
+    lv_display_set_draw_buffers(disp, &pipe_ctx.bufs[0], NULL);
+    lv_display_set_flush_cb(disp, lcd_pipe_flush_cb);
+
+    ESP_LOGI(TAG, "Render-ahead pipeline started (%d x %"PRIu32" bytes%s%s)", cfg->buf_num, buf1->data_size,
+             pipe_ctx.drop_stale ? ", dropping stale frames" : "", pipe_ctx.dedup ? ", skipping unchanged bands" :
+             pipe_ctx.diff ? ", sending changed tiles" : "");
+    return ESP_OK;
+
+err:
+    if (pipe_ctx.task) {
+        vTaskDelete(pipe_ctx.task);
+        pipe_ctx.task = NULL;
+    }
+    for (int i = 0; i < LCD_PIPE_MAX_BUFS; i++) {
+        heap_caps_free(pipe_ctx.extra[i]);
+        pipe_ctx.extra[i] = NULL;
+    }
+    lcd_dedup_del(pipe_ctx.dedup);
+    pipe_ctx.dedup = NULL;
+    lcd_diff_del(pipe_ctx.diff);
+    pipe_ctx.diff = NULL;
+    if (pipe_ctx.free_q) {
+        vQueueDelete(pipe_ctx.free_q);
+        pipe_ctx.free_q = NULL;
+    }
+    if (pipe_ctx.job_q) {
+        vQueueDelete(pipe_ctx.job_q);
+        pipe_ctx.job_q = NULL;
+    }
+    return ret;
+}
+
+void lcd_pipe_invalidate(void)
+{
+    portENTER_CRITICAL(&pipe_ctx.lock);
+    pipe_ctx.panel_stale = true;
+    portEXIT_CRITICAL(&pipe_ctx.lock);
+}
+
+esp_err_t lcd_pipe_get_stats(lcd_pipe_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(stats, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(pipe_ctx.task, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+
+    portENTER_CRITICAL(&pipe_ctx.lock);
+    *stats = pipe_ctx.stats;
+    stats->depth = pipe_ctx.depth;
+    portEXIT_CRITICAL(&pipe_ctx.lock);
+    return ESP_OK;
+}
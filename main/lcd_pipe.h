@@ -0,0 +1,114 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+#include "lvgl.h"
+#include "lcd_dedup.h"
+#include "lcd_diff.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LCD_PIPE_MAX_BUFS   (3)
+
+/**
+ * @brief Render-ahead flush pipeline configuration
+ *
+ * The pipeline owns a pool of `buf_num` draw buffers, each with its own lv_draw_buf_t:
+ * the memory of the display's buffer(s) plus extra ones allocated with `buf_caps`. The
+ * display's own descriptors are left as they are, it renders into the pool's. On flush the rendered buffer is queued to a
+ * transfer task and the display gets a free buffer from the pool right away, so LVGL
+ * renders the next area while the previous ones are on the wire. Only when every
+ * buffer is queued or in flight does the flush block (backpressure).
+ *
+ * With `drop_stale` in full refresh mode a frame still waiting in the queue when a
+ * newer one arrives is dropped instead, the panel always gets the latest frame.
+ *
+ * With `dedup_rows` the transfer task hashes every full-width band of that many rows and
+ * leaves bands the panel already shows out of the transfer (lcd_dedup.h). This pays off in
+ * full refresh mode, where a frame that did not change is otherwise sent whole.
+ *
+ * With `diff_tile`, full refresh only, every frame is instead compared with the previous
+ * one in tiles of that size and only the windows around the changed tiles are sent
+ * (lcd_diff.h), partial refresh bandwidth without LVGL's partial mode.
+ */
+typedef struct {
+    esp_lcd_panel_io_handle_t io;
+    esp_lcd_panel_handle_t panel;
+    lv_display_t *disp;
+    uint8_t buf_num;            /* Buffers in the pool, 2..LCD_PIPE_MAX_BUFS */
+    uint32_t buf_caps;          /* Heap capabilities of the extra buffers */
+    bool drop_stale;            /* Replace queued frames not yet on the wire, full refresh only */
+    bool swap_bytes;            /* Swap RGB565 bytes before queueing, replaces the port's swap */
+    uint16_t dedup_rows;        /* Band height of the unchanged band filter, 0 is off */
+    uint8_t diff_tile;          /* Tile edge of the changed tile diff, 0 is off, excludes dedup_rows */
+    uint8_t diff_max_rects;     /* Most windows per frame */
+    uint32_t diff_window_cost_px;   /* Per-window overhead in pixels, closer windows are merged */
+    int task_priority;          /* Transfer task priority, should be above the LVGL task */
+    int task_stack;             /* Transfer task stack size */
+    int task_affinity;          /* Transfer task core (-1 is no affinity) */
+    void (*on_frame_sent)(lv_display_t *disp, void *user_ctx);  /* Last buffer of a frame on the panel, from the transfer-done ISR, or the task when nothing was left to send; NULL for none */
+    void *user_ctx;
+} lcd_pipe_cfg_t;
+
+/**
+ * @brief Pipeline statistics
+ */
+typedef struct {
+    uint32_t flushes;           /* Buffers queued by LVGL */
+    uint32_t sent;              /* Buffers transferred to the panel */
+    uint32_t dropped;           /* Stale frames replaced before transfer */
+    uint32_t stalls;            /* Flushes that waited for a free buffer */
+    uint64_t stall_us;          /* Time LVGL spent waiting for a free buffer */
+    uint8_t depth;              /* Buffers queued or in flight now */
+    uint8_t max_depth;          /* Most buffers queued or in flight at once */
+    lcd_dedup_stats_t dedup;    /* Unchanged band filter, zero when off */
+    lcd_diff_stats_t diff;      /* Changed tile diff, zero when off */
+} lcd_pipe_stats_t;
+
+/**
+ * @brief Start the render-ahead pipeline
+ *
+ * Must be called after the display has been added to the LVGL port, with the LVGL lock
+ * held. It replaces the display's flush callback and the panel IO transfer-done callback,
+ * the latter reports to lcd_perf_flush_done() so use lcd_perf_attach() for frame timing.
+ *
+ * Completions carry no tag, so every transfer on the IO is taken for the pipeline's own while
+ * a buffer is on the wire. Nothing else may draw on the IO while the pipeline is attached
+ * (the splash has to be done before), unless it takes the transfer-done callback over, keeps
+ * its own completions and passes every other one to lcd_pipe_color_done_cb(), as lcd_power does.
+ *
+ * @param cfg Pipeline configuration
+ * @return ESP_OK on success
+ */
+esp_err_t lcd_pipe_init(const lcd_pipe_cfg_t *cfg);
+
+/**
+ * @brief The pipeline's panel IO transfer-done callback, for a module chaining in front of it
+ */
+bool lcd_pipe_color_done_cb(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx);
+
+/**
+ * @brief Tell the pipeline the panel RAM was written behind its back (splash, wake frame)
+ *
+ * The band filter or the tile diff forgets what the panel shows, the next buffer is sent
+ * whole. May be called from any task, also before lcd_pipe_init().
+ */
+void lcd_pipe_invalidate(void);
+
+/**
+ * @brief Get a copy of the pipeline statistics
+ */
+esp_err_t lcd_pipe_get_stats(lcd_pipe_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
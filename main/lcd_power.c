@@ -0,0 +1,360 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_sleep.h"
+#include "esp_pm.h"
+#include "driver/gpio.h"
+#include "driver/ledc.h"
+#include "esp_lcd_panel_commands.h"
+#include "esp_lvgl_port.h"
+#include "lcd_power.h"
+#include "lcd_simd.h"
+
+#define LCD_POWER_LEDC_MODE     (LEDC_LOW_SPEED_MODE)
+#define LCD_POWER_LEDC_TIMER    (LEDC_TIMER_0)
+#define LCD_POWER_LEDC_CHANNEL  (LEDC_CHANNEL_0)
+#define LCD_POWER_LEDC_BITS     (10)
+#define LCD_POWER_LEDC_FREQ_HZ  (5000)
+#define LCD_POWER_SLPOUT_MS     (5)         /* SLPOUT to the next command */
+#define LCD_POWER_FRAME_MS      (200)       /* Longest the wake frame may take on the wire */
+#define LCD_POWER_SLPIN_MIN_US  (120000)    /* SLPIN to SLPOUT */
+#define LCD_POWER_DIM_POLL_MS   (100)       /* Activity check while dimmed */
+
+typedef struct {
+    lcd_power_cfg_t cfg;
+    lcd_power_state_t state;
+    lv_timer_t *timer;
+    lv_draw_buf_t frame;        /* Last frame, panel byte order */
+    uint8_t *frame_px;
+    bool frame_valid;
+    TaskHandle_t wake_task;
+    SemaphoreHandle_t frame_done;
+    StaticSemaphore_t frame_done_buf;
+    volatile bool frame_pending;    /* The next transfer to complete is the wake frame */
+    int64_t slpin_us;
+    lcd_power_stats_t stats;
+#if CONFIG_PM_ENABLE
+    esp_pm_lock_handle_t pm_cpu;        /* Full speed rendering */
+    esp_pm_lock_handle_t pm_awake;      /* No light sleep while the panel is lit */
+#endif
+} lcd_power_ctx_t;
+
+static const char *TAG = "lcd_power";
+
+static lcd_power_ctx_t power_ctx;
+
+static void lcd_power_backlight(uint8_t percent, uint32_t fade_ms)
+{
+    if (power_ctx.cfg.bl_gpio < 0) {
+        return;
+    }
+    const uint32_t duty = ((1 << LCD_POWER_LEDC_BITS) - 1) * percent / 100;
+    if (fade_ms) {
+        ledc_set_fade_time_and_start(LCD_POWER_LEDC_MODE, LCD_POWER_LEDC_CHANNEL, duty, fade_ms, LEDC_FADE_NO_WAIT);
+    } else {
+        ledc_set_duty_and_update(LCD_POWER_LEDC_MODE, LCD_POWER_LEDC_CHANNEL, duty, 0);
+    }
+}
+
+static void lcd_power_pm_hold(bool hold)
+{
+#if CONFIG_PM_ENABLE
+    if (hold) {
+        esp_pm_lock_acquire(power_ctx.pm_cpu);
+        esp_pm_lock_acquire(power_ctx.pm_awake);
+    } else {
+        esp_pm_lock_release(power_ctx.pm_awake);
+        esp_pm_lock_release(power_ctx.pm_cpu);
+    }
+#endif
+}
+
+/* LVGL task, lock held */
+static void lcd_power_sleep(void)
+{
+    const lcd_power_cfg_t *cfg = &power_ctx.cfg;
+
+    lcd_power_backlight(0, 0);
+
+    /* Render the screen once more into the retained buffer, sent again on wake */
+    power_ctx.frame_valid = false;
+    if (power_ctx.frame_px) {
+        lv_obj_t *scr = lv_display_get_screen_active(cfg->disp);
+        if (lv_snapshot_take_to_draw_buf(scr, LV_COLOR_FORMAT_RGB565, &power_ctx.frame) == LV_RESULT_OK) {
+            lcd_simd_rgb565_swap((uint16_t *)power_ctx.frame_px, (uint32_t)cfg->hres * cfg->vres);
+            power_ctx.frame_valid = true;
+        } else {
+            ESP_LOGW(TAG, "Snapshot failed, waking relies on the panel RAM");
+        }
+    }
+
+    /* No rendering and no LVGL wakeups until lcd_power_wake() */
+    lv_timer_enable(false);
+
+    /* Both wait for the flush transfers still queued */
+    esp_lcd_panel_io_tx_param(cfg->io, LCD_CMD_DISPOFF, NULL, 0);
+    esp_lcd_panel_io_tx_param(cfg->io, LCD_CMD_SLPIN, NULL, 0);
+    power_ctx.slpin_us = esp_timer_get_time();
+    power_ctx.state = LCD_POWER_SLEEP;
+    power_ctx.stats.sleeps++;
+
+    ESP_LOGI(TAG, "Display asleep");
+    lcd_power_pm_hold(false);
+}
+
+/* Lock held */
+static void lcd_power_resume(void)
+{
+    const lcd_power_cfg_t *cfg = &power_ctx.cfg;
+    const int64_t start = esp_timer_get_time();
+
+    lcd_power_pm_hold(true);
+
+    const int64_t slept_us = start - power_ctx.slpin_us;
+    if (slept_us < LCD_POWER_SLPIN_MIN_US) {
+        vTaskDelay(pdMS_TO_TICKS((LCD_POWER_SLPIN_MIN_US - slept_us) / 1000) + 1);
+    }
+    esp_lcd_panel_io_tx_param(cfg->io, LCD_CMD_SLPOUT, NULL, 0);
+    vTaskDelay(pdMS_TO_TICKS(LCD_POWER_SLPOUT_MS) + 1);
+
+    /* The frame goes into the panel RAM while the display is still off, its completion is ours */
+    if (power_ctx.frame_valid) {
+        power_ctx.frame_pending = true;
+        esp_lcd_panel_draw_bitmap(cfg->panel, 0, 0, cfg->hres, cfg->vres, power_ctx.frame_px);
+        if (xSemaphoreTake(power_ctx.frame_done, pdMS_TO_TICKS(LCD_POWER_FRAME_MS)) != pdTRUE) {
+            ESP_LOGW(TAG, "Wake frame did not complete");
+        }
+    }
+    /* Queued behind the frame, returns once the frame is out */
+    esp_lcd_panel_io_tx_param(cfg->io, LCD_CMD_DISPON, NULL, 0);
+    lcd_power_backlight(100, 0);
+    if (cfg->on_wake) {
+        cfg->on_wake();
+    }
+
+    const uint32_t wake_us = (uint32_t)(esp_timer_get_time() - start);
+    power_ctx.stats.wakes++;
+    power_ctx.stats.last_wake_us = wake_us;
+    power_ctx.stats.max_wake_us = LV_MAX(power_ctx.stats.max_wake_us, wake_us);
+    power_ctx.state = LCD_POWER_ACTIVE;
+
+    lv_timer_enable(true);
+    lvgl_port_task_wake(LVGL_PORT_EVENT_USER, NULL);
+    ESP_LOGI(TAG, "Display awake in %"PRIu32" us%s", wake_us, power_ctx.frame_valid ? "" : " (no retained frame)");
+}
+
+static void lcd_power_timer_cb(lv_timer_t *timer)
+{
+    const lcd_power_cfg_t *cfg = &power_ctx.cfg;
+    const uint32_t idle = lv_display_get_inactive_time(cfg->disp);
+    uint32_t next;
+
+    if (idle < cfg->dim_after_ms) {
+        if (power_ctx.state == LCD_POWER_DIM) {
+            lcd_power_backlight(100, cfg->fade_ms);
+            power_ctx.state = LCD_POWER_ACTIVE;
+        }
+        next = cfg->dim_after_ms - idle;
+    } else if (idle < cfg->sleep_after_ms) {
+        if (power_ctx.state == LCD_POWER_ACTIVE) {
+            lcd_power_backlight(cfg->dim_percent, cfg->fade_ms);
+            power_ctx.state = LCD_POWER_DIM;
+        }
+        next = LV_MIN(LCD_POWER_DIM_POLL_MS, cfg->sleep_after_ms - idle);
+    } else {
+        lcd_power_sleep();
+        return;
+    }
+    /* Only wake up for the next deadline */
+    lv_timer_set_period(timer, LV_MAX(next, 1));
+}
+
+/* Every transfer but the wake frame is the display's */
+static bool lcd_power_color_done_cb(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+{
+    BaseType_t need_yield = pdFALSE;
+
+    if (!power_ctx.frame_pending) {
+        return power_ctx.cfg.io_done_cb(io, edata, power_ctx.cfg.io_done_ctx);
+    }
+    power_ctx.frame_pending = false;
+    xSemaphoreGiveFromISR(power_ctx.frame_done, &need_yield);
+    return (need_yield == pdTRUE);
+}
+
+static void lcd_power_gpio_isr(void *arg)
+{
+    BaseType_t need_yield = pdFALSE;
+
+    gpio_intr_disable(power_ctx.cfg.wake_gpio);
+    vTaskNotifyGiveFromISR(power_ctx.wake_task, &need_yield);
+    if (need_yield == pdTRUE) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+static void lcd_power_wake_task(void *arg)
+{
+    const int gpio = power_ctx.cfg.wake_gpio;
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        lcd_power_wake();
+
+        /* Level triggered, as light sleep wakeup needs it, re-armed once the button is released */
+        while (gpio_get_level(gpio) == 0) {
+            vTaskDelay(pdMS_TO_TICKS(20));
+        }
+        gpio_intr_enable(gpio);
+    }
+}
+
+static esp_err_t lcd_power_backlight_init(const lcd_power_cfg_t *cfg)
+{
+    const ledc_timer_config_t timer_cfg = {
+        .speed_mode = LCD_POWER_LEDC_MODE,
+        .duty_resolution = LCD_POWER_LEDC_BITS,
+        .timer_num = LCD_POWER_LEDC_TIMER,
+        .freq_hz = LCD_POWER_LEDC_FREQ_HZ,
+        .clk_cfg = LEDC_AUTO_CLK,
+    };
+    ESP_RETURN_ON_ERROR(ledc_timer_config(&timer_cfg), TAG, "LEDC timer config failed");
+
+    const ledc_channel_config_t channel_cfg = {
+        .gpio_num = cfg->bl_gpio,
+        .speed_mode = LCD_POWER_LEDC_MODE,
+        .channel = LCD_POWER_LEDC_CHANNEL,
+        .timer_sel = LCD_POWER_LEDC_TIMER,
+        .duty = (1 << LCD_POWER_LEDC_BITS) - 1,
+        .flags.output_invert = !cfg->bl_on_level,
+    };
+    ESP_RETURN_ON_ERROR(ledc_channel_config(&channel_cfg), TAG, "LEDC channel config failed");
+    return ledc_fade_func_install(0);
+}
+
+static esp_err_t lcd_power_wake_gpio_init(const lcd_power_cfg_t *cfg)
+{
+    const gpio_config_t io_cfg = {
+        .pin_bit_mask = 1ULL << cfg->wake_gpio,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_ENABLE,
+        .intr_type = GPIO_INTR_LOW_LEVEL,
+    };
+    ESP_RETURN_ON_ERROR(gpio_config(&io_cfg), TAG, "wake GPIO config failed");
+
+    ESP_RETURN_ON_FALSE(xTaskCreate(lcd_power_wake_task, "lcd_power", 3072, NULL, 5, &power_ctx.wake_task) == pdPASS,
+                        ESP_ERR_NO_MEM, TAG, "create wake task failed");
+
+    /* Somebody else may have installed the service already */
+    esp_err_t ret = gpio_install_isr_service(0);
+    ESP_RETURN_ON_FALSE(ret == ESP_OK || ret == ESP_ERR_INVALID_STATE, ret, TAG, "GPIO ISR service failed");
+    ESP_RETURN_ON_ERROR(gpio_isr_handler_add(cfg->wake_gpio, lcd_power_gpio_isr, NULL), TAG, "wake GPIO ISR failed");
+
+    if (cfg->light_sleep) {
+        ESP_RETURN_ON_ERROR(gpio_wakeup_enable(cfg->wake_gpio, GPIO_INTR_LOW_LEVEL), TAG, "GPIO wakeup failed");
+        ESP_RETURN_ON_ERROR(esp_sleep_enable_gpio_wakeup(), TAG, "GPIO wakeup failed");
+    }
+    return ESP_OK;
+}
+
+esp_err_t lcd_power_init(const lcd_power_cfg_t *cfg)
+{
+    ESP_RETURN_ON_FALSE(cfg && cfg->io && cfg->panel && cfg->disp, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(cfg->sleep_after_ms > cfg->dim_after_ms, ESP_ERR_INVALID_ARG, TAG, "sleep must come after dim");
+    ESP_RETURN_ON_FALSE(cfg->wake_gpio >= 0, ESP_ERR_INVALID_ARG, TAG, "no wake button, input devices stop while asleep");
+    ESP_RETURN_ON_FALSE(cfg->io_done_cb, ESP_ERR_INVALID_ARG, TAG, "the display's transfer-done callback is required");
+    ESP_RETURN_ON_FALSE(power_ctx.timer == NULL, ESP_ERR_INVALID_STATE, TAG, "already initialized");
+
+    power_ctx.cfg = *cfg;
+    power_ctx.state = LCD_POWER_ACTIVE;
+
+    if (cfg->resend) {
+        /* PSRAM if there is any, the SPI driver bounces it through internal RAM */
+        const uint32_t stride = lv_draw_buf_width_to_stride(cfg->hres, LV_COLOR_FORMAT_RGB565);
+        const uint32_t size = stride * cfg->vres;
+        power_ctx.frame_px = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!power_ctx.frame_px) {
+            power_ctx.frame_px = heap_caps_malloc(size, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+        }
+        ESP_RETURN_ON_FALSE(power_ctx.frame_px, ESP_ERR_NO_MEM, TAG, "no memory for the retained frame");
+        lv_draw_buf_init(&power_ctx.frame, cfg->hres, cfg->vres, LV_COLOR_FORMAT_RGB565, stride, power_ctx.frame_px, size);
+    }
+
+    if (cfg->bl_gpio >= 0) {
+        ESP_RETURN_ON_ERROR(lcd_power_backlight_init(cfg), TAG, "backlight init failed");
+    }
+
+    power_ctx.frame_done = xSemaphoreCreateBinaryStatic(&power_ctx.frame_done_buf);
+    const esp_lcd_panel_io_callbacks_t cbs = {
+        .on_color_trans_done = lcd_power_color_done_cb,
+    };
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_register_event_callbacks(cfg->io, &cbs, NULL), TAG, "register IO callback failed");
+
+#if CONFIG_PM_ENABLE
+    ESP_RETURN_ON_ERROR(esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "lcd_power", &power_ctx.pm_cpu), TAG, "PM lock failed");
+    ESP_RETURN_ON_ERROR(esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "lcd_power", &power_ctx.pm_awake), TAG, "PM lock failed");
+    lcd_power_pm_hold(true);
+    if (cfg->light_sleep) {
+        /* Light sleep and the lowest clock only when nothing holds a lock, i.e. the display sleeps */
+        const esp_pm_config_t pm_cfg = {
+            .max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+            .min_freq_mhz = CONFIG_XTAL_FREQ,
+            .light_sleep_enable = true,
+        };
+        ESP_RETURN_ON_ERROR(esp_pm_configure(&pm_cfg), TAG, "PM configure failed");
+    }
+#else
+    if (cfg->light_sleep) {
+        ESP_LOGW(TAG, "Light sleep needs CONFIG_PM_ENABLE");
+    }
+#endif
+
+    ESP_RETURN_ON_ERROR(lcd_power_wake_gpio_init(cfg), TAG, "wake button init failed");
+
+    power_ctx.timer = lv_timer_create(lcd_power_timer_cb, cfg->dim_after_ms, NULL);
+    ESP_RETURN_ON_FALSE(power_ctx.timer, ESP_ERR_NO_MEM, TAG, "create timer failed");
+    lv_display_trigger_activity(cfg->disp);
+    return ESP_OK;
+}
+
+esp_err_t lcd_power_wake(void)
+{
+    ESP_RETURN_ON_FALSE(power_ctx.timer, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+
+    lvgl_port_lock(0);
+    lv_display_trigger_activity(power_ctx.cfg.disp);
+    if (power_ctx.state == LCD_POWER_SLEEP) {
+        lcd_power_resume();
+    } else if (power_ctx.state == LCD_POWER_DIM) {
+        lcd_power_backlight(100, power_ctx.cfg.fade_ms);
+        power_ctx.state = LCD_POWER_ACTIVE;
+    }
+    /* Next check at the new dim deadline */
+    lv_timer_set_period(power_ctx.timer, power_ctx.cfg.dim_after_ms);
+    lv_timer_reset(power_ctx.timer);
+    lvgl_port_unlock();
+    return ESP_OK;
+}
+
+lcd_power_state_t lcd_power_get_state(void)
+{
+    return power_ctx.state;
+}
+
+esp_err_t lcd_power_get_stats(lcd_power_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(stats, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(power_ctx.timer, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+
+    *stats = power_ctx.stats;
+    return ESP_OK;
+}
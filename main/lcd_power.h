@@ -0,0 +1,105 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Display power states
+ */
+typedef enum {
+    LCD_POWER_ACTIVE,           /* Full backlight, LVGL running */
+    LCD_POWER_DIM,              /* Dimmed backlight, LVGL running */
+    LCD_POWER_SLEEP,            /* Backlight off, panel in SLPIN, LVGL timers stopped */
+} lcd_power_state_t;
+
+/**
+ * @brief Power manager configuration
+ */
+typedef struct {
+    esp_lcd_panel_io_handle_t io;
+    esp_lcd_panel_handle_t panel;
+    lv_display_t *disp;
+    uint16_t hres;
+    uint16_t vres;
+    int bl_gpio;                /* PWM backlight (LEDC), -1 if the backlight is not switchable */
+    bool bl_on_level;           /* Backlight on at high level */
+    uint8_t dim_percent;        /* Backlight level while dimmed */
+    uint32_t fade_ms;           /* Backlight fade time */
+    uint32_t dim_after_ms;      /* Inactivity before dimming */
+    uint32_t sleep_after_ms;    /* Inactivity before sleeping, above dim_after_ms */
+    int wake_gpio;              /* Active-low button waking the display (and the chip from light sleep) */
+    bool resend;                /* Send the retained frame on wake, otherwise rely on the panel keeping its RAM */
+    bool light_sleep;           /* Configure automatic light sleep while the display sleeps (CONFIG_PM_ENABLE) */
+    esp_lcd_panel_io_color_trans_done_cb_t io_done_cb;  /* The display's transfer-done callback, e.g. lcd_pipe_color_done_cb() */
+    void *io_done_ctx;          /* Its user context */
+    void (*on_wake)(void);      /* After the wake frame rewrote the panel RAM, e.g. lcd_pipe_invalidate(); NULL for none */
+} lcd_power_cfg_t;
+
+/**
+ * @brief Power manager statistics
+ */
+typedef struct {
+    uint32_t sleeps;
+    uint32_t wakes;
+    uint32_t last_wake_us;      /* From lcd_power_wake() to the frame on a lit panel */
+    uint32_t max_wake_us;
+} lcd_power_stats_t;
+
+/**
+ * @brief Start the display power manager
+ *
+ * Inactivity is LVGL's (lv_display_get_inactive_time()), reset by input devices and by
+ * lcd_power_wake(). After `dim_after_ms` the backlight fades to `dim_percent`, after
+ * `sleep_after_ms` the screen is rendered once more into a retained buffer, the backlight
+ * goes off, the panel enters DISPOFF / SLPIN and the LVGL timers are disabled, so LVGL
+ * neither renders nor wakes the CPU. With `light_sleep` the chip then light-sleeps until
+ * the wake button or another wakeup source. Input devices are not read while the display
+ * sleeps, so a wake button is required.
+ *
+ * Waking sends SLPOUT, the retained frame and DISPON and lights the backlight at once, so
+ * the panel shows the last frame again after one frame transfer, before LVGL renders.
+ * lcd_power takes the panel IO's transfer-done callback over, keeps the wake frame's
+ * completion and passes every other one to `io_done_cb`, so the display never sees the
+ * end of a flush it did not start.
+ *
+ * Must be called with the LVGL lock held, after the display's flush path is set up.
+ *
+ * @param cfg Configuration
+ * @return ESP_OK on success
+ */
+esp_err_t lcd_power_init(const lcd_power_cfg_t *cfg);
+
+/**
+ * @brief Report activity, waking the display from dim or sleep
+ *
+ * Must be called from a task, without the LVGL lock held.
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t lcd_power_wake(void);
+
+/**
+ * @brief Current state
+ */
+lcd_power_state_t lcd_power_get_state(void);
+
+/**
+ * @brief Get the statistics
+ */
+esp_err_t lcd_power_get_stats(lcd_power_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
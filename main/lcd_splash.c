@@ -0,0 +1,77 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_timer.h"
+#include "esp_lcd_panel_commands.h"
+#include "lcd_splash.h"
+
+typedef struct {
+    esp_lcd_panel_io_handle_t io;
+    SemaphoreHandle_t done;
+    StaticSemaphore_t done_buf;
+    int64_t queued_us;
+    volatile int64_t done_us;
+} lcd_splash_ctx_t;
+
+static const char *TAG = "lcd_splash";
+
+static lcd_splash_ctx_t splash_ctx;
+
+static bool lcd_splash_done_cb(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+{
+    BaseType_t need_yield = pdFALSE;
+
+    /* Only the last chunk of the image matters, earlier ones overwrite the time */
+    splash_ctx.done_us = esp_timer_get_time();
+    xSemaphoreGiveFromISR(splash_ctx.done, &need_yield);
+    return (need_yield == pdTRUE);
+}
+
+esp_err_t lcd_splash_show(esp_lcd_panel_io_handle_t io, esp_lcd_panel_handle_t panel, const lv_image_dsc_t *img)
+{
+    ESP_RETURN_ON_FALSE(io && panel && img && img->data, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(img->header.cf == LV_COLOR_FORMAT_RGB565_SWAPPED, ESP_ERR_INVALID_ARG, TAG, "splash must be RGB565 in panel byte order");
+    ESP_RETURN_ON_FALSE(splash_ctx.io == NULL, ESP_ERR_INVALID_STATE, TAG, "splash already shown");
+
+    splash_ctx.io = io;
+    splash_ctx.done = xSemaphoreCreateBinaryStatic(&splash_ctx.done_buf);
+    const esp_lcd_panel_io_callbacks_t cbs = {
+        .on_color_trans_done = lcd_splash_done_cb,
+    };
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_register_event_callbacks(io, &cbs, NULL), TAG, "register IO callback failed");
+
+    /* Flash is not DMA capable, the SPI driver bounces every chunk through internal RAM */
+    splash_ctx.queued_us = esp_timer_get_time();
+    return esp_lcd_panel_draw_bitmap(panel, 0, 0, img->header.w, img->header.h, img->data);
+}
+
+esp_err_t lcd_splash_wait(uint32_t timeout_ms)
+{
+    ESP_RETURN_ON_FALSE(splash_ctx.io, ESP_ERR_INVALID_STATE, TAG, "no splash shown");
+
+    /* A NOP goes out only after every queued color transfer */
+    esp_lcd_panel_io_tx_param(splash_ctx.io, LCD_CMD_NOP, NULL, 0);
+    esp_err_t ret = xSemaphoreTake(splash_ctx.done, pdMS_TO_TICKS(timeout_ms)) == pdTRUE ? ESP_OK : ESP_ERR_TIMEOUT;
+
+    const esp_lcd_panel_io_callbacks_t cbs = { 0 };
+    esp_lcd_panel_io_register_event_callbacks(splash_ctx.io, &cbs, NULL);
+
+    if (ret == ESP_OK) {
+        ESP_LOGI(TAG, "First frame on the panel %"PRId64" ms after app start (%"PRId64" us on the wire)",
+                 splash_ctx.done_us / 1000, splash_ctx.done_us - splash_ctx.queued_us);
+    } else {
+        ESP_LOGW(TAG, "Splash transfer did not complete");
+    }
+    return ret;
+}
+
+int64_t lcd_splash_first_frame_us(void)
+{
+    return splash_ctx.done_us;
+}
@@ -0,0 +1,48 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Queue a pre-rendered image to the panel, before LVGL exists
+ *
+ * The image has to be LV_COLOR_FORMAT_RGB565_SWAPPED (panel byte order), as written
+ * by `tools/anim_conv.py --splash`, it is sent without any conversion. The call returns
+ * as soon as the transfer is queued, so initialization continues while it is on the wire.
+ *
+ * @param io    Panel IO, its transfer-done callback is borrowed until lcd_splash_wait()
+ * @param panel Panel
+ * @param img   Image, drawn at the top left corner
+ * @return ESP_OK on success
+ */
+esp_err_t lcd_splash_show(esp_lcd_panel_io_handle_t io, esp_lcd_panel_handle_t panel, const lv_image_dsc_t *img);
+
+/**
+ * @brief Wait for the splash transfer and give the panel IO callback back
+ *
+ * Must be called before anything else registers panel IO callbacks (e.g. lvgl_port_add_disp()).
+ *
+ * @param timeout_ms Maximum wait
+ * @return ESP_OK once the splash is on the panel, ESP_ERR_TIMEOUT otherwise
+ */
+esp_err_t lcd_splash_wait(uint32_t timeout_ms);
+
+/**
+ * @brief esp_timer time (since app start) of the last splash pixel on the panel in microseconds, 0 if not there yet
+ */
+int64_t lcd_splash_first_frame_us(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,109 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_lcd_panel_commands.h"
+#include "lcd_stripe.h"
+#include "src/display/lv_display_private.h"
+
+#define LCD_STRIPE_MAX_DISPLAYS     (2)
+
+typedef struct {
+    esp_lcd_panel_io_handle_t io;
+    lv_display_t *disp;
+    int x_gap;
+    int y_gap;
+    bool swap_bytes;
+    int32_t next_y;             /* Row the open window continues at, -1 if none */
+} lcd_stripe_ctx_t;
+
+static const char *TAG = "lcd_stripe";
+
+static lcd_stripe_ctx_t stripe_ctx[LCD_STRIPE_MAX_DISPLAYS];
+
+static lcd_stripe_ctx_t *lcd_stripe_find(lv_display_t *disp)
+{
+    for (int i = 0; i < LCD_STRIPE_MAX_DISPLAYS; i++) {
+        if (stripe_ctx[i].disp == disp) {
+            return &stripe_ctx[i];
+        }
+    }
+    return NULL;
+}
+
+static void lcd_stripe_invalidate_cb(lv_event_t *e)
+{
+    lcd_stripe_ctx_t *ctx = lv_event_get_user_data(e);
+    lv_area_t *area = lv_event_get_param(e);
+
+    /* While rendering, LVGL only asks how a band of the draw buffer rounds, bands stay as they are */
+    if (ctx->disp->rendering_in_progress) {
+        return;
+    }
+    /* Any change redraws the whole frame, LVGL splits it into buffer-high bands */
+    lv_area_set(area, 0, 0, lv_display_get_horizontal_resolution(ctx->disp) - 1,
+                lv_display_get_vertical_resolution(ctx->disp) - 1);
+}
+
+/* What draw_bitmap() would send, with the panel's offsets */
+static void lcd_stripe_open_window(lcd_stripe_ctx_t *ctx, int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+{
+    x1 += ctx->x_gap;
+    x2 += ctx->x_gap;
+    y1 += ctx->y_gap;
+    y2 += ctx->y_gap;
+    esp_lcd_panel_io_tx_param(ctx->io, LCD_CMD_CASET, (uint8_t[]) {
+        (x1 >> 8) & 0xFF, x1 & 0xFF, (x2 >> 8) & 0xFF, x2 & 0xFF,
+    }, 4);
+    esp_lcd_panel_io_tx_param(ctx->io, LCD_CMD_RASET, (uint8_t[]) {
+        (y1 >> 8) & 0xFF, y1 & 0xFF, (y2 >> 8) & 0xFF, y2 & 0xFF,
+    }, 4);
+}
+
+static void lcd_stripe_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    lcd_stripe_ctx_t *ctx = lcd_stripe_find(disp);
+    const int32_t hres = lv_display_get_horizontal_resolution(disp);
+    const int32_t vres = lv_display_get_vertical_resolution(disp);
+    const size_t len = lv_area_get_size(area) * lv_color_format_get_size(lv_display_get_color_format(disp));
+    const bool full_width = area->x1 == 0 && area->x2 == hres - 1;
+
+    if (ctx->swap_bytes) {
+        lv_draw_sw_rgb565_swap(px_map, lv_area_get_size(area));
+    }
+
+    if (full_width && area->y1 == ctx->next_y) {
+        /* Next band of the frame, the panel's write pointer is already there */
+        esp_lcd_panel_io_tx_color(ctx->io, LCD_CMD_RAMWRC, px_map, len);
+    } else {
+        /* Full-width bands open the window down to the last row so the following ones can continue it */
+        lcd_stripe_open_window(ctx, area->x1, area->y1, area->x2, full_width ? vres - 1 : area->y2);
+        esp_lcd_panel_io_tx_color(ctx->io, LCD_CMD_RAMWR, px_map, len);
+    }
+    ctx->next_y = (full_width && area->y2 < vres - 1) ? area->y2 + 1 : -1;
+}
+
+esp_err_t lcd_stripe_attach(const lcd_stripe_cfg_t *cfg)
+{
+    ESP_RETURN_ON_FALSE(cfg && cfg->io && cfg->disp, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(lcd_stripe_find(cfg->disp) == NULL, ESP_ERR_INVALID_STATE, TAG, "already attached");
+
+    lcd_stripe_ctx_t *ctx = lcd_stripe_find(NULL);
+    ESP_RETURN_ON_FALSE(ctx, ESP_ERR_NO_MEM, TAG, "no free context");
+
+    ctx->io = cfg->io;
+    ctx->disp = cfg->disp;
+    ctx->x_gap = cfg->x_gap;
+    ctx->y_gap = cfg->y_gap;
+    ctx->swap_bytes = cfg->swap_bytes;
+    ctx->next_y = -1;
+
+    lv_display_add_event_cb(cfg->disp, lcd_stripe_invalidate_cb, LV_EVENT_INVALIDATE_AREA, ctx);
+    lv_display_set_flush_cb(cfg->disp, lcd_stripe_flush_cb);
+    lv_obj_invalidate(lv_display_get_screen_active(cfg->disp));
+
+    ESP_LOGI(TAG, "Striped full refresh enabled");
+    return ESP_OK;
+}
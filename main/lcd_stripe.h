@@ -0,0 +1,52 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_lcd_panel_io.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Striped full refresh configuration
+ *
+ * Every frame is redrawn whole, but LVGL renders it in bands as tall as the draw
+ * buffer (partial render mode). The first band opens a full-screen window with
+ * CASET/RASET/RAMWR and every following band is appended with RAMWRC (memory write
+ * continue), so the panel receives one continuous write like with a full-screen buffer.
+ *
+ * The commands go out on the panel IO, not through esp_lcd_panel_draw_bitmap(), so
+ * what the panel driver would add is done here: the offsets set with
+ * esp_lcd_panel_set_gap() are passed in `x_gap` / `y_gap` and the byte swap is
+ * `swap_bytes`. Mirroring and swap_xy live in MADCTL and need nothing.
+ */
+typedef struct {
+    esp_lcd_panel_io_handle_t io;
+    lv_display_t *disp;
+    int x_gap;                  /* Panel offsets, as given to esp_lcd_panel_set_gap() */
+    int y_gap;
+    bool swap_bytes;            /* Swap RGB565 bytes before sending, replaces the port's swap */
+} lcd_stripe_cfg_t;
+
+/**
+ * @brief Switch a display to striped full refresh
+ *
+ * The display must be created in partial render mode with a screen-wide buffer. It
+ * replaces the flush callback, transfers complete through the panel IO callback
+ * registered by the port (or lcd_perf_attach_io()). Not to be combined with
+ * lcd_partial, lcd_dual or lcd_pipe.
+ *
+ * @param cfg Stripe configuration
+ * @return ESP_OK on success
+ */
+esp_err_t lcd_stripe_attach(const lcd_stripe_cfg_t *cfg);
+
+#ifdef __cplusplus
+}
+#endif
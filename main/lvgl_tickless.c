@@ -0,0 +1,76 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_timer.h"
+#include "esp_lvgl_port.h"
+#include "lvgl_tickless.h"
+
+typedef struct {
+    TaskHandle_t lvgl_task;
+    volatile uint32_t wakeups;
+    volatile uint32_t woken;
+} lvgl_tickless_ctx_t;
+
+static const char *TAG = "lvgl_tickless";
+
+static lvgl_tickless_ctx_t tickless_ctx;
+
+/* The port's task calls lv_timer_handler() once per wakeup, linked with -Wl,--wrap=lv_timer_handler */
+uint32_t __real_lv_timer_handler(void);
+
+uint32_t __wrap_lv_timer_handler(void)
+{
+    tickless_ctx.wakeups++;
+    return __real_lv_timer_handler();
+}
+
+static uint32_t lvgl_tickless_tick_get(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+/* LVGL calls it when a timer is created or resumed, e.g. the refresh timer on invalidation */
+static void lvgl_tickless_resume_cb(void *data)
+{
+    /* The LVGL task itself recomputes its sleep after this pass anyway */
+    if (xTaskGetCurrentTaskHandle() != tickless_ctx.lvgl_task) {
+        tickless_ctx.woken++;
+        lvgl_port_task_wake(LVGL_PORT_EVENT_USER, NULL);
+    }
+}
+
+static void lvgl_tickless_switch_cb(lv_timer_t *timer)
+{
+    /* Stops the periodic tick, and the LVGL timers with it */
+    esp_err_t ret = lvgl_port_stop();
+    lv_timer_enable(true);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Stop the port tick failed: %s", esp_err_to_name(ret));
+        return;
+    }
+
+    tickless_ctx.lvgl_task = xTaskGetCurrentTaskHandle();
+    lv_tick_set_cb(lvgl_tickless_tick_get);
+    lv_timer_handler_set_resume_cb(lvgl_tickless_resume_cb, NULL);
+    ESP_LOGI(TAG, "LVGL tick from esp_timer, periodic tick stopped");
+}
+
+esp_err_t lvgl_tickless_enable(void)
+{
+    /* Run from the LVGL task, by then the port's tick timer exists */
+    lv_timer_t *timer = lv_timer_create(lvgl_tickless_switch_cb, 0, NULL);
+    ESP_RETURN_ON_FALSE(timer, ESP_ERR_NO_MEM, TAG, "create switch timer failed");
+    lv_timer_set_repeat_count(timer, 1);
+    return ESP_OK;
+}
+
+void lvgl_tickless_get_stats(lvgl_tickless_stats_t *stats)
+{
+    stats->wakeups = tickless_ctx.wakeups;
+    stats->woken = tickless_ctx.woken;
+}
@@ -0,0 +1,44 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief LVGL task activity
+ */
+typedef struct {
+    uint32_t wakeups;           /* lv_timer_handler() runs, i.e. LVGL task wakeups */
+    uint32_t woken;             /* Wakeups requested by other tasks (invalidation, new or resumed timers) */
+} lvgl_tickless_stats_t;
+
+/**
+ * @brief Switch the LVGL port to tickless operation
+ *
+ * The port's periodic tick timer is stopped and LVGL reads its tick from esp_timer_get_time()
+ * instead. The LVGL task then only wakes up for the next LVGL timer deadline (capped by the
+ * port's `task_max_sleep_ms`, which is also how late a missed wakeup shows), or when another task invalidates an area or creates / resumes
+ * a timer, which wakes it through lvgl_port_task_wake(). The switch happens on the LVGL task's
+ * next pass, after the port has set up its tick.
+ *
+ * Must be called after lvgl_port_init(), with the LVGL lock held.
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t lvgl_tickless_enable(void);
+
+/**
+ * @brief Get the counters since boot, also counted without the tickless mode
+ */
+void lvgl_tickless_get_stats(lvgl_tickless_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
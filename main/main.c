@@ -2,9 +2,12 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <inttypes.h>
 #include "esp_err.h"
 #include "esp_log.h"
 #include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "nvs_flash.h"
 #include "driver/i2c.h"
 #include "driver/gpio.h"
 #include "driver/spi_master.h"
@@ -14,7 +17,27 @@
 #include "esp_lvgl_port.h"
 // #include "esp_lcd_gc9a01.h"
 #include "esp_lcd_gc9d01.h"
-#include "lv_examples.h"
+#include "lcd_partial.h"
+#include "lcd_dual.h"
+#include "lcd_perf.h"
+#include "lcd_native.h"
+#include "lcd_pipe.h"
+#include "lcd_buf.h"
+#include "lcd_stripe.h"
+#include "lcd_link.h"
+#include "lcd_splash.h"
+#include "gif_cache.h"
+#include "img_bulb_gif.h"
+#include "img_c565.h"
+#include "app_ui.h"
+#include "splash_bulb.h"
+#include "lcd_simd.h"
+#include "boot_graph.h"
+#include "scene_bench.h"
+#include "lvgl_tickless.h"
+#include "lcd_power.h"
+#include "lv_mem_app.h"
+#include "lv_mem_prof.h"
 
 // #include "esp_lcd_touch_tt21100.h"
 
@@ -24,14 +47,84 @@
 
 /* LCD settings */
 #define EXAMPLE_LCD_SPI_NUM         (SPI2_HOST)
-#define EXAMPLE_LCD_PIXEL_CLK_HZ    (SPI_MASTER_FREQ_80M)
+#define EXAMPLE_LCD_PIXEL_CLK_HZ    (SPI_MASTER_FREQ_80M)   // 未开启自动调优时使用
+#define EXAMPLE_LCD_LINK_TUNE       (0)     // 仅芯片内部自检：MOSI 经 GPIO 矩阵回环到 MISO，检查 SPI 时钟、DMA 和 PSRAM 供数，不经过排线和屏幕，不能判断链路质量；通过的组合存入 NVS；测试期间 SCLK/MOSI 会在屏幕引脚上翻转（CS、DC 未驱动）
 #define EXAMPLE_LCD_CMD_BITS        (8)
 #define EXAMPLE_LCD_PARAM_BITS      (8)
 #define EXAMPLE_LCD_COLOR_SPACE     (ESP_LCD_COLOR_SPACE_BGR)
 #define EXAMPLE_LCD_BITS_PER_PIXEL  (16)
 #define EXAMPLE_LCD_DRAW_BUFF_DOUBLE (1)
 #define EXAMPLE_LCD_DRAW_BUFF_HEIGHT (160)  // 全刷缓冲区必须比分辨率高，局部刷新可以小于分辨率
-// #define EXAMPLE_LCD_BL_ON_LEVEL     (1)
+#define EXAMPLE_LCD_STRIPE_ROWS      (0)    // 条带全刷：整帧按 N 行条带渲染，RAMWR + RAMWRC 连续写入，缓冲区只需 N 行；0 为关闭
+#define EXAMPLE_LCD_BUFF_POLICY      (LCD_BUF_POLICY_AUTO)  // 缓冲区放置策略：优先内部 DMA SRAM，放不下时缩短条带，最后退回 PSRAM
+#define EXAMPLE_LCD_BUFF_MIN_ROWS    (16)   // 内部 SRAM 条带的最小行数，条带高度取它的整数倍
+#define EXAMPLE_LCD_BUFF_RESERVE     (64 * 1024)    // 为驱动和任务栈保留的内部 DMA SRAM
+#define EXAMPLE_LCD_BUFF_PROBE       (1)    // 启动时测量内部 SRAM / PSRAM 的像素读写吞吐
+#define EXAMPLE_LCD_PARTIAL_REFRESH  (0)    // 局部刷新：脏区对齐到屏幕窗口粒度后只发送变化区域；对齐能否消除乱点尚未在屏上验证；开启后流水线的条带去重和块比较都不生效
+#define EXAMPLE_LCD_PARTIAL_ALIGN_X  (2)    // CASET 列粒度（像素）
+#define EXAMPLE_LCD_PARTIAL_ALIGN_Y  (2)    // RASET 行粒度（像素）
+#define EXAMPLE_LCD_PARTIAL_WIN_COST (256)  // 每个窗口的命令开销折算成像素，多出的像素少于它时合并为一个窗口
+#define EXAMPLE_LCD_DUAL_PANEL       (0)    // 双屏：CS0/CS1 共用 SPI2 总线
+#define EXAMPLE_LCD_DUAL_MIRROR      (0)    // 双屏镜像：只渲染一次，同一缓冲区发送到两块屏
+#define EXAMPLE_LCD_DUAL_CHUNK_ROWS  (20)   // 每次 SPI 传输的行数，两块屏按块交替发送
+#define EXAMPLE_LCD_PIPE_BUFS        (3)    // 渲染/传输流水线缓冲区个数（2..3），0 为使用 LVGL 端口自带的双缓冲；仅单屏
+#define EXAMPLE_LCD_PIPE_DROP_STALE  (1)    // 全刷模式下丢弃还未发送的旧帧，只发送最新帧
+#define EXAMPLE_LCD_DEDUP_ROWS       (16)   // 流水线发送前按 N 行条带计算哈希，与上次发送相同的条带不再传输（屏幕 GRAM 保留）；仅全刷且未开块比较时生效（局部刷新只发脏区，条带几乎不会重复）；0 为关闭
+#define EXAMPLE_LCD_DIFF_TILE        (16)   // 全刷模式下按 N x N 块与上一帧比较，只发送变化块合并成的窗口，代替条带去重；0 为关闭
+#define EXAMPLE_LCD_DIFF_MAX_RECTS   (8)    // 每帧最多发送的窗口数
+#define EXAMPLE_LCD_DIFF_WIN_COST    (256)  // 块比较时每个窗口的开销折算成像素，合并相邻变化块浪费的像素少于它时合并
+#define EXAMPLE_LCD_PERF_DUMP_MS     (5000) // 帧耗时统计打印周期，0 为关闭
+#define EXAMPLE_LCD_NATIVE_ORDER     (1)    // LVGL 直接按屏幕字节序（大端 RGB565）渲染，刷屏时不再逐像素交换
+#define EXAMPLE_LCD_SPLASH           (1)    // 面板初始化后立即发送 flash 中预渲染的启动画面，LVGL 初始化同时进行
+#define EXAMPLE_LCD_SIMD_BENCH       (0)    // 启动时打印 RGB565 内核（C / PIE）每像素周期数，仅诊断用，会拖慢启动
+#define EXAMPLE_BOOT_PARALLEL        (1)    // 启动步骤按依赖关系在两个核上并行执行，0 为按顺序执行（用于对比耗时）
+#define EXAMPLE_LVGL_TASK_CORE       (1)    // LVGL 任务（UI 逻辑）所在核，SPI 传输完成中断和发送任务放在另一个核；-1 为不绑定
+#define EXAMPLE_LVGL_TICKLESS        (1)    // LVGL 任务只在下一个定时器到期或有刷新/输入事件时唤醒，tick 取自 esp_timer，不再周期性中断
+#define EXAMPLE_LVGL_TICK_MS         (5)    // 非 tickless 时端口 tick 定时器周期
+#define EXAMPLE_LVGL_MEM_SLAB_KB     (32)   // LVGL 小对象（样式、区域、绘制任务）的分级 slab，内部 SRAM
+#define EXAMPLE_LVGL_MEM_MID_MAX     (4096) // slab 之外仍放在内部 RAM 的最大块（字节）
+#define EXAMPLE_LVGL_MEM_MID_KB      (32)   // 这些块可用的内部 RAM
+#define EXAMPLE_LVGL_MEM_ARENA_KB    (1024) // 大块内存（图片、图层）的 PSRAM 区域，用满后继续从默认堆分配
+#define EXAMPLE_LVGL_MEM_TRACE       (0)    // 串口打印每次分配/释放，供 tools/alloc_replay.c 在主机上回放
+#define EXAMPLE_LVGL_MEM_PROF        (0)    // LVGL 堆分析：按对象类和调用点统计分配，记录的最大存活块数（如 4096）；0 为关闭，仅诊断构建开启，每次分配和对象事件都要记账
+#define EXAMPLE_LVGL_MEM_PROF_DUMP_MS (60000)   // 堆分析报告打印周期（分配失败时立即打印），0 为只在失败时打印
+#define EXAMPLE_LVGL_SCENE_BENCH     (0)    // 启动后每个基准场景渲染的帧数，0 为关闭；多绘制单元的收益需与 CONFIG_LV_DRAW_SW_DRAW_UNIT_CNT=1 的构建对比
+#define EXAMPLE_LCD_POWER            (0)    // 显示电源管理：无操作后背光变暗，再进入 SLPIN 并停止 LVGL，按键唤醒时重发最后一帧；仅单屏，需要唤醒按键
+#define EXAMPLE_LCD_POWER_DIM_MS     (15000)    // 无操作多久后背光变暗
+#define EXAMPLE_LCD_POWER_SLEEP_MS   (30000)    // 无操作多久后屏幕进入休眠
+#define EXAMPLE_LCD_POWER_DIM_PCT    (20)   // 变暗时的背光亮度（%）
+#define EXAMPLE_LCD_POWER_FADE_MS    (300)  // 背光渐变时间
+#define EXAMPLE_LCD_POWER_WAKE_GPIO  (GPIO_NUM_0)   // 唤醒按键（低电平有效，默认按 BOOT 键接在 GPIO0 上），同时作为 light sleep 唤醒源；休眠时 LVGL 输入设备不再读取，只能靠它唤醒
+#define EXAMPLE_LCD_POWER_LIGHT_SLEEP (0)   // 屏幕休眠期间允许芯片自动 light sleep（需要 CONFIG_PM_ENABLE 和 CONFIG_FREERTOS_USE_TICKLESS_IDLE）
+
+#if EXAMPLE_LVGL_TASK_CORE >= 0
+#define EXAMPLE_LCD_IO_CORE          (1 - EXAMPLE_LVGL_TASK_CORE)
+#else
+#define EXAMPLE_LCD_IO_CORE          (-1)
+#endif
+
+/* The tile diff's frames come out of the same heap as the pipeline's buffers: the packing buffer, and the previous frame without PSRAM */
+#if EXAMPLE_LCD_DIFF_TILE && !EXAMPLE_LCD_PARTIAL_REFRESH && !EXAMPLE_LCD_DUAL_PANEL && EXAMPLE_LCD_PIPE_BUFS && CONFIG_SPIRAM
+#define EXAMPLE_LCD_DIFF_BYTES       (EXAMPLE_LCD_H_RES * EXAMPLE_LCD_V_RES * sizeof(uint16_t))
+#elif EXAMPLE_LCD_DIFF_TILE && !EXAMPLE_LCD_PARTIAL_REFRESH && !EXAMPLE_LCD_DUAL_PANEL && EXAMPLE_LCD_PIPE_BUFS
+#define EXAMPLE_LCD_DIFF_BYTES       (2 * EXAMPLE_LCD_H_RES * EXAMPLE_LCD_V_RES * sizeof(uint16_t))
+#else
+#define EXAMPLE_LCD_DIFF_BYTES       (0)
+#endif
+
+#if EXAMPLE_LCD_STRIPE_ROWS && (EXAMPLE_LCD_DUAL_PANEL || EXAMPLE_LCD_PIPE_BUFS)
+#error "Striped full refresh sends through the port's flush path, disable the dual panel scheduler and the pipeline"
+#endif
+
+#if EXAMPLE_LCD_POWER && EXAMPLE_LCD_DUAL_PANEL
+#error "Display power management drives a single panel, disable the dual panel mode"
+#endif
+
+/* GIF settings */
+#define EXAMPLE_GIF_PREDECODE        (1)    // 启动时把 GIF 全部帧解码到 PSRAM，播放时不再解码
+#define EXAMPLE_GIF_CACHE_BUDGET_KB  (512)  // 预解码可用的 PSRAM，超出则回退到实时解码
+#define EXAMPLE_GIF_USE_A565         (1)    // 播放构建时由 tools/anim_conv.py 转换的 RGB565 差分帧动画
+#define EXAMPLE_LCD_BL_ON_LEVEL      (1)
 
 /* LCD pins */
 #define EXAMPLE_LCD_GPIO_SCLK       (GPIO_NUM_39)
@@ -40,7 +133,7 @@
 #define EXAMPLE_LCD_GPIO_DC         (GPIO_NUM_40)
 #define EXAMPLE_LCD_GPIO_CS0         (GPIO_NUM_47)
 #define EXAMPLE_LCD_GPIO_CS1         (GPIO_NUM_48)
-// #define EXAMPLE_LCD_GPIO_BL         (GPIO_NUM_NC)
+#define EXAMPLE_LCD_GPIO_BL         (GPIO_NUM_NC)  // 背光 PWM（LEDC）由 lcd_power 驱动，本板背光常亮
 
 /* Touch settings */
 // #define EXAMPLE_TOUCH_I2C_NUM       (0)
@@ -59,22 +152,100 @@ static const char *TAG = "EXAMPLE";
 /* LCD IO and panel */
 static esp_lcd_panel_io_handle_t lcd_io = NULL;
 static esp_lcd_panel_handle_t lcd_panel = NULL;
+#if EXAMPLE_LCD_DUAL_PANEL
+static esp_lcd_panel_io_handle_t lcd_io1 = NULL;
+static esp_lcd_panel_handle_t lcd_panel1 = NULL;
+#endif
 // static esp_lcd_touch_handle_t touch_handle = NULL;
 
 /* LVGL display and touch */
 static lv_display_t *lvgl_disp = NULL;
+#if EXAMPLE_LCD_DUAL_PANEL && !EXAMPLE_LCD_DUAL_MIRROR
+static lv_display_t *lvgl_disp1 = NULL;
+#endif
 // static lv_indev_t *lvgl_touch_indev = NULL;
 
-static esp_err_t app_lcd_init(void)
+/* SPI link settings, replaced by the tuned ones */
+static lcd_link_result_t lcd_link_cur = {
+    .pclk_hz = EXAMPLE_LCD_PIXEL_CLK_HZ,
+    .chunk_bytes = EXAMPLE_LCD_H_RES * EXAMPLE_LCD_DRAW_BUFF_HEIGHT * sizeof(uint16_t),
+};
+
+/* Draw buffer placement */
+static lcd_buf_plan_t lcd_buf_plan_cur;
+
+/* First screen, built by app_ui.c like on the host (host/) */
+static const app_ui_cfg_t app_ui_cfg = {
+#if EXAMPLE_GIF_USE_A565
+    .anim = APP_UI_ANIM_A565,
+#elif EXAMPLE_GIF_PREDECODE
+    .anim = APP_UI_ANIM_GIF_CACHE,
+#else
+    .anim = APP_UI_ANIM_GIF,
+#endif
+    .gif = &img_bulb_gif0,
+    .gif_cfg = {
+        .budget_bytes = EXAMPLE_GIF_CACHE_BUDGET_KB * 1024,
+    },
+};
+
+#if EXAMPLE_LCD_LINK_TUNE
+static esp_err_t app_link_tune(void)
 {
     esp_err_t ret = ESP_OK;
+    const lcd_link_ladder_t ladder = {
+        .pclk_hz = { SPI_MASTER_FREQ_80M, SPI_MASTER_FREQ_40M, SPI_MASTER_FREQ_26M, SPI_MASTER_FREQ_20M },
+        .chunk_bytes = { EXAMPLE_LCD_H_RES * EXAMPLE_LCD_DRAW_BUFF_HEIGHT * sizeof(uint16_t), 16 * 1024, 4 * 1024 },
+        .rounds = 8,
+    };
 
-    /* LCD backlight */
-    // gpio_config_t bk_gpio_config = {
-    //     .mode = GPIO_MODE_OUTPUT,
-    //     .pin_bit_mask = 1ULL << EXAMPLE_LCD_GPIO_BL
-    // };
-    // ESP_ERROR_CHECK(gpio_config(&bk_gpio_config));
+    /* Checked on an earlier boot */
+    if (lcd_link_load(&ladder, &lcd_link_cur) == ESP_OK) {
+        ESP_LOGI(TAG, "SPI link from NVS: %"PRIu32" Hz, %"PRIu32" B chunks", lcd_link_cur.pclk_hz, lcd_link_cur.chunk_bytes);
+        return ESP_OK;
+    }
+
+    /* The pattern comes from PSRAM like the draw buffers may, what is read back lands in internal RAM */
+    lcd_link_probe_t *probe = NULL;
+    uint8_t *tx = heap_caps_malloc(ladder.chunk_bytes[0], MALLOC_CAP_DMA | MALLOC_CAP_SPIRAM);
+    uint8_t *rx = heap_caps_malloc(ladder.chunk_bytes[0], MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    ESP_GOTO_ON_FALSE(tx && rx, ESP_ERR_NO_MEM, err, TAG, "No memory for link test buffers");
+
+    const lcd_link_spi_cfg_t spi_cfg = {
+        .host = EXAMPLE_LCD_SPI_NUM,
+        .sclk_io_num = EXAMPLE_LCD_GPIO_SCLK,
+        .mosi_io_num = EXAMPLE_LCD_GPIO_MOSI,
+        .max_chunk = ladder.chunk_bytes[0],
+    };
+    ESP_GOTO_ON_ERROR(lcd_link_new_spi_probe(&spi_cfg, &probe), err, TAG, "Link probe init failed");
+
+    /* Only a passing result is stored, a fallback is retried on the next boot */
+    if (lcd_link_tune(probe, &ladder, tx, rx, &lcd_link_cur) == ESP_OK) {
+        ESP_GOTO_ON_ERROR(lcd_link_save(&ladder, &lcd_link_cur), err, TAG, "Store link settings failed");
+    }
+
+err:
+    lcd_link_del_spi_probe(probe);
+    heap_caps_free(tx);
+    heap_caps_free(rx);
+    return ret;
+}
+#endif
+
+/* Reset and init sequence of one panel */
+static esp_err_t app_lcd_panel_setup(esp_lcd_panel_handle_t panel)
+{
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_reset(panel), TAG, "Panel reset failed");
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_init(panel), TAG, "Panel init sequence failed");
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_invert_color(panel, false), TAG, "Panel invert failed");
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_mirror(panel, true, true), TAG, "Panel mirror failed");
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_disp_on_off(panel, true), TAG, "Panel display on failed");
+    return ESP_OK;
+}
+
+static esp_err_t app_lcd_init(void)
+{
+    esp_err_t ret = ESP_OK;
 
     /* LCD initialization */
     ESP_LOGI(TAG, "Initialize SPI bus");
@@ -84,7 +255,10 @@ static esp_err_t app_lcd_init(void)
         .miso_io_num = GPIO_NUM_NC,
         .quadwp_io_num = GPIO_NUM_NC,
         .quadhd_io_num = GPIO_NUM_NC,
-        .max_transfer_sz = EXAMPLE_LCD_H_RES * EXAMPLE_LCD_DRAW_BUFF_HEIGHT * sizeof(uint16_t),
+        .max_transfer_sz = lcd_link_cur.chunk_bytes,
+        /* Transfer-done interrupts stay off the core running the UI */
+        .isr_cpu_id = EXAMPLE_LCD_IO_CORE < 0 ? ESP_INTR_CPU_AFFINITY_AUTO :
+                      EXAMPLE_LCD_IO_CORE == 0 ? ESP_INTR_CPU_AFFINITY_0 : ESP_INTR_CPU_AFFINITY_1,
     };
     ESP_RETURN_ON_ERROR(spi_bus_initialize(EXAMPLE_LCD_SPI_NUM, &buscfg, SPI_DMA_CH_AUTO), TAG, "SPI init failed");
 
@@ -92,11 +266,12 @@ static esp_err_t app_lcd_init(void)
     const esp_lcd_panel_io_spi_config_t io_config = {
         .dc_gpio_num = EXAMPLE_LCD_GPIO_DC,
         .cs_gpio_num = EXAMPLE_LCD_GPIO_CS0,
-        .pclk_hz = EXAMPLE_LCD_PIXEL_CLK_HZ,
+        .pclk_hz = lcd_link_cur.pclk_hz,
         .lcd_cmd_bits = EXAMPLE_LCD_CMD_BITS,
         .lcd_param_bits = EXAMPLE_LCD_PARAM_BITS,
         .spi_mode = 0,
-        .trans_queue_depth = 10,
+        /* A whole draw buffer split into chunks fits in the queue */
+        .trans_queue_depth = LV_MAX(10, EXAMPLE_LCD_H_RES * EXAMPLE_LCD_DRAW_BUFF_HEIGHT * sizeof(uint16_t) / lcd_link_cur.chunk_bytes + 2),
     };
     ESP_GOTO_ON_ERROR(esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)EXAMPLE_LCD_SPI_NUM, &io_config, &lcd_io), err, TAG, "New panel IO failed");
 
@@ -116,23 +291,44 @@ static esp_err_t app_lcd_init(void)
     };
     ESP_GOTO_ON_ERROR(esp_lcd_new_panel_gc9d01(lcd_io, &panel_config, &lcd_panel), err, TAG, "New panel failed");
 
-    esp_lcd_panel_reset(lcd_panel);
-    esp_lcd_panel_init(lcd_panel);
-    esp_lcd_panel_invert_color(lcd_panel, false);
-    esp_lcd_panel_mirror(lcd_panel, true, true);
-    esp_lcd_panel_disp_on_off(lcd_panel, true);
+#if EXAMPLE_LCD_DUAL_PANEL
+    ESP_LOGI(TAG, "Install second panel IO and LCD driver");
+    esp_lcd_panel_io_spi_config_t io1_config = io_config;
+    io1_config.cs_gpio_num = EXAMPLE_LCD_GPIO_CS1;
+    ESP_GOTO_ON_ERROR(esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)EXAMPLE_LCD_SPI_NUM, &io1_config, &lcd_io1), err, TAG, "New panel IO 1 failed");
+
+    /* The reset line is shared, the second panel only gets a software reset */
+    esp_lcd_panel_dev_config_t panel1_config = panel_config;
+    panel1_config.reset_gpio_num = GPIO_NUM_NC;
+    ESP_GOTO_ON_ERROR(esp_lcd_new_panel_gc9d01(lcd_io1, &panel1_config, &lcd_panel1), err, TAG, "New panel 1 failed");
+#endif
 
-    /* LCD backlight on */
-    // ESP_ERROR_CHECK(gpio_set_level(EXAMPLE_LCD_GPIO_BL, EXAMPLE_LCD_BL_ON_LEVEL));
+    ESP_GOTO_ON_ERROR(app_lcd_panel_setup(lcd_panel), err, TAG, "Panel init failed");
+#if EXAMPLE_LCD_DUAL_PANEL
+    ESP_GOTO_ON_ERROR(app_lcd_panel_setup(lcd_panel1), err, TAG, "Panel 1 init failed");
+#endif
 
     return ret;
 
 err:
+    /* Nothing of a half initialized bus stays behind, the boot graph skips the steps needing it */
+#if EXAMPLE_LCD_DUAL_PANEL
+    if (lcd_panel1) {
+        esp_lcd_panel_del(lcd_panel1);
+        lcd_panel1 = NULL;
+    }
+    if (lcd_io1) {
+        esp_lcd_panel_io_del(lcd_io1);
+        lcd_io1 = NULL;
+    }
+#endif
     if (lcd_panel) {
         esp_lcd_panel_del(lcd_panel);
+        lcd_panel = NULL;
     }
     if (lcd_io) {
         esp_lcd_panel_io_del(lcd_io);
+        lcd_io = NULL;
     }
     spi_bus_free(EXAMPLE_LCD_SPI_NUM);
     return ret;
@@ -174,24 +370,292 @@ err:
 //     return esp_lcd_touch_new_i2c_tt21100(tp_io_handle, &tp_cfg, &touch_handle);
 // }
 
+#if EXAMPLE_LCD_PERF_DUMP_MS
+static void app_perf_dump_timer_cb(lv_timer_t *timer)
+{
+    static lvgl_tickless_stats_t last;
+    lvgl_tickless_stats_t now;
+
+    lcd_perf_dump();
+    lv_mem_app_dump();
+
+    /* The port's tick timer interrupts on top of the task wakeups unless tickless. Rates are per
+     * second and times in us, as in the lines of lcd_perf, the pipeline and lcd_power */
+    lvgl_tickless_get_stats(&now);
+    const uint32_t wakeups = (now.wakeups - last.wakeups) * 10000 / EXAMPLE_LCD_PERF_DUMP_MS;
+    const uint32_t woken = (now.woken - last.woken) * 10000 / EXAMPLE_LCD_PERF_DUMP_MS;
+    ESP_LOGI(TAG, "LVGL task %"PRIu32".%"PRIu32" wakeups/s (%"PRIu32".%"PRIu32"/s by other tasks), tick %d interrupts/s",
+             wakeups / 10, wakeups % 10, woken / 10, woken % 10, EXAMPLE_LVGL_TICKLESS ? 0 : 1000 / EXAMPLE_LVGL_TICK_MS);
+    last = now;
+#if !EXAMPLE_LCD_DUAL_PANEL && EXAMPLE_LCD_PIPE_BUFS
+    static uint64_t last_saved;
+    lcd_pipe_stats_t pipe_stats;
+    if (lcd_pipe_get_stats(&pipe_stats) == ESP_OK) {
+        ESP_LOGI(TAG, "pipe: %"PRIu32" flushed, %"PRIu32" sent, %"PRIu32" dropped, %"PRIu32" stalls (%"PRIu64" us), depth %u",
+                 pipe_stats.flushes, pipe_stats.sent, pipe_stats.dropped, pipe_stats.stalls, pipe_stats.stall_us,
+                 pipe_stats.max_depth);
+        /* The band filter and the tile diff are exclusive, only one of them counts */
+#if EXAMPLE_LCD_DEDUP_ROWS && !EXAMPLE_LCD_PARTIAL_REFRESH && !EXAMPLE_LCD_DIFF_TILE
+        const lcd_dedup_stats_t *dedup = &pipe_stats.dedup;
+        if (dedup->areas) {
+            ESP_LOGI(TAG, "dedup: %"PRIu32"/%"PRIu32" bands, %"PRIu32"/%"PRIu32" flushes skipped, %"PRIu64" B/s saved",
+                     dedup->bands_skipped, dedup->bands, dedup->areas_skipped, dedup->areas,
+                     (dedup->bytes_saved - last_saved) * 1000 / EXAMPLE_LCD_PERF_DUMP_MS);
+            last_saved = dedup->bytes_saved;
+        }
+#endif
+#if EXAMPLE_LCD_DIFF_TILE && !EXAMPLE_LCD_PARTIAL_REFRESH
+        const lcd_diff_stats_t *diff = &pipe_stats.diff;
+        if (diff->frames) {
+            ESP_LOGI(TAG, "diff: %"PRIu32" frames, %"PRIu32" unchanged, %"PRIu32" tiles, %"PRIu32" windows, %"PRIu64" B/s saved",
+                     diff->frames, diff->frames_skipped, diff->tiles_changed, diff->rects,
+                     (diff->bytes_saved - last_saved) * 1000 / EXAMPLE_LCD_PERF_DUMP_MS);
+            last_saved = diff->bytes_saved;
+        }
+#endif
+    }
+#endif
+#if EXAMPLE_LCD_POWER
+    lcd_power_stats_t power_stats;
+    if (lcd_power_get_stats(&power_stats) == ESP_OK && power_stats.wakes) {
+        ESP_LOGI(TAG, "power: %"PRIu32" sleeps, %"PRIu32" wakes, wake %"PRIu32" us (max %"PRIu32" us)",
+                 power_stats.sleeps, power_stats.wakes, power_stats.last_wake_us, power_stats.max_wake_us);
+    }
+#endif
+}
+#endif
+
+#if EXAMPLE_LVGL_MEM_PROF && EXAMPLE_LVGL_MEM_PROF_DUMP_MS
+static void app_mem_prof_timer_cb(lv_timer_t *timer)
+{
+    lv_mem_prof_dump(stdout);
+}
+#endif
+
+#if EXAMPLE_LCD_POWER && !EXAMPLE_LCD_PIPE_BUFS
+/* What the port's transfer-done callback does, lcd_power keeps its wake frame from it */
+static bool app_lcd_color_done_cb(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+{
+    lv_display_t *disp = (lv_display_t *)user_ctx;
+
+#if EXAMPLE_LCD_PERF_DUMP_MS
+    lcd_perf_flush_done(disp);
+#endif
+    lv_display_flush_ready(disp);
+    return false;
+}
+#endif
+
+static esp_err_t app_lvgl_flush_init(void)
+{
+#if EXAMPLE_LCD_PARTIAL_REFRESH && !EXAMPLE_LCD_STRIPE_ROWS
+    const lcd_partial_cfg_t partial_cfg = {
+        .align_x = EXAMPLE_LCD_PARTIAL_ALIGN_X,
+        .align_y = EXAMPLE_LCD_PARTIAL_ALIGN_Y,
+        .window_cost_px = EXAMPLE_LCD_PARTIAL_WIN_COST,
+    };
+    ESP_RETURN_ON_ERROR(lcd_partial_attach(lvgl_disp, &partial_cfg), TAG, "Partial refresh attach failed");
+#if EXAMPLE_LCD_DUAL_PANEL && !EXAMPLE_LCD_DUAL_MIRROR
+    ESP_RETURN_ON_ERROR(lcd_partial_attach(lvgl_disp1, &partial_cfg), TAG, "Partial refresh attach failed");
+#endif
+#endif
+
+    /* Big-endian draw buffers, the dual scheduler, the pipeline and the stripes swap in their own flush otherwise */
+#if EXAMPLE_LCD_DUAL_PANEL || EXAMPLE_LCD_PIPE_BUFS || EXAMPLE_LCD_STRIPE_ROWS
+    bool native = false;
+#if EXAMPLE_LCD_NATIVE_ORDER
+    native = lcd_native_attach(lvgl_disp);
+#if EXAMPLE_LCD_DUAL_PANEL && !EXAMPLE_LCD_DUAL_MIRROR
+    native = lcd_native_attach(lvgl_disp1) && native;
+#endif
+#endif
+#elif EXAMPLE_LCD_NATIVE_ORDER
+    lcd_native_attach(lvgl_disp);
+#endif
+
+#if EXAMPLE_LCD_DUAL_PANEL
+
+    /* Interleave the two panels' transfers on the shared bus, the scheduler replaces the flush callback */
+    const lcd_dual_cfg_t dual_cfg = {
+        .io = { lcd_io, lcd_io1 },
+        .panel = { lcd_panel, lcd_panel1 },
+#if EXAMPLE_LCD_DUAL_MIRROR
+        .disp = { lvgl_disp, NULL },
+#else
+        .disp = { lvgl_disp, lvgl_disp1 },
+#endif
+        .mirror = EXAMPLE_LCD_DUAL_MIRROR,
+        .swap_bytes = !native,
+        .chunk_rows = EXAMPLE_LCD_DUAL_CHUNK_ROWS,
+        .pclk_hz = lcd_link_cur.pclk_hz,
+        .task_priority = 5,
+        .task_stack = 3072,
+        .task_affinity = EXAMPLE_LCD_IO_CORE,
+    };
+    ESP_RETURN_ON_ERROR(lcd_dual_init(&dual_cfg), TAG, "Dual panel scheduler init failed");
+#elif EXAMPLE_LCD_PIPE_BUFS
+    /* Render the next area while the previous ones are queued or on the wire */
+    const lcd_pipe_cfg_t pipe_cfg = {
+        .io = lcd_io,
+        .panel = lcd_panel,
+        .disp = lvgl_disp,
+        .buf_num = EXAMPLE_LCD_PIPE_BUFS,
+        .buf_caps = lcd_buf_caps(&lcd_buf_plan_cur),
+        .drop_stale = EXAMPLE_LCD_PIPE_DROP_STALE,
+        .swap_bytes = !native,
+        .dedup_rows = EXAMPLE_LCD_PARTIAL_REFRESH || EXAMPLE_LCD_DIFF_TILE ? 0 : EXAMPLE_LCD_DEDUP_ROWS,
+        .diff_tile = EXAMPLE_LCD_PARTIAL_REFRESH ? 0 : EXAMPLE_LCD_DIFF_TILE,
+        .diff_max_rects = EXAMPLE_LCD_DIFF_MAX_RECTS,
+        .diff_window_cost_px = EXAMPLE_LCD_DIFF_WIN_COST,
+        .task_priority = 5,
+        .task_stack = 3072,
+        .task_affinity = EXAMPLE_LCD_IO_CORE,
+    };
+    ESP_RETURN_ON_ERROR(lcd_pipe_init(&pipe_cfg), TAG, "Render-ahead pipeline init failed");
+#elif EXAMPLE_LCD_STRIPE_ROWS
+    /* Whole frames rendered in short bands and written to the panel as one RAMWR sequence */
+    const lcd_stripe_cfg_t stripe_cfg = {
+        .io = lcd_io,
+        .disp = lvgl_disp,
+        .x_gap = 0,                 // app_lcd_init 未调用 esp_lcd_panel_set_gap
+        .y_gap = 0,
+        .swap_bytes = !native,
+    };
+    ESP_RETURN_ON_ERROR(lcd_stripe_attach(&stripe_cfg), TAG, "Striped refresh attach failed");
+#endif
+
+#if EXAMPLE_LCD_PERF_DUMP_MS
+    /* Frame timing, the dual panel scheduler and the pipeline own the transfer-done callbacks, lcd_power passes it on */
+#if EXAMPLE_LCD_DUAL_PANEL || EXAMPLE_LCD_PIPE_BUFS || EXAMPLE_LCD_POWER
+    ESP_RETURN_ON_ERROR(lcd_perf_attach(lvgl_disp), TAG, "Frame timing attach failed");
+#else
+    ESP_RETURN_ON_ERROR(lcd_perf_attach_io(lvgl_disp, lcd_io), TAG, "Frame timing attach failed");
+#endif
+    lv_timer_create(app_perf_dump_timer_cb, EXAMPLE_LCD_PERF_DUMP_MS, NULL);
+#endif
+
+#if EXAMPLE_LCD_POWER
+    /* Dim, then panel sleep with LVGL stopped, the wake button brings the last frame back */
+    const lcd_power_cfg_t power_cfg = {
+        .io = lcd_io,
+        .panel = lcd_panel,
+        .disp = lvgl_disp,
+        .hres = EXAMPLE_LCD_H_RES,
+        .vres = EXAMPLE_LCD_V_RES,
+        .bl_gpio = EXAMPLE_LCD_GPIO_BL,
+        .bl_on_level = EXAMPLE_LCD_BL_ON_LEVEL,
+        .dim_percent = EXAMPLE_LCD_POWER_DIM_PCT,
+        .fade_ms = EXAMPLE_LCD_POWER_FADE_MS,
+        .dim_after_ms = EXAMPLE_LCD_POWER_DIM_MS,
+        .sleep_after_ms = EXAMPLE_LCD_POWER_SLEEP_MS,
+        .wake_gpio = EXAMPLE_LCD_POWER_WAKE_GPIO,
+        .resend = true,
+        .light_sleep = EXAMPLE_LCD_POWER_LIGHT_SLEEP,
+#if !EXAMPLE_LCD_PIPE_BUFS
+        .io_done_cb = app_lcd_color_done_cb,
+        .io_done_ctx = lvgl_disp,
+#else
+        .io_done_cb = lcd_pipe_color_done_cb,
+        .on_wake = lcd_pipe_invalidate,
+#endif
+    };
+    ESP_RETURN_ON_ERROR(lcd_power_init(&power_cfg), TAG, "Display power management init failed");
+#endif
+
+    return ESP_OK;
+}
+
 static esp_err_t app_lvgl_init(void)
-{ 
+{
+#if CONFIG_LV_USE_CUSTOM_MALLOC
+    /* LVGL heap tiers, set before lv_init() */
+    const lv_mem_app_cfg_t mem_cfg = {
+        .slab_size = EXAMPLE_LVGL_MEM_SLAB_KB * 1024,
+        .mid_max = EXAMPLE_LVGL_MEM_MID_MAX,
+        .mid_budget = EXAMPLE_LVGL_MEM_MID_KB * 1024,
+        .arena_size = EXAMPLE_LVGL_MEM_ARENA_KB * 1024,
+        .trace = EXAMPLE_LVGL_MEM_TRACE,
+    };
+    ESP_RETURN_ON_ERROR(lv_mem_app_config(&mem_cfg), TAG, "LVGL heap configuration failed");
+#endif
+#if EXAMPLE_LVGL_MEM_PROF
+    /* Tag LVGL's allocations with object class and call site from the first one on */
+    ESP_RETURN_ON_FALSE(lv_mem_prof_start(EXAMPLE_LVGL_MEM_PROF) == LV_RESULT_OK, ESP_ERR_NO_MEM, TAG,
+                        "LVGL heap profiler failed");
+#endif
+
     /* Initialize LVGL */
     const lvgl_port_cfg_t lvgl_cfg = {
         .task_priority = 4,         /* LVGL task priority */
         .task_stack = 4096,         /* LVGL task stack size */
-        .task_affinity = -1,        /* LVGL task pinned to core (-1 is no affinity) */
-        .task_max_sleep_ms = 500,   /* Maximum sleep in LVGL task */
-        .timer_period_ms = 5        /* LVGL timer tick period in ms */
+        .task_affinity = EXAMPLE_LVGL_TASK_CORE,    /* LVGL task pinned to core (-1 is no affinity) */
+        .task_max_sleep_ms = 500,   /* Maximum sleep in LVGL task, also bounds a missed tickless wakeup */
+        .timer_period_ms = EXAMPLE_LVGL_TICK_MS     /* LVGL timer tick period in ms */
     };
     ESP_RETURN_ON_ERROR(lvgl_port_init(&lvgl_cfg), TAG, "LVGL port initialization failed");
 
+    /* Compressed images (img_c565.h) are decoded band by band while drawing */
+    lvgl_port_lock(0);
+    esp_err_t ret = img_c565_init();
+    lvgl_port_unlock();
+    ESP_RETURN_ON_ERROR(ret, TAG, "C565 decoder failed");
+
+#if EXAMPLE_LVGL_TICKLESS
+    /* Sleep until the next LVGL timer or invalidation instead of waking on every tick */
+    lvgl_port_lock(0);
+    ret = lvgl_tickless_enable();
+    lvgl_port_unlock();
+    ESP_RETURN_ON_ERROR(ret, TAG, "Tickless mode failed");
+#endif
+#if EXAMPLE_LVGL_MEM_PROF && EXAMPLE_LVGL_MEM_PROF_DUMP_MS
+    lvgl_port_lock(0);
+    lv_timer_create(app_mem_prof_timer_cb, EXAMPLE_LVGL_MEM_PROF_DUMP_MS, NULL);
+    lvgl_port_unlock();
+#endif
+
+    return ESP_OK;
+}
+
+static esp_err_t app_lvgl_disp_init(void)
+{
+    /* Place the draw buffers in internal DMA SRAM when what is left after the drivers allows it */
+    uint8_t buf_num = EXAMPLE_LCD_DRAW_BUFF_DOUBLE ? 2 : 1;
+#if EXAMPLE_LCD_DUAL_PANEL && !EXAMPLE_LCD_DUAL_MIRROR
+    buf_num *= 2;
+#elif !EXAMPLE_LCD_DUAL_PANEL && EXAMPLE_LCD_PIPE_BUFS
+    buf_num = EXAMPLE_LCD_PIPE_BUFS;
+#endif
+    const lcd_buf_req_t buf_req = {
+        .policy = EXAMPLE_LCD_BUFF_POLICY,
+        .hres = EXAMPLE_LCD_H_RES,
+        .rows = EXAMPLE_LCD_STRIPE_ROWS ? EXAMPLE_LCD_STRIPE_ROWS : EXAMPLE_LCD_DRAW_BUFF_HEIGHT,
+        .min_rows = EXAMPLE_LCD_BUFF_MIN_ROWS,
+        .px_size = sizeof(uint16_t),
+        .buf_num = buf_num,
+        .full_refresh = !EXAMPLE_LCD_PARTIAL_REFRESH && !EXAMPLE_LCD_STRIPE_ROWS,
+        .reserve_bytes = EXAMPLE_LCD_BUFF_RESERVE + EXAMPLE_LCD_DIFF_BYTES,
+    };
+    ESP_RETURN_ON_ERROR(lcd_buf_plan(&buf_req, &lcd_buf_plan_cur), TAG, "Draw buffer placement failed");
+
+#if EXAMPLE_LCD_SPLASH
+    /* The port takes over the panel IO callback, the splash has to be out by now: a chunk still
+     * queued would complete into the port's callback and release a flush LVGL never started */
+    ESP_RETURN_ON_ERROR(lcd_splash_wait(100), TAG, "Splash still on the bus");
+#if !EXAMPLE_LCD_DUAL_PANEL && EXAMPLE_LCD_PIPE_BUFS
+    /* The panel shows the splash, not a frame the pipeline sent */
+    lcd_pipe_invalidate();
+#endif
+#endif
+#if EXAMPLE_LCD_BUFF_PROBE
+    lcd_buf_probe(&lcd_buf_plan_cur);
+#endif
+
     /* Add LCD screen */
     ESP_LOGD(TAG, "Add LCD screen");
     const lvgl_port_display_cfg_t disp_cfg = {
         .io_handle = lcd_io,
         .panel_handle = lcd_panel,
-        .buffer_size = EXAMPLE_LCD_H_RES * EXAMPLE_LCD_DRAW_BUFF_HEIGHT,
+        .buffer_size = EXAMPLE_LCD_H_RES * lcd_buf_plan_cur.rows,
         .double_buffer = EXAMPLE_LCD_DRAW_BUFF_DOUBLE,
         .hres = EXAMPLE_LCD_H_RES,
         .vres = EXAMPLE_LCD_V_RES,
@@ -206,14 +670,31 @@ static esp_err_t app_lvgl_init(void)
         },
         .flags = {
             .buff_dma = true,
-            .buff_spiram = true,    // 双缓冲+DMA使用外部PSRAM
+            .buff_spiram = lcd_buf_plan_cur.place == LCD_BUF_PLACE_PSRAM,
 #if LVGL_VERSION_MAJOR >= 9
-            .swap_bytes = true,
+            .swap_bytes = !EXAMPLE_LCD_NATIVE_ORDER,    // 字节序由 lcd_native 处理
 #endif
-            .full_refresh = true,   // 这个屌屏幕驱动局部刷新会有乱点
+            .full_refresh = !EXAMPLE_LCD_PARTIAL_REFRESH && !EXAMPLE_LCD_STRIPE_ROWS,   // 这个屌屏幕驱动局部刷新会有乱点，局部刷新需对齐窗口
         }
     };
     lvgl_disp = lvgl_port_add_disp(&disp_cfg);
+    ESP_RETURN_ON_FALSE(lvgl_disp, ESP_FAIL, TAG, "Add LVGL display failed");
+
+    esp_err_t ret = ESP_OK;
+#if EXAMPLE_LCD_DUAL_PANEL && !EXAMPLE_LCD_DUAL_MIRROR
+    /* Add second LCD screen */
+    lvgl_port_display_cfg_t disp1_cfg = disp_cfg;
+    disp1_cfg.io_handle = lcd_io1;
+    disp1_cfg.panel_handle = lcd_panel1;
+    lvgl_disp1 = lvgl_port_add_disp(&disp1_cfg);
+    ESP_GOTO_ON_FALSE(lvgl_disp1, ESP_FAIL, err, TAG, "Add second LVGL display failed");
+#endif
+
+    /* Hook the refresh helpers into the display(s) */
+    lvgl_port_lock(0);
+    ret = app_lvgl_flush_init();
+    lvgl_port_unlock();
+    ESP_GOTO_ON_ERROR(ret, err, TAG, "Flush helpers initialization failed");
 
     // /* Add touch input (for selected screen) */
     // const lvgl_port_touch_cfg_t touch_cfg = {
@@ -223,6 +704,18 @@ static esp_err_t app_lvgl_init(void)
     // lvgl_touch_indev = lvgl_port_add_touch(&touch_cfg);
 
     return ESP_OK;
+
+err:
+    /* A display without its flush helpers would render with the wrong byte order or callbacks */
+#if EXAMPLE_LCD_DUAL_PANEL && !EXAMPLE_LCD_DUAL_MIRROR
+    if (lvgl_disp1) {
+        lvgl_port_remove_disp(lvgl_disp1);
+        lvgl_disp1 = NULL;
+    }
+#endif
+    lvgl_port_remove_disp(lvgl_disp);
+    lvgl_disp = NULL;
+    return ret;
 }
 
 static void app_main_display(void)
@@ -236,24 +729,115 @@ static void app_main_display(void)
     // lv_disp_set_rotation(lvgl_disp, LV_DISPLAY_ROTATION_0);
 
     /* Your LVGL objects code here .... */
-
-    lv_example_gif_1();
+    app_ui_create(scr, &app_ui_cfg);
+
+#if EXAMPLE_LCD_DUAL_PANEL && !EXAMPLE_LCD_DUAL_MIRROR
+    /* Second eye gets its own screen, the GIF asset is shared with the first one */
+    app_ui_cfg_t ui_cfg1 = app_ui_cfg;
+    ui_cfg1.gif = &img_bulb_gif1;
+    lv_display_set_default(lvgl_disp1);
+    app_ui_create(lv_screen_active(), &ui_cfg1);
+    lv_display_set_default(lvgl_disp);
+#endif
 
     /* Task unlock */
     lvgl_port_unlock();
 }
 
-void app_main(void)
+/* Boot steps, independent ones run at the same time on both cores */
+enum {
+    APP_BOOT_LINK,      /* NVS, SPI link tuning */
+    APP_BOOT_LCD,       /* SPI bus, panel reset and init sequence, splash */
+    APP_BOOT_SIMD,      /* RGB565 kernel self-test and benchmark */
+    APP_BOOT_LVGL,      /* LVGL core, heap and task */
+    APP_BOOT_ASSETS,    /* GIF decoding */
+    APP_BOOT_DISP,      /* Draw buffers, LVGL display, flush helpers */
+    APP_BOOT_UI,        /* First screen */
+    APP_BOOT_NUM,
+};
+
+static esp_err_t app_boot_link(void)
+{
+#if EXAMPLE_LCD_LINK_TUNE
+    /* NVS keeps the tuned SPI link settings */
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_RETURN_ON_ERROR(nvs_flash_erase(), TAG, "NVS erase failed");
+        ret = nvs_flash_init();
+    }
+    ESP_RETURN_ON_ERROR(ret, TAG, "NVS initialization failed");
+
+    /* ESP-side check of SPI clock and transaction size (lcd_link.h), the bus is set up again right after */
+    ESP_RETURN_ON_ERROR(app_link_tune(), TAG, "SPI link tuning failed");
+#endif
+    return ESP_OK;
+}
+
+static esp_err_t app_boot_lcd(void)
 {
     /* LCD HW initialization */
-    ESP_ERROR_CHECK(app_lcd_init());
+    ESP_RETURN_ON_ERROR(app_lcd_init(), TAG, "LCD initialization failed");
+
+#if EXAMPLE_LCD_SPLASH
+    /* First pixels from flash, the other steps run while they are on the wire */
+    ESP_RETURN_ON_ERROR(lcd_splash_show(lcd_io, lcd_panel, &splash_bulb), TAG, "Splash failed");
+#endif
+    return ESP_OK;
+}
 
+static esp_err_t app_boot_simd(void)
+{
+    /* RGB565 vector kernels, checked against the C versions before use */
+    lcd_simd_init();
+#if EXAMPLE_LCD_SIMD_BENCH
+    lcd_simd_bench();
+#endif
+    return ESP_OK;
+}
+
+static esp_err_t app_boot_assets(void)
+{
+#if !EXAMPLE_GIF_USE_A565 && EXAMPLE_GIF_PREDECODE
+    /* Decode the GIF while the panel initializes, the A565 animation needs no decoding */
+    lvgl_port_lock(0);
+    esp_err_t ret = gif_cache_preload(app_ui_cfg.gif, &app_ui_cfg.gif_cfg);
+    lvgl_port_unlock();
+    ESP_RETURN_ON_ERROR(ret, TAG, "GIF decoding failed");
+#endif
+    return ESP_OK;
+}
+
+static esp_err_t app_boot_ui(void)
+{
     /* Touch initialization */
     // ESP_ERROR_CHECK(app_touch_init());
 
-    /* LVGL initialization */
-    ESP_ERROR_CHECK(app_lvgl_init());
-
     /* Show LVGL objects */
     app_main_display();
+    return ESP_OK;
+}
+
+/* Panel IO on its core with LVGL, whose init fills the panel reset delays; CPU-bound steps on the UI core */
+static const boot_graph_step_t app_boot_steps[APP_BOOT_NUM] = {
+    [APP_BOOT_LINK] = { "link", app_boot_link, 0, EXAMPLE_LCD_IO_CORE },
+    [APP_BOOT_LCD] = { "lcd", app_boot_lcd, BOOT_GRAPH_DEP(APP_BOOT_LINK), EXAMPLE_LCD_IO_CORE },
+    [APP_BOOT_SIMD] = { "simd", app_boot_simd, 0, EXAMPLE_LVGL_TASK_CORE },
+    [APP_BOOT_LVGL] = { "lvgl", app_lvgl_init, 0, EXAMPLE_LCD_IO_CORE },
+    [APP_BOOT_ASSETS] = { "assets", app_boot_assets, BOOT_GRAPH_DEP(APP_BOOT_LVGL), EXAMPLE_LVGL_TASK_CORE },
+    /* The buffer probe times the byte swap, with the vector kernels once they are checked */
+    [APP_BOOT_DISP] = { "disp", app_lvgl_disp_init, BOOT_GRAPH_DEP(APP_BOOT_LCD) | BOOT_GRAPH_DEP(APP_BOOT_SIMD) | BOOT_GRAPH_DEP(APP_BOOT_LVGL), -1 },
+    [APP_BOOT_UI] = { "ui", app_boot_ui, BOOT_GRAPH_DEP(APP_BOOT_DISP) | BOOT_GRAPH_DEP(APP_BOOT_ASSETS), -1 },
+};
+
+void app_main(void)
+{
+    /* Everything up to the first screen, joined before returning */
+    ESP_ERROR_CHECK(boot_graph_run(app_boot_steps, APP_BOOT_NUM, !EXAMPLE_BOOT_PARALLEL));
+
+#if EXAMPLE_LVGL_SCENE_BENCH
+    /* Render speed of a few heavier scenes, the first screen is shown again afterwards */
+    lvgl_port_lock(0);
+    scene_bench_run(lvgl_disp, EXAMPLE_LVGL_SCENE_BENCH);
+    lvgl_port_unlock();
+#endif
 }
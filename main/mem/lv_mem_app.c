@@ -0,0 +1,253 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_rom_sys.h"
+#include "multi_heap.h"
+#include "lvgl.h"
+#include "lv_mem_app.h"
+
+#if LV_USE_STDLIB_MALLOC == LV_STDLIB_CUSTOM
+
+static const char *TAG = "lv_mem_app";
+
+static lv_mem_app_cfg_t mem_cfg = {
+    .slab_size = 32 * 1024,
+    .mid_max = 4 * 1024,
+    .mid_budget = 32 * 1024,
+    .arena_size = 1024 * 1024,
+};
+
+static tier_alloc_t mem_ta;
+static lv_mutex_t mem_lock;
+static void *mem_slab_buf;
+static uint8_t *mem_arena_buf;
+static multi_heap_handle_t mem_arena;
+static bool mem_ready;
+
+esp_err_t lv_mem_app_config(const lv_mem_app_cfg_t *cfg)
+{
+    ESP_RETURN_ON_FALSE(cfg, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(!mem_ready, ESP_ERR_INVALID_STATE, TAG, "LVGL heap already set up");
+
+    mem_cfg = *cfg;
+    return ESP_OK;
+}
+
+static void *lv_mem_app_mid_alloc(void *user, size_t size)
+{
+    return heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+}
+
+static void lv_mem_app_mid_free(void *user, void *ptr)
+{
+    heap_caps_free(ptr);
+}
+
+/* Arena first, the default heap once it is full */
+static void *lv_mem_app_large_alloc(void *user, size_t size)
+{
+    void *ptr = mem_arena ? multi_heap_malloc(mem_arena, size) : NULL;
+    if (!ptr) {
+        ptr = heap_caps_malloc_prefer(size, 2, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT, MALLOC_CAP_DEFAULT);
+    }
+    return ptr;
+}
+
+static void lv_mem_app_large_free(void *user, void *ptr)
+{
+    const uint8_t *p = ptr;
+    if (mem_arena && p >= mem_arena_buf && p < mem_arena_buf + mem_cfg.arena_size) {
+        multi_heap_free(mem_arena, ptr);
+    } else {
+        heap_caps_free(ptr);
+    }
+}
+
+void lv_mem_init(void)
+{
+    mem_slab_buf = mem_cfg.slab_size ? heap_caps_malloc(mem_cfg.slab_size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT) : NULL;
+    if (mem_cfg.slab_size && !mem_slab_buf) {
+        ESP_LOGW(TAG, "No internal RAM for the slabs, small blocks come from the heaps");
+    }
+    if (mem_cfg.arena_size) {
+        mem_arena_buf = heap_caps_malloc(mem_cfg.arena_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        mem_arena = mem_arena_buf ? multi_heap_register(mem_arena_buf, mem_cfg.arena_size) : NULL;
+        if (!mem_arena) {
+            ESP_LOGW(TAG, "No PSRAM arena, large blocks come from the default heap");
+        }
+    }
+
+    const tier_alloc_cfg_t cfg = {
+        .slab_mem = mem_slab_buf,
+        .slab_size = mem_slab_buf ? mem_cfg.slab_size : 0,
+        .mid = { lv_mem_app_mid_alloc, lv_mem_app_mid_free, NULL },
+        .mid_max = mem_cfg.mid_max,
+        .mid_budget = mem_cfg.mid_budget,
+        .large = { lv_mem_app_large_alloc, lv_mem_app_large_free, NULL },
+    };
+    tier_alloc_init(&mem_ta, &cfg);
+    lv_mutex_init(&mem_lock);
+    mem_ready = true;
+
+    ESP_LOGI(TAG, "slabs %u KB internal, mid <= %u B within %u KB internal, arena %u KB PSRAM",
+             (unsigned)(cfg.slab_size / 1024), (unsigned)mem_cfg.mid_max, (unsigned)(mem_cfg.mid_budget / 1024),
+             mem_arena ? (unsigned)(mem_cfg.arena_size / 1024) : 0);
+}
+
+void lv_mem_deinit(void)
+{
+    lv_mutex_delete(&mem_lock);
+    heap_caps_free(mem_slab_buf);
+    heap_caps_free(mem_arena_buf);
+    mem_slab_buf = NULL;
+    mem_arena_buf = NULL;
+    mem_arena = NULL;
+    mem_ready = false;
+}
+
+lv_mem_pool_t lv_mem_add_pool(void *mem, size_t bytes)
+{
+    LV_LOG_WARN("pools are not supported, the arena grows into the default heap");
+    return NULL;
+}
+
+void lv_mem_remove_pool(lv_mem_pool_t pool)
+{
+}
+
+void *lv_malloc_core(size_t size)
+{
+    lv_mutex_lock(&mem_lock);
+    void *ptr = tier_alloc_malloc(&mem_ta, size);
+    if (mem_cfg.trace) {
+        esp_rom_printf("LVMEM a %x %u\n", (unsigned)(uintptr_t)ptr, (unsigned)size);
+    }
+    lv_mutex_unlock(&mem_lock);
+    return ptr;
+}
+
+void *lv_realloc_core(void *p, size_t new_size)
+{
+    lv_mutex_lock(&mem_lock);
+    void *ptr = tier_alloc_realloc(&mem_ta, p, new_size);
+    if (mem_cfg.trace) {
+        esp_rom_printf("LVMEM r %x %x %u\n", (unsigned)(uintptr_t)p, (unsigned)(uintptr_t)ptr, (unsigned)new_size);
+    }
+    lv_mutex_unlock(&mem_lock);
+    return ptr;
+}
+
+void lv_free_core(void *p)
+{
+    lv_mutex_lock(&mem_lock);
+    if (mem_cfg.trace) {
+        esp_rom_printf("LVMEM f %x\n", (unsigned)(uintptr_t)p);
+    }
+    tier_alloc_free(&mem_ta, p);
+    lv_mutex_unlock(&mem_lock);
+}
+
+void lv_mem_monitor_core(lv_mem_monitor_t *mon_p)
+{
+    multi_heap_info_t arena = { 0 };
+    size_t peak = 0;
+
+    memset(mon_p, 0, sizeof(*mon_p));
+    if (mem_arena) {
+        multi_heap_get_info(mem_arena, &arena);
+    }
+
+    lv_mutex_lock(&mem_lock);
+    const tier_alloc_class_stats_t *mid = tier_alloc_get_stats(&mem_ta, TIER_ALLOC_CLASS_MID);
+    const size_t slab_free = tier_alloc_slab_free(&mem_ta);
+    const size_t mid_free = mem_cfg.mid_budget > mid->bytes ? mem_cfg.mid_budget - mid->bytes : 0;
+    for (int cls = 0; cls < TIER_ALLOC_CLASSES; cls++) {
+        const tier_alloc_class_stats_t *st = tier_alloc_get_stats(&mem_ta, cls);
+        mon_p->used_cnt += st->used;
+        peak += st->peak_bytes;
+    }
+    lv_mutex_unlock(&mem_lock);
+
+    mon_p->total_size = mem_ta.page_cnt * TIER_ALLOC_PAGE_SIZE + mem_cfg.mid_budget +
+                        (mem_arena ? mem_cfg.arena_size : 0);
+    mon_p->free_size = slab_free + mid_free + arena.total_free_bytes;
+    mon_p->free_biggest_size = LV_MAX(arena.largest_free_block, LV_MIN(mid_free, mem_cfg.mid_max));
+    mon_p->free_cnt = arena.free_blocks;
+    mon_p->max_used = peak;     /* Sum of the class peaks, an upper bound */
+    if (mon_p->total_size) {
+        mon_p->used_pct = 100 - (uint8_t)((uint64_t)mon_p->free_size * 100 / mon_p->total_size);
+    }
+    if (arena.total_free_bytes) {
+        mon_p->frag_pct = 100 - (uint8_t)((uint64_t)arena.largest_free_block * 100 / arena.total_free_bytes);
+    }
+}
+
+lv_result_t lv_mem_test_core(void)
+{
+    lv_mutex_lock(&mem_lock);
+    bool ok = tier_alloc_check(&mem_ta);
+    lv_mutex_unlock(&mem_lock);
+    if (mem_arena) {
+        ok = multi_heap_check(mem_arena, true) && ok;
+    }
+    return ok ? LV_RESULT_OK : LV_RESULT_INVALID;
+}
+
+esp_err_t lv_mem_app_get_stats(int cls, tier_alloc_class_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(stats && cls >= 0 && cls < TIER_ALLOC_CLASSES, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(mem_ready, ESP_ERR_INVALID_STATE, TAG, "LVGL heap not set up");
+
+    lv_mutex_lock(&mem_lock);
+    *stats = *tier_alloc_get_stats(&mem_ta, cls);
+    lv_mutex_unlock(&mem_lock);
+    return ESP_OK;
+}
+
+void lv_mem_app_dump(void)
+{
+    tier_alloc_class_stats_t st;
+
+    ESP_LOGI(TAG, "class   used   peak   allocs  spills pages  peak KB");
+    for (int cls = 0; cls < TIER_ALLOC_CLASSES; cls++) {
+        if (lv_mem_app_get_stats(cls, &st) != ESP_OK || !st.allocs) {
+            continue;
+        }
+        const char *name = cls == TIER_ALLOC_CLASS_MID ? "mid" : cls == TIER_ALLOC_CLASS_LARGE ? "large" : NULL;
+        char size[8];
+        snprintf(size, sizeof(size), "%"PRIu32, st.size);
+        ESP_LOGI(TAG, "%-6s %6"PRIu32" %6"PRIu32" %8"PRIu32" %6"PRIu32" %5"PRIu32" %8u", name ? name : size,
+                 st.used, st.peak, st.allocs, st.fails, st.pages, (unsigned)(st.peak_bytes / 1024));
+    }
+    if (mem_arena) {
+        multi_heap_info_t info;
+        multi_heap_get_info(mem_arena, &info);
+        ESP_LOGI(TAG, "arena %u KB free, largest block %u KB, low water %u KB", (unsigned)(info.total_free_bytes / 1024),
+                 (unsigned)(info.largest_free_block / 1024), (unsigned)(info.minimum_free_bytes / 1024));
+    }
+}
+
+#else
+
+esp_err_t lv_mem_app_config(const lv_mem_app_cfg_t *cfg)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t lv_mem_app_get_stats(int cls, tier_alloc_class_stats_t *stats)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void lv_mem_app_dump(void)
+{
+}
+
+#endif
@@ -0,0 +1,60 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * LVGL heap on the tiered allocator (tier_alloc.h), selected with CONFIG_LV_USE_CUSTOM_MALLOC.
+ *
+ * Blocks up to TIER_ALLOC_SLAB_MAX (styles, areas, draw tasks, list nodes) come from slabs
+ * in internal RAM, blocks up to `mid_max` from the internal heap within `mid_budget`, and
+ * images, layers and other large buffers from an arena in PSRAM, so LVGL is no longer
+ * limited to a fixed builtin pool.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "tier_alloc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Heap configuration
+ */
+typedef struct {
+    size_t slab_size;           /* Internal RAM for the slab classes */
+    size_t mid_max;             /* Largest block of the internal heap tier */
+    size_t mid_budget;          /* Internal RAM the mid tier may hold */
+    size_t arena_size;          /* PSRAM arena for the rest, 0 to use the default heap */
+    bool trace;                 /* Print every call as an "LVMEM" line for tools/alloc_replay.c */
+} lv_mem_app_cfg_t;
+
+/**
+ * @brief Set the heap configuration, before lv_init()
+ *
+ * @param cfg Configuration
+ * @return ESP_ERR_INVALID_STATE if LVGL's heap is already set up
+ */
+esp_err_t lv_mem_app_config(const lv_mem_app_cfg_t *cfg);
+
+/**
+ * @brief Get the statistics of a size class or heap tier
+ *
+ * @param cls   Slab class, TIER_ALLOC_CLASS_MID or TIER_ALLOC_CLASS_LARGE
+ * @param stats Filled with the statistics
+ * @return ESP_OK on success
+ */
+esp_err_t lv_mem_app_get_stats(int cls, tier_alloc_class_stats_t *stats);
+
+/**
+ * @brief Log the per-class statistics and the arena usage
+ */
+void lv_mem_app_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
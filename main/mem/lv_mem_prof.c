@@ -0,0 +1,481 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lv_mem_prof.h"
+#include "src/core/lv_obj_class_private.h"
+
+#define LV_MEM_PROF_CLASSES     (48)    /* Object classes, the first one is "no object" */
+#define LV_MEM_PROF_SITES       (512)   /* Call site / class pairs, power of two */
+#define LV_MEM_PROF_SITE_OTHER  (LV_MEM_PROF_SITES)     /* Sites past the table */
+#define LV_MEM_PROF_DEPTH       (8)     /* Nested object classes per thread */
+#define LV_MEM_PROF_FRAG_EVERY  (1024)  /* Allocations between fragmentation samples */
+#define LV_MEM_PROF_TOP_SITES   (16)
+
+typedef struct {
+    uint32_t live_blocks;
+    uint32_t live_bytes;
+    uint32_t peak_bytes;
+    uint32_t allocs;
+} lv_mem_prof_count_t;
+
+typedef struct {
+    const lv_obj_class_t *cls;
+    lv_mem_prof_count_t cnt;
+} lv_mem_prof_class_t;
+
+typedef struct {
+    uintptr_t addr;             /* 0 for an empty slot */
+    uint8_t cls;
+    lv_mem_prof_count_t cnt;
+} lv_mem_prof_site_t;
+
+typedef struct {
+    void *ptr;                  /* NULL for an empty slot */
+    uint32_t size;
+    uint16_t site;
+    uint8_t cls;
+} lv_mem_prof_block_t;
+
+typedef struct {
+    lv_mutex_t lock;
+    bool on;
+    bool dumped;                /* Report printed for a failed allocation */
+    lv_mem_prof_block_t *blocks;
+    uint32_t block_mask;
+    uint32_t block_max;         /* Load limit of the open addressing */
+    lv_mem_prof_class_t classes[LV_MEM_PROF_CLASSES];
+    uint32_t class_cnt;
+    lv_mem_prof_site_t sites[LV_MEM_PROF_SITES + 1];
+    uint32_t site_cnt;
+    lv_mem_prof_totals_t totals;
+} lv_mem_prof_ctx_t;
+
+static lv_mem_prof_ctx_t prof;
+
+/* Objects being created, initialized or handling an event in this thread */
+static __thread const lv_obj_class_t *owner_stack[LV_MEM_PROF_DEPTH];
+static __thread uint32_t owner_depth;
+
+void *__real_lv_malloc(size_t size);
+void *__real_lv_malloc_zeroed(size_t size);
+void *__real_lv_realloc(void *data, size_t size);
+void __real_lv_free(void *data);
+lv_obj_t *__real_lv_obj_class_create_obj(const lv_obj_class_t *class_p, lv_obj_t *parent);
+void __real_lv_obj_class_init_obj(lv_obj_t *obj);
+lv_result_t __real_lv_obj_send_event(lv_obj_t *obj, lv_event_code_t event_code, void *param);
+
+static inline void lv_mem_prof_push(const lv_obj_class_t *cls)
+{
+    if (owner_depth < LV_MEM_PROF_DEPTH) {
+        owner_stack[owner_depth] = cls;
+    }
+    owner_depth++;
+}
+
+static inline void lv_mem_prof_pop(void)
+{
+    owner_depth--;
+}
+
+static inline const lv_obj_class_t *lv_mem_prof_owner(void)
+{
+    return owner_depth ? owner_stack[LV_MIN(owner_depth, LV_MEM_PROF_DEPTH) - 1] : NULL;
+}
+
+/* Call sites as printed, relative to this file's code on the host where the image moves */
+static long lv_mem_prof_site_addr(uintptr_t addr)
+{
+#ifdef ESP_PLATFORM
+    return (long)addr;
+#else
+    return (long)(addr - (uintptr_t)&lv_mem_prof_start);
+#endif
+}
+
+static inline uint32_t lv_mem_prof_slot(const void *ptr)
+{
+    return (uint32_t)(((uintptr_t)ptr >> 3) * 2654435761u) & prof.block_mask;
+}
+
+static uint32_t lv_mem_prof_class(const lv_obj_class_t *cls)
+{
+    if (!cls) {
+        return 0;
+    }
+    for (uint32_t i = 1; i < prof.class_cnt; i++) {
+        if (prof.classes[i].cls == cls) {
+            return i;
+        }
+    }
+    if (prof.class_cnt == LV_MEM_PROF_CLASSES) {
+        return 0;
+    }
+    prof.classes[prof.class_cnt].cls = cls;
+    return prof.class_cnt++;
+}
+
+static uint32_t lv_mem_prof_site(uintptr_t addr, uint8_t cls)
+{
+    uint32_t i = (uint32_t)((addr >> 1) * 2654435761u + cls) & (LV_MEM_PROF_SITES - 1);
+
+    while (prof.sites[i].addr) {
+        if (prof.sites[i].addr == addr && prof.sites[i].cls == cls) {
+            return i;
+        }
+        i = (i + 1) & (LV_MEM_PROF_SITES - 1);
+    }
+    if (prof.site_cnt >= LV_MEM_PROF_SITES * 3 / 4) {
+        return LV_MEM_PROF_SITE_OTHER;
+    }
+    prof.sites[i].addr = addr;
+    prof.sites[i].cls = cls;
+    prof.site_cnt++;
+    return i;
+}
+
+static void lv_mem_prof_count_add(lv_mem_prof_count_t *cnt, uint32_t size)
+{
+    cnt->live_blocks++;
+    cnt->live_bytes += size;
+    cnt->allocs++;
+    cnt->peak_bytes = LV_MAX(cnt->peak_bytes, cnt->live_bytes);
+}
+
+static void lv_mem_prof_count_sub(lv_mem_prof_count_t *cnt, uint32_t size)
+{
+    cnt->live_blocks--;
+    cnt->live_bytes -= size;
+}
+
+/* Lock held, false if the table is full */
+static bool lv_mem_prof_insert(void *ptr, uint32_t size, uint32_t site, uint32_t cls)
+{
+    if (prof.totals.live_blocks >= prof.block_max) {
+        prof.totals.untracked++;
+        return false;
+    }
+    uint32_t i = lv_mem_prof_slot(ptr);
+    while (prof.blocks[i].ptr) {
+        i = (i + 1) & prof.block_mask;
+    }
+    prof.blocks[i] = (lv_mem_prof_block_t) {
+        .ptr = ptr, .size = size, .site = site, .cls = cls,
+    };
+
+    lv_mem_prof_count_add(&prof.classes[cls].cnt, size);
+    lv_mem_prof_count_add(&prof.sites[site].cnt, size);
+    prof.totals.live_blocks++;
+    prof.totals.live_bytes += size;
+    prof.totals.allocs++;
+    prof.totals.peak_bytes = LV_MAX(prof.totals.peak_bytes, prof.totals.live_bytes);
+    return true;
+}
+
+/* Lock held, backward shift deletion keeps the probe chains intact */
+static bool lv_mem_prof_remove(const void *ptr, lv_mem_prof_block_t *out)
+{
+    uint32_t i = lv_mem_prof_slot(ptr);
+
+    while (prof.blocks[i].ptr != ptr) {
+        if (!prof.blocks[i].ptr) {
+            return false;
+        }
+        i = (i + 1) & prof.block_mask;
+    }
+    const lv_mem_prof_block_t b = prof.blocks[i];
+    lv_mem_prof_count_sub(&prof.classes[b.cls].cnt, b.size);
+    lv_mem_prof_count_sub(&prof.sites[b.site].cnt, b.size);
+    prof.totals.live_blocks--;
+    prof.totals.live_bytes -= b.size;
+    if (out) {
+        *out = b;
+    }
+
+    for (uint32_t j = i;;) {
+        j = (j + 1) & prof.block_mask;
+        if (!prof.blocks[j].ptr) {
+            break;
+        }
+        const uint32_t k = lv_mem_prof_slot(prof.blocks[j].ptr);
+        if (i <= j ? (k <= i || k > j) : (k <= i && k > j)) {
+            prof.blocks[i] = prof.blocks[j];
+            i = j;
+        }
+    }
+    prof.blocks[i].ptr = NULL;
+    return true;
+}
+
+static void lv_mem_prof_sample(void)
+{
+    lv_mem_monitor_t mon;
+
+    lv_mem_monitor(&mon);
+    lv_mutex_lock(&prof.lock);
+    prof.totals.frag_pct = mon.frag_pct;
+    prof.totals.frag_pct_max = LV_MAX(prof.totals.frag_pct_max, mon.frag_pct);
+    prof.totals.biggest_free_min = LV_MIN(prof.totals.biggest_free_min, (uint32_t)mon.free_biggest_size);
+    lv_mutex_unlock(&prof.lock);
+}
+
+static void lv_mem_prof_track(void *ptr, size_t size, void *ra)
+{
+    bool sample = false;
+    bool dump = false;
+
+    if (!prof.on || !size) {
+        return;
+    }
+
+    lv_mutex_lock(&prof.lock);
+    if (ptr) {
+        const uint32_t cls = lv_mem_prof_class(lv_mem_prof_owner());
+        const uint32_t site = lv_mem_prof_site((uintptr_t)ra, cls);
+        lv_mem_prof_insert(ptr, size, site, cls);
+        sample = prof.totals.allocs % LV_MEM_PROF_FRAG_EVERY == 0;
+    } else {
+        prof.totals.fails++;
+        dump = !prof.dumped;
+        prof.dumped = true;
+    }
+    lv_mutex_unlock(&prof.lock);
+
+    if (dump) {
+        LV_LOG_ERROR("allocation of %u bytes failed", (unsigned)size);
+        lv_mem_prof_sample();
+        lv_mem_prof_dump(stdout);
+    } else if (sample) {
+        lv_mem_prof_sample();
+    }
+}
+
+void *__wrap_lv_malloc(size_t size)
+{
+    void *ptr = __real_lv_malloc(size);
+    lv_mem_prof_track(ptr, size, __builtin_return_address(0));
+    return ptr;
+}
+
+void *__wrap_lv_malloc_zeroed(size_t size)
+{
+    void *ptr = __real_lv_malloc_zeroed(size);
+    lv_mem_prof_track(ptr, size, __builtin_return_address(0));
+    return ptr;
+}
+
+void *__wrap_lv_realloc(void *data, size_t size)
+{
+    lv_mem_prof_block_t old;
+    bool known = false;
+
+    /* Dropped before the call, another thread may get the address right after */
+    if (prof.on && data) {
+        lv_mutex_lock(&prof.lock);
+        known = lv_mem_prof_remove(data, &old);
+        lv_mutex_unlock(&prof.lock);
+    }
+
+    void *ptr = __real_lv_realloc(data, size);
+    if (!ptr && size && known) {
+        /* Failed, the block stays where it was */
+        lv_mutex_lock(&prof.lock);
+        if (lv_mem_prof_insert(data, old.size, old.site, old.cls)) {
+            prof.totals.allocs--;
+            prof.classes[old.cls].cnt.allocs--;
+            prof.sites[old.site].cnt.allocs--;
+        }
+        lv_mutex_unlock(&prof.lock);
+    }
+    lv_mem_prof_track(ptr, size, __builtin_return_address(0));
+    return ptr;
+}
+
+void __wrap_lv_free(void *data)
+{
+    if (prof.on && data) {
+        lv_mutex_lock(&prof.lock);
+        lv_mem_prof_remove(data, NULL);
+        lv_mutex_unlock(&prof.lock);
+    }
+    __real_lv_free(data);
+}
+
+lv_obj_t *__wrap_lv_obj_class_create_obj(const lv_obj_class_t *class_p, lv_obj_t *parent)
+{
+    lv_mem_prof_push(class_p);
+    lv_obj_t *obj = __real_lv_obj_class_create_obj(class_p, parent);
+    lv_mem_prof_pop();
+    return obj;
+}
+
+void __wrap_lv_obj_class_init_obj(lv_obj_t *obj)
+{
+    lv_mem_prof_push(obj ? lv_obj_get_class(obj) : NULL);
+    __real_lv_obj_class_init_obj(obj);
+    lv_mem_prof_pop();
+}
+
+lv_result_t __wrap_lv_obj_send_event(lv_obj_t *obj, lv_event_code_t event_code, void *param)
+{
+    lv_mem_prof_push(obj ? lv_obj_get_class(obj) : NULL);
+    lv_result_t res = __real_lv_obj_send_event(obj, event_code, param);
+    lv_mem_prof_pop();
+    return res;
+}
+
+lv_result_t lv_mem_prof_start(uint32_t max_blocks)
+{
+    uint32_t cap = 64;
+
+    if (prof.on) {
+        return LV_RESULT_OK;
+    }
+    while (cap < max_blocks + max_blocks / 3) {
+        cap <<= 1;
+    }
+    /* The system heap, the table must not show up in its own report */
+    prof.blocks = calloc(cap, sizeof(lv_mem_prof_block_t));
+    if (!prof.blocks) {
+        return LV_RESULT_INVALID;
+    }
+    prof.block_mask = cap - 1;
+    prof.block_max = max_blocks;
+    prof.class_cnt = 1;
+    prof.totals.biggest_free_min = UINT32_MAX;
+    lv_mutex_init(&prof.lock);
+    prof.on = true;
+    return LV_RESULT_OK;
+}
+
+void lv_mem_prof_get_totals(lv_mem_prof_totals_t *totals)
+{
+    lv_mutex_lock(&prof.lock);
+    *totals = prof.totals;
+    lv_mutex_unlock(&prof.lock);
+}
+
+void lv_mem_prof_reset_peak(void)
+{
+    lv_mutex_lock(&prof.lock);
+    prof.totals.peak_bytes = prof.totals.live_bytes;
+    for (uint32_t i = 0; i < prof.class_cnt; i++) {
+        prof.classes[i].cnt.peak_bytes = prof.classes[i].cnt.live_bytes;
+    }
+    for (uint32_t i = 0; i <= LV_MEM_PROF_SITES; i++) {
+        prof.sites[i].cnt.peak_bytes = prof.sites[i].cnt.live_bytes;
+    }
+    lv_mutex_unlock(&prof.lock);
+}
+
+static const char *lv_mem_prof_class_name(uint32_t cls)
+{
+    if (!cls) {
+        return "-";
+    }
+    return prof.classes[cls].cls->name ? prof.classes[cls].cls->name : "?";
+}
+
+/* Live bytes, then peak, then the key, so equal sessions sort equally */
+static int lv_mem_prof_count_cmp(const lv_mem_prof_count_t *a, const lv_mem_prof_count_t *b)
+{
+    if (a->live_bytes != b->live_bytes) {
+        return a->live_bytes > b->live_bytes ? -1 : 1;
+    }
+    if (a->peak_bytes != b->peak_bytes) {
+        return a->peak_bytes > b->peak_bytes ? -1 : 1;
+    }
+    return 0;
+}
+
+static int lv_mem_prof_class_cmp(const void *a, const void *b)
+{
+    const uint8_t ca = *(const uint8_t *)a, cb = *(const uint8_t *)b;
+    const int res = lv_mem_prof_count_cmp(&prof.classes[ca].cnt, &prof.classes[cb].cnt);
+    return res ? res : strcmp(lv_mem_prof_class_name(ca), lv_mem_prof_class_name(cb));
+}
+
+static int lv_mem_prof_site_cmp(const void *a, const void *b)
+{
+    const lv_mem_prof_site_t *sa = &prof.sites[*(const uint16_t *)a];
+    const lv_mem_prof_site_t *sb = &prof.sites[*(const uint16_t *)b];
+    const int res = lv_mem_prof_count_cmp(&sa->cnt, &sb->cnt);
+    if (res) {
+        return res;
+    }
+    if (sa->addr != sb->addr) {
+        return sa->addr < sb->addr ? -1 : 1;
+    }
+    return strcmp(lv_mem_prof_class_name(sa->cls), lv_mem_prof_class_name(sb->cls));
+}
+
+void lv_mem_prof_dump(FILE *f)
+{
+    static uint8_t class_idx[LV_MEM_PROF_CLASSES];
+    static uint16_t site_idx[LV_MEM_PROF_SITES + 1];
+    uint32_t site_num = 0;
+
+    if (!prof.on) {
+        fprintf(f, "LVGL heap profiler not started\n");
+        return;
+    }
+
+    lv_mutex_lock(&prof.lock);
+    const lv_mem_prof_totals_t *t = &prof.totals;
+    fprintf(f, "LVGL heap: %"PRIu32" blocks, %"PRIu32" B live, peak %"PRIu32" B, %"PRIu32" allocs, "
+            "%"PRIu32" failed, %"PRIu32" untracked\n", t->live_blocks, t->live_bytes, t->peak_bytes, t->allocs,
+            t->fails, t->untracked);
+    if (t->biggest_free_min != UINT32_MAX) {
+        fprintf(f, "fragmentation %u %% (worst %u %%), smallest largest free block %"PRIu32" B\n",
+                t->frag_pct, t->frag_pct_max, t->biggest_free_min);
+    }
+
+    for (uint32_t i = 0; i < prof.class_cnt; i++) {
+        class_idx[i] = i;
+    }
+    qsort(class_idx, prof.class_cnt, sizeof(class_idx[0]), lv_mem_prof_class_cmp);
+    fprintf(f, "%-20s %7s %9s %9s %8s\n", "class", "blocks", "live B", "peak B", "allocs");
+    for (uint32_t i = 0; i < prof.class_cnt; i++) {
+        const lv_mem_prof_count_t *c = &prof.classes[class_idx[i]].cnt;
+        if (c->allocs) {
+            fprintf(f, "%-20s %7"PRIu32" %9"PRIu32" %9"PRIu32" %8"PRIu32"\n", lv_mem_prof_class_name(class_idx[i]),
+                    c->live_blocks, c->live_bytes, c->peak_bytes, c->allocs);
+        }
+    }
+
+    for (uint32_t i = 0; i < LV_MEM_PROF_SITES; i++) {
+        if (prof.sites[i].cnt.allocs) {
+            site_idx[site_num++] = i;
+        }
+    }
+    qsort(site_idx, site_num, sizeof(site_idx[0]), lv_mem_prof_site_cmp);
+    fprintf(f, "%-12s %-20s %7s %9s %9s %8s\n", "call site", "class", "blocks", "live B", "peak B", "allocs");
+    for (uint32_t i = 0; i < LV_MIN(site_num, LV_MEM_PROF_TOP_SITES); i++) {
+        const lv_mem_prof_site_t *s = &prof.sites[site_idx[i]];
+        const long addr = lv_mem_prof_site_addr(s->addr);
+        fprintf(f, "%c0x%08lx  %-20s %7"PRIu32" %9"PRIu32" %9"PRIu32" %8"PRIu32"\n", addr < 0 ? '-' : ' ',
+                (unsigned long)labs(addr), lv_mem_prof_class_name(s->cls), s->cnt.live_blocks, s->cnt.live_bytes,
+                s->cnt.peak_bytes, s->cnt.allocs);
+    }
+    const lv_mem_prof_count_t *other = &prof.sites[LV_MEM_PROF_SITE_OTHER].cnt;
+    if (other->allocs) {
+        fprintf(f, "%-12s %-20s %7"PRIu32" %9"PRIu32" %9"PRIu32" %8"PRIu32"\n", "(other)", "", other->live_blocks,
+                other->live_bytes, other->peak_bytes, other->allocs);
+    }
+    lv_mutex_unlock(&prof.lock);
+}
+
+lv_result_t lv_mem_prof_dump_file(const char *path)
+{
+    FILE *f = fopen(path, "w");
+
+    if (!f) {
+        return LV_RESULT_INVALID;
+    }
+    lv_mem_prof_dump(f);
+    return fclose(f) == 0 ? LV_RESULT_OK : LV_RESULT_INVALID;
+}
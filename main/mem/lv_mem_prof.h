@@ -0,0 +1,81 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * LVGL heap profiler, linked in with
+ *   -Wl,--wrap=lv_malloc,--wrap=lv_malloc_zeroed,--wrap=lv_realloc,--wrap=lv_free
+ *   -Wl,--wrap=lv_obj_class_create_obj,--wrap=lv_obj_class_init_obj,--wrap=lv_obj_send_event
+ *
+ * Every LVGL allocation is tagged with its call site and with the class of the object
+ * being created, initialized or handling an event in the same thread at the time, so the
+ * report shows which widgets hold the heap. Only LVGL's API is used, the profiler runs
+ * the same on the target and on the host.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Heap totals of the tracked blocks
+ */
+typedef struct {
+    uint32_t live_blocks;
+    uint32_t live_bytes;
+    uint32_t peak_bytes;
+    uint32_t allocs;
+    uint32_t fails;             /* Allocations LVGL's heap refused */
+    uint32_t untracked;         /* Allocations past the block table */
+    uint8_t frag_pct;           /* Last sample of lv_mem_monitor() */
+    uint8_t frag_pct_max;
+    uint32_t biggest_free_min;  /* Smallest largest-free-block seen */
+} lv_mem_prof_totals_t;
+
+/**
+ * @brief Start tracking allocations
+ *
+ * Call before lv_init() to see every block. Blocks allocated before are not known and
+ * their frees are ignored. The first failed allocation dumps the report to stdout before
+ * LVGL's malloc assert fires.
+ *
+ * @param max_blocks Live blocks the table holds, taken from the system heap
+ * @return LV_RESULT_INVALID if the table cannot be allocated
+ */
+lv_result_t lv_mem_prof_start(uint32_t max_blocks);
+
+/**
+ * @brief Get the totals
+ */
+void lv_mem_prof_get_totals(lv_mem_prof_totals_t *totals);
+
+/**
+ * @brief Restart the peaks at the current live bytes, to measure the peak of a phase
+ */
+void lv_mem_prof_reset_peak(void);
+
+/**
+ * @brief Print the report: totals, fragmentation, live bytes per object class and the top call sites
+ *
+ * Classes and call sites are sorted, so the same UI session gives the same report. Call
+ * sites are code addresses (addr2line on the target ELF), on the host relative to the
+ * profiler's own code so they do not move between runs.
+ *
+ * @param f Stream, stdout for the console
+ */
+void lv_mem_prof_dump(FILE *f);
+
+/**
+ * @brief Write the report to a file
+ */
+lv_result_t lv_mem_prof_dump_file(const char *path);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,340 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include "tier_alloc.h"
+
+#define TIER_ALLOC_ALIGN(x)     (((x) + 7) & ~(size_t)7)
+#define TIER_ALLOC_PAGE_FREE    (0xFFFF)    /* cls of a page in the free page list */
+
+struct tier_alloc_page {
+    tier_alloc_page_t *prev;
+    tier_alloc_page_t *next;
+    void *free;                 /* Free objects, linked through their first word */
+    uint16_t cls;
+    uint16_t used;
+};
+
+/* Heap tier blocks */
+typedef struct {
+    uint32_t size;
+    uint32_t cls;
+} tier_alloc_hdr_t;
+
+#define TIER_ALLOC_PAGE_HDR     TIER_ALLOC_ALIGN(sizeof(tier_alloc_page_t))
+#define TIER_ALLOC_HDR          TIER_ALLOC_ALIGN(sizeof(tier_alloc_hdr_t))
+
+static const uint16_t class_size[TIER_ALLOC_SLAB_CLASSES] = { 8, 16, 24, 32, 48, 64, 96, 128, 192, 256 };
+
+/* Class by (size + 7) / 8 */
+static const uint8_t size_class[TIER_ALLOC_SLAB_MAX / 8 + 1] = {
+    0, 0, 1, 2, 3, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7,
+    8, 8, 8, 8, 8, 8, 8, 8, 9, 9, 9, 9, 9, 9, 9, 9,
+};
+
+static inline uint32_t tier_alloc_page_cap(int cls)
+{
+    return (TIER_ALLOC_PAGE_SIZE - TIER_ALLOC_PAGE_HDR) / class_size[cls];
+}
+
+static inline bool tier_alloc_in_slab(const tier_alloc_t *ta, const void *ptr)
+{
+    const uint8_t *p = ptr;
+    return p >= ta->slab_base && p < ta->slab_base + (size_t)ta->page_cnt * TIER_ALLOC_PAGE_SIZE;
+}
+
+static inline tier_alloc_page_t *tier_alloc_page_of(const tier_alloc_t *ta, const void *ptr)
+{
+    const size_t idx = ((const uint8_t *)ptr - ta->slab_base) / TIER_ALLOC_PAGE_SIZE;
+    return (tier_alloc_page_t *)(ta->slab_base + idx * TIER_ALLOC_PAGE_SIZE);
+}
+
+static void tier_alloc_page_push(tier_alloc_page_t **head, tier_alloc_page_t *page)
+{
+    page->prev = NULL;
+    page->next = *head;
+    if (*head) {
+        (*head)->prev = page;
+    }
+    *head = page;
+}
+
+static void tier_alloc_page_unlink(tier_alloc_page_t **head, tier_alloc_page_t *page)
+{
+    if (page->prev) {
+        page->prev->next = page->next;
+    } else {
+        *head = page->next;
+    }
+    if (page->next) {
+        page->next->prev = page->prev;
+    }
+    page->prev = page->next = NULL;
+}
+
+static void tier_alloc_stat_add(tier_alloc_class_stats_t *st, size_t bytes)
+{
+    st->used++;
+    st->allocs++;
+    st->bytes += bytes;
+    if (st->used > st->peak) {
+        st->peak = st->used;
+    }
+    if (st->bytes > st->peak_bytes) {
+        st->peak_bytes = st->bytes;
+    }
+}
+
+static void tier_alloc_stat_sub(tier_alloc_class_stats_t *st, size_t bytes)
+{
+    st->used--;
+    st->bytes -= bytes;
+}
+
+static void *tier_alloc_slab(tier_alloc_t *ta, int cls)
+{
+    tier_alloc_page_t *page = ta->partial[cls];
+
+    if (!page) {
+        page = ta->free_pages;
+        if (!page) {
+            return NULL;
+        }
+        ta->free_pages = page->next;
+
+        /* Thread the page's objects into its free list */
+        const uint32_t size = class_size[cls];
+        const uint32_t cap = tier_alloc_page_cap(cls);
+        uint8_t *obj = (uint8_t *)page + TIER_ALLOC_PAGE_HDR;
+        page->free = obj;
+        for (uint32_t i = 0; i + 1 < cap; i++, obj += size) {
+            *(void **)obj = obj + size;
+        }
+        *(void **)obj = NULL;
+        page->cls = cls;
+        page->used = 0;
+        ta->stats[cls].pages++;
+        tier_alloc_page_push(&ta->partial[cls], page);
+    }
+
+    void *obj = page->free;
+    page->free = *(void **)obj;
+    page->used++;
+    if (!page->free) {
+        tier_alloc_page_unlink(&ta->partial[cls], page);
+    }
+    return obj;
+}
+
+static void tier_alloc_slab_release(tier_alloc_t *ta, void *ptr)
+{
+    tier_alloc_page_t *page = tier_alloc_page_of(ta, ptr);
+    const int cls = page->cls;
+
+    if (!page->free) {
+        tier_alloc_page_push(&ta->partial[cls], page);
+    }
+    *(void **)ptr = page->free;
+    page->free = ptr;
+    page->used--;
+
+    /* Empty pages go back to every class, but each class keeps its last one */
+    if (!page->used && (ta->partial[cls] != page || page->next)) {
+        tier_alloc_page_unlink(&ta->partial[cls], page);
+        page->cls = TIER_ALLOC_PAGE_FREE;
+        page->next = ta->free_pages;
+        ta->free_pages = page;
+        ta->stats[cls].pages--;
+    }
+}
+
+static void *tier_alloc_heap(tier_alloc_t *ta, int tier, size_t size)
+{
+    const tier_alloc_heap_t *heap = tier == TIER_ALLOC_CLASS_MID ? &ta->cfg.mid : &ta->cfg.large;
+    tier_alloc_class_stats_t *st = &ta->stats[tier];
+
+    if (size > UINT32_MAX - TIER_ALLOC_HDR) {
+        st->fails++;
+        return NULL;
+    }
+    tier_alloc_hdr_t *hdr = heap->alloc(heap->user, TIER_ALLOC_HDR + size);
+    if (!hdr) {
+        st->fails++;
+        return NULL;
+    }
+    hdr->size = size;
+    hdr->cls = tier;
+    tier_alloc_stat_add(st, size);
+    return (uint8_t *)hdr + TIER_ALLOC_HDR;
+}
+
+bool tier_alloc_init(tier_alloc_t *ta, const tier_alloc_cfg_t *cfg)
+{
+    if (!ta || !cfg || !cfg->mid.alloc || !cfg->mid.free || !cfg->large.alloc || !cfg->large.free) {
+        return false;
+    }
+
+    memset(ta, 0, sizeof(*ta));
+    ta->cfg = *cfg;
+    ta->slab_base = cfg->slab_mem;
+    ta->page_cnt = cfg->slab_mem ? cfg->slab_size / TIER_ALLOC_PAGE_SIZE : 0;
+    for (uint32_t i = ta->page_cnt; i-- > 0;) {
+        tier_alloc_page_t *page = (tier_alloc_page_t *)(ta->slab_base + (size_t)i * TIER_ALLOC_PAGE_SIZE);
+        page->cls = TIER_ALLOC_PAGE_FREE;
+        page->next = ta->free_pages;
+        ta->free_pages = page;
+    }
+    for (int cls = 0; cls < TIER_ALLOC_SLAB_CLASSES; cls++) {
+        ta->stats[cls].size = class_size[cls];
+    }
+    return true;
+}
+
+void *tier_alloc_malloc(tier_alloc_t *ta, size_t size)
+{
+    void *ptr;
+
+    if (size <= TIER_ALLOC_SLAB_MAX && ta->page_cnt) {
+        const int cls = size_class[(size + 7) >> 3];
+        ptr = tier_alloc_slab(ta, cls);
+        if (ptr) {
+            tier_alloc_stat_add(&ta->stats[cls], class_size[cls]);
+            return ptr;
+        }
+        ta->stats[cls].fails++;
+    }
+    if (size <= ta->cfg.mid_max && ta->stats[TIER_ALLOC_CLASS_MID].bytes + size <= ta->cfg.mid_budget) {
+        ptr = tier_alloc_heap(ta, TIER_ALLOC_CLASS_MID, size);
+        if (ptr) {
+            return ptr;
+        }
+    }
+    return tier_alloc_heap(ta, TIER_ALLOC_CLASS_LARGE, size);
+}
+
+void tier_alloc_free(tier_alloc_t *ta, void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+    if (tier_alloc_in_slab(ta, ptr)) {
+        const int cls = tier_alloc_page_of(ta, ptr)->cls;
+        tier_alloc_slab_release(ta, ptr);
+        tier_alloc_stat_sub(&ta->stats[cls], class_size[cls]);
+        return;
+    }
+
+    tier_alloc_hdr_t *hdr = (tier_alloc_hdr_t *)((uint8_t *)ptr - TIER_ALLOC_HDR);
+    const tier_alloc_heap_t *heap = hdr->cls == TIER_ALLOC_CLASS_MID ? &ta->cfg.mid : &ta->cfg.large;
+    tier_alloc_stat_sub(&ta->stats[hdr->cls], hdr->size);
+    heap->free(heap->user, hdr);
+}
+
+size_t tier_alloc_usable_size(const tier_alloc_t *ta, const void *ptr)
+{
+    if (!ptr) {
+        return 0;
+    }
+    if (tier_alloc_in_slab(ta, ptr)) {
+        return class_size[tier_alloc_page_of(ta, ptr)->cls];
+    }
+    return ((const tier_alloc_hdr_t *)((const uint8_t *)ptr - TIER_ALLOC_HDR))->size;
+}
+
+void *tier_alloc_realloc(tier_alloc_t *ta, void *ptr, size_t size)
+{
+    if (!ptr) {
+        return tier_alloc_malloc(ta, size);
+    }
+    if (!size) {
+        tier_alloc_free(ta, ptr);
+        return NULL;
+    }
+
+    const size_t old = tier_alloc_usable_size(ta, ptr);
+    if (tier_alloc_in_slab(ta, ptr)) {
+        /* Same class, nothing to do */
+        if (size <= TIER_ALLOC_SLAB_MAX && size_class[(size + 7) >> 3] == tier_alloc_page_of(ta, ptr)->cls) {
+            return ptr;
+        }
+    } else if (size <= old && size >= old / 2) {
+        /* Shrunk in place unless most of the block would be wasted */
+        tier_alloc_hdr_t *hdr = (tier_alloc_hdr_t *)((uint8_t *)ptr - TIER_ALLOC_HDR);
+        ta->stats[hdr->cls].bytes -= old - size;
+        hdr->size = size;
+        return ptr;
+    }
+
+    void *moved = tier_alloc_malloc(ta, size);
+    if (!moved) {
+        return NULL;
+    }
+    memcpy(moved, ptr, old < size ? old : size);
+    tier_alloc_free(ta, ptr);
+    return moved;
+}
+
+const tier_alloc_class_stats_t *tier_alloc_get_stats(const tier_alloc_t *ta, int cls)
+{
+    return cls >= 0 && cls < TIER_ALLOC_CLASSES ? &ta->stats[cls] : NULL;
+}
+
+size_t tier_alloc_slab_free(const tier_alloc_t *ta)
+{
+    size_t free_bytes = 0;
+
+    for (const tier_alloc_page_t *page = ta->free_pages; page; page = page->next) {
+        free_bytes += TIER_ALLOC_PAGE_SIZE - TIER_ALLOC_PAGE_HDR;
+    }
+    for (int cls = 0; cls < TIER_ALLOC_SLAB_CLASSES; cls++) {
+        for (const tier_alloc_page_t *page = ta->partial[cls]; page; page = page->next) {
+            free_bytes += (size_t)(tier_alloc_page_cap(cls) - page->used) * class_size[cls];
+        }
+    }
+    return free_bytes;
+}
+
+bool tier_alloc_check(const tier_alloc_t *ta)
+{
+    uint32_t used[TIER_ALLOC_SLAB_CLASSES] = { 0 };
+    uint32_t pages[TIER_ALLOC_SLAB_CLASSES] = { 0 };
+
+    for (uint32_t i = 0; i < ta->page_cnt; i++) {
+        const tier_alloc_page_t *page = (const tier_alloc_page_t *)(ta->slab_base + (size_t)i * TIER_ALLOC_PAGE_SIZE);
+        if (page->cls == TIER_ALLOC_PAGE_FREE) {
+            continue;
+        }
+        if (page->cls >= TIER_ALLOC_SLAB_CLASSES) {
+            return false;
+        }
+
+        /* Every free object inside the page's object area, on an object boundary */
+        const uint32_t size = class_size[page->cls];
+        const uint32_t cap = tier_alloc_page_cap(page->cls);
+        const uint8_t *first = (const uint8_t *)page + TIER_ALLOC_PAGE_HDR;
+        uint32_t free_cnt = 0;
+        for (const uint8_t *obj = page->free; obj; obj = *(const uint8_t * const *)obj) {
+            if (obj < first || obj >= first + cap * size || (obj - first) % size || ++free_cnt > cap) {
+                return false;
+            }
+        }
+        if (free_cnt + page->used != cap) {
+            return false;
+        }
+        used[page->cls] += page->used;
+        pages[page->cls]++;
+    }
+
+    for (int cls = 0; cls < TIER_ALLOC_SLAB_CLASSES; cls++) {
+        if (used[cls] != ta->stats[cls].used || pages[cls] != ta->stats[cls].pages) {
+            return false;
+        }
+        for (const tier_alloc_page_t *page = ta->partial[cls]; page; page = page->next) {
+            if (page->cls != cls || !page->free) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,124 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Tiered allocator behind LVGL's heap (lv_mem_app.c), plain C so it also builds on the
+ * host (tools/alloc_replay.c).
+ *
+ * Small blocks come from size-class slabs carved out of one internal RAM region, medium
+ * blocks from the "mid" heap up to a byte budget and everything else from the "large"
+ * heap, a PSRAM arena on the target. A block is told apart by its address: inside the
+ * slab region it is a slab object, otherwise it has a short header naming its heap.
+ *
+ * Not thread-safe, the caller locks.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TIER_ALLOC_PAGE_SIZE        (2048)  /* Slab page, holds objects of one class */
+#define TIER_ALLOC_SLAB_MAX         (256)   /* Largest slab object */
+#define TIER_ALLOC_SLAB_CLASSES     (10)
+#define TIER_ALLOC_CLASS_MID        (TIER_ALLOC_SLAB_CLASSES)
+#define TIER_ALLOC_CLASS_LARGE      (TIER_ALLOC_SLAB_CLASSES + 1)
+#define TIER_ALLOC_CLASSES          (TIER_ALLOC_SLAB_CLASSES + 2)
+
+/**
+ * @brief Backing heap of a tier
+ */
+typedef struct {
+    void *(*alloc)(void *user, size_t size);
+    void (*free)(void *user, void *ptr);
+    void *user;
+} tier_alloc_heap_t;
+
+/**
+ * @brief Allocator configuration
+ */
+typedef struct {
+    void *slab_mem;             /* Slab pages, 8-byte aligned, NULL for no slabs */
+    size_t slab_size;
+    tier_alloc_heap_t mid;      /* Blocks above TIER_ALLOC_SLAB_MAX up to mid_max, and slab spills */
+    size_t mid_max;
+    size_t mid_budget;          /* Bytes the mid heap may hold, the large heap takes the rest */
+    tier_alloc_heap_t large;    /* Everything else, and the mid heap's overflow */
+} tier_alloc_cfg_t;
+
+/**
+ * @brief Statistics of one size class or heap tier
+ */
+typedef struct {
+    uint32_t size;              /* Object size of a slab class, 0 for the heap tiers */
+    uint32_t used;              /* Live blocks */
+    uint32_t peak;
+    uint32_t allocs;            /* Allocations so far */
+    uint32_t fails;             /* Slab classes: spilled to a heap, heap tiers: allocation failed */
+    uint32_t pages;             /* Slab pages held by the class */
+    size_t bytes;               /* Requested bytes of the live blocks */
+    size_t peak_bytes;
+} tier_alloc_class_stats_t;
+
+typedef struct tier_alloc_page tier_alloc_page_t;
+
+/**
+ * @brief Allocator state, kept by the caller
+ */
+typedef struct {
+    tier_alloc_cfg_t cfg;
+    uint8_t *slab_base;         /* First page */
+    uint32_t page_cnt;
+    tier_alloc_page_t *free_pages;
+    tier_alloc_page_t *partial[TIER_ALLOC_SLAB_CLASSES];    /* Pages with free objects */
+    tier_alloc_class_stats_t stats[TIER_ALLOC_CLASSES];
+} tier_alloc_t;
+
+/**
+ * @brief Set up the allocator over a slab region and two heaps
+ *
+ * @return false if a heap is missing
+ */
+bool tier_alloc_init(tier_alloc_t *ta, const tier_alloc_cfg_t *cfg);
+
+/**
+ * @brief Allocate, NULL if every tier that could hold the block is exhausted
+ */
+void *tier_alloc_malloc(tier_alloc_t *ta, size_t size);
+
+/**
+ * @brief Resize, a block moves when it no longer fits its class or tier
+ */
+void *tier_alloc_realloc(tier_alloc_t *ta, void *ptr, size_t size);
+
+void tier_alloc_free(tier_alloc_t *ta, void *ptr);
+
+/**
+ * @brief Bytes the block can hold
+ */
+size_t tier_alloc_usable_size(const tier_alloc_t *ta, const void *ptr);
+
+/**
+ * @brief Statistics of a class, TIER_ALLOC_CLASS_MID and TIER_ALLOC_CLASS_LARGE are the heap tiers
+ */
+const tier_alloc_class_stats_t *tier_alloc_get_stats(const tier_alloc_t *ta, int cls);
+
+/**
+ * @brief Slab bytes not handed out, in free pages and in the free objects of used pages
+ */
+size_t tier_alloc_slab_free(const tier_alloc_t *ta);
+
+/**
+ * @brief Walk the slab pages and check their free lists and counters
+ */
+bool tier_alloc_check(const tier_alloc_t *ta);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,148 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include "esp_log.h"
+#include "lvgl.h"
+
+#if LV_USE_OS == LV_OS_CUSTOM
+
+#define LV_OS_APP_DRAW_THREAD   "swdraw"    /* Name LVGL gives the software draw unit threads */
+
+static const char *TAG = "lv_os_app";
+
+static portMUX_TYPE lv_os_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t draw_thread_cnt = 0;
+
+int lv_os_app_draw_core(uint32_t idx)
+{
+    return idx % portNUM_PROCESSORS;
+}
+
+static void lv_os_app_thread(void *arg)
+{
+    lv_thread_t *thread = arg;
+
+    thread->callback(thread->user_data);
+    /* Parked until lv_thread_delete(), which deletes the task */
+    vTaskSuspend(NULL);
+}
+
+lv_result_t lv_thread_init(lv_thread_t *thread, const char *const name, lv_thread_prio_t prio,
+                           void (*callback)(void *), size_t stack_size, void *user_data)
+{
+    BaseType_t core = tskNO_AFFINITY;
+
+    if (name && strcmp(name, LV_OS_APP_DRAW_THREAD) == 0) {
+        portENTER_CRITICAL(&lv_os_lock);
+        core = lv_os_app_draw_core(draw_thread_cnt++);
+        portEXIT_CRITICAL(&lv_os_lock);
+    }
+
+    thread->callback = callback;
+    thread->user_data = user_data;
+    if (xTaskCreatePinnedToCore(lv_os_app_thread, name ? name : "lvgl", stack_size, thread,
+                                tskIDLE_PRIORITY + prio, &thread->task, core) != pdPASS) {
+        ESP_LOGE(TAG, "Create thread %s failed", name ? name : "");
+        return LV_RESULT_INVALID;
+    }
+    ESP_LOGD(TAG, "%s on core %d", name ? name : "thread", core == tskNO_AFFINITY ? -1 : core);
+    return LV_RESULT_OK;
+}
+
+lv_result_t lv_thread_delete(lv_thread_t *thread)
+{
+    vTaskDelete(thread->task);
+    thread->task = NULL;
+    return LV_RESULT_OK;
+}
+
+/* LVGL locks some of its static mutexes before lv_init() got to them */
+static void lv_os_app_mutex_check(lv_mutex_t *mutex)
+{
+    if (mutex->mutex) {
+        return;
+    }
+    portENTER_CRITICAL(&lv_os_lock);
+    if (!mutex->mutex) {
+        mutex->mutex = xSemaphoreCreateRecursiveMutexStatic(&mutex->mutex_buf);
+    }
+    portEXIT_CRITICAL(&lv_os_lock);
+}
+
+lv_result_t lv_mutex_init(lv_mutex_t *mutex)
+{
+    lv_os_app_mutex_check(mutex);
+    return LV_RESULT_OK;
+}
+
+lv_result_t lv_mutex_lock(lv_mutex_t *mutex)
+{
+    lv_os_app_mutex_check(mutex);
+    return xSemaphoreTakeRecursive(mutex->mutex, portMAX_DELAY) == pdTRUE ? LV_RESULT_OK : LV_RESULT_INVALID;
+}
+
+/* FreeRTOS mutexes cannot be taken from an ISR, and a plain take would break the recursion count */
+lv_result_t lv_mutex_lock_isr(lv_mutex_t *mutex)
+{
+    if (xPortInIsrContext()) {
+        return LV_RESULT_INVALID;
+    }
+    return lv_mutex_lock(mutex);
+}
+
+lv_result_t lv_mutex_unlock(lv_mutex_t *mutex)
+{
+    lv_os_app_mutex_check(mutex);
+    return xSemaphoreGiveRecursive(mutex->mutex) == pdTRUE ? LV_RESULT_OK : LV_RESULT_INVALID;
+}
+
+lv_result_t lv_mutex_delete(lv_mutex_t *mutex)
+{
+    if (mutex->mutex) {
+        vSemaphoreDelete(mutex->mutex);
+        mutex->mutex = NULL;
+    }
+    return LV_RESULT_OK;
+}
+
+lv_result_t lv_thread_sync_init(lv_thread_sync_t *sync)
+{
+    sync->sem = xSemaphoreCreateBinaryStatic(&sync->sem_buf);
+    return LV_RESULT_OK;
+}
+
+lv_result_t lv_thread_sync_wait(lv_thread_sync_t *sync)
+{
+    return xSemaphoreTake(sync->sem, portMAX_DELAY) == pdTRUE ? LV_RESULT_OK : LV_RESULT_INVALID;
+}
+
+lv_result_t lv_thread_sync_signal(lv_thread_sync_t *sync)
+{
+    xSemaphoreGive(sync->sem);
+    return LV_RESULT_OK;
+}
+
+lv_result_t lv_thread_sync_signal_isr(lv_thread_sync_t *sync)
+{
+    BaseType_t need_yield = pdFALSE;
+
+    xSemaphoreGiveFromISR(sync->sem, &need_yield);
+    portYIELD_FROM_ISR(need_yield);
+    return LV_RESULT_OK;
+}
+
+lv_result_t lv_thread_sync_delete(lv_thread_sync_t *sync)
+{
+    vSemaphoreDelete(sync->sem);
+    sync->sem = NULL;
+    return LV_RESULT_OK;
+}
+
+uint32_t lv_os_get_idle_percent(void)
+{
+    return lv_timer_get_idle();
+}
+
+#endif
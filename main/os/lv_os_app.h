@@ -0,0 +1,48 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * LVGL OS layer on ESP-IDF FreeRTOS, selected with CONFIG_LV_OS_CUSTOM and
+ * CONFIG_LV_OS_CUSTOM_INCLUDE="lv_os_app.h".
+ *
+ * Same primitives as LVGL's own FreeRTOS layer, but the software draw unit threads
+ * ("swdraw") are pinned round-robin to the cores, so with
+ * CONFIG_LV_DRAW_SW_DRAW_UNIT_CNT=2 each core renders its own share of the draw tasks.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    TaskHandle_t task;
+    void (*callback)(void *);
+    void *user_data;
+} lv_thread_t;
+
+typedef struct {
+    SemaphoreHandle_t mutex;        /* Recursive, created on first use if not initialized */
+    StaticSemaphore_t mutex_buf;
+} lv_mutex_t;
+
+typedef struct {
+    SemaphoreHandle_t sem;          /* Binary, a signal without a waiter is kept for the next wait */
+    StaticSemaphore_t sem_buf;
+} lv_thread_sync_t;
+
+/**
+ * @brief Core of the n-th software draw unit thread
+ */
+int lv_os_app_draw_core(uint32_t idx);
+
+#ifdef __cplusplus
+}
+#endif
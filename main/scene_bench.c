@@ -0,0 +1,154 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <inttypes.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "scene_bench.h"
+#include "bg_bulb.h"
+
+typedef struct {
+    const char *name;
+    void (*build)(lv_obj_t *scr);
+} scene_bench_scene_t;
+
+static const char *TAG = "scene_bench";
+
+void scene_bench_build_cards(lv_obj_t *scr, lv_obj_t **cards)
+{
+    for (int i = 0; i < 6; i++) {
+        const lv_palette_t palette = (lv_palette_t)(LV_PALETTE_RED + i * 3);
+        lv_obj_t *card = lv_obj_create(scr);
+
+        lv_obj_remove_flag(card, LV_OBJ_FLAG_SCROLLABLE);
+        lv_obj_set_size(card, 64, 40);
+        lv_obj_set_pos(card, 10 + (i % 2) * 76, 10 + (i / 2) * 50);
+        lv_obj_set_style_radius(card, 12, 0);
+        lv_obj_set_style_bg_color(card, lv_palette_main(palette), 0);
+        lv_obj_set_style_bg_grad_color(card, lv_palette_darken(palette, 3), 0);
+        lv_obj_set_style_bg_grad_dir(card, LV_GRAD_DIR_VER, 0);
+        lv_obj_set_style_shadow_width(card, 16, 0);
+        lv_obj_set_style_shadow_opa(card, LV_OPA_50, 0);
+        if (cards) {
+            cards[i] = card;
+        }
+    }
+}
+
+void scene_bench_build_text(lv_obj_t *scr, int labels)
+{
+    for (int i = 0; i < labels; i++) {
+        lv_obj_t *label = lv_label_create(scr);
+
+        lv_obj_set_width(label, 150);
+        lv_obj_set_pos(label, 5, 5 + i * 38);
+        lv_label_set_text(label, "The quick brown fox jumps over the lazy dog 0123456789");
+    }
+}
+
+static void scene_cards(lv_obj_t *scr)
+{
+    scene_bench_build_cards(scr, NULL);
+}
+
+static void scene_text(lv_obj_t *scr)
+{
+    scene_bench_build_text(scr, 4);
+}
+
+static void scene_arcs(lv_obj_t *scr)
+{
+    for (int i = 0; i < 4; i++) {
+        lv_obj_t *arc = lv_arc_create(scr);
+
+        lv_obj_set_size(arc, 150 - i * 34, 150 - i * 34);
+        lv_obj_center(arc);
+        lv_obj_remove_style(arc, NULL, LV_PART_KNOB);
+        lv_obj_set_style_arc_width(arc, 12, LV_PART_MAIN);
+        lv_obj_set_style_arc_width(arc, 12, LV_PART_INDICATOR);
+        lv_obj_set_style_arc_rounded(arc, true, LV_PART_INDICATOR);
+        lv_arc_set_value(arc, 30 + i * 20);
+    }
+}
+
+/* Translucent, rotated objects are rendered into layers and blended back */
+static void scene_layers(lv_obj_t *scr)
+{
+    for (int i = 0; i < 4; i++) {
+        lv_obj_t *obj = lv_obj_create(scr);
+        lv_obj_t *label = lv_label_create(obj);
+
+        lv_obj_remove_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
+        lv_obj_set_size(obj, 80, 60);
+        lv_obj_set_pos(obj, 10 + i * 20, 10 + i * 25);
+        lv_obj_set_style_bg_color(obj, lv_palette_main((lv_palette_t)(LV_PALETTE_PURPLE + i * 4)), 0);
+        lv_obj_set_style_opa(obj, LV_OPA_60, 0);
+        lv_obj_set_style_transform_pivot_x(obj, 40, 0);
+        lv_obj_set_style_transform_pivot_y(obj, 30, 0);
+        lv_obj_set_style_transform_rotation(obj, 150 * (i + 1), 0);
+        lv_label_set_text(label, "layer");
+        lv_obj_center(label);
+    }
+}
+
+/* Full-screen C565 background decompressed from flash band by band, a label over it */
+static void scene_c565(lv_obj_t *scr)
+{
+    lv_obj_t *img = lv_image_create(scr);
+    lv_obj_t *label = lv_label_create(scr);
+
+    lv_image_set_src(img, &bg_bulb);
+    lv_obj_center(img);
+    lv_label_set_text(label, "C565 background");
+    lv_obj_align(label, LV_ALIGN_BOTTOM_MID, 0, -8);
+}
+
+static const scene_bench_scene_t scenes[] = {
+    { "cards", scene_cards },
+    { "text", scene_text },
+    { "arcs", scene_arcs },
+    { "layers", scene_layers },
+    { "c565", scene_c565 },
+};
+
+static uint32_t scene_bench_frames(lv_display_t *disp, lv_obj_t *scr, uint32_t frames)
+{
+    /* The first frame fills the caches */
+    lv_obj_invalidate(scr);
+    lv_refr_now(disp);
+
+    const int64_t start = esp_timer_get_time();
+    for (uint32_t i = 0; i < frames; i++) {
+        lv_obj_invalidate(scr);
+        lv_refr_now(disp);
+    }
+    return LV_MAX((uint32_t)((esp_timer_get_time() - start) / frames), 1);
+}
+
+void scene_bench_run(lv_display_t *disp, uint32_t frames)
+{
+    lv_display_t *def = lv_display_get_default();
+    lv_obj_t *prev = lv_display_get_screen_active(disp);
+
+    if (!frames) {
+        return;
+    }
+    lv_display_set_default(disp);
+    ESP_LOGI(TAG, "%d SW draw unit(s), us per full frame (render and flush hand-off)", LV_DRAW_SW_DRAW_UNIT_CNT);
+    for (int i = 0; i < sizeof(scenes) / sizeof(scenes[0]); i++) {
+        lv_obj_t *scr = lv_obj_create(NULL);
+
+        scenes[i].build(scr);
+        lv_screen_load(scr);
+
+        const uint32_t us = scene_bench_frames(disp, scr, frames);
+        ESP_LOGI(TAG, "%-6s %6"PRIu32" us", scenes[i].name, us);
+
+        lv_screen_load(prev);
+        lv_obj_delete(scr);
+    }
+    lv_display_set_default(def);
+    lv_obj_invalidate(prev);
+}
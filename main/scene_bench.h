@@ -0,0 +1,52 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Build six shadowed cards with vertical gradients, two columns of three
+ *
+ * The benchmark's "cards" scene, also rendered by the host UI benchmark (host/ui_bench.c).
+ *
+ * @param scr   Screen to build on
+ * @param cards Receives the six cards, NULL when not needed
+ */
+void scene_bench_build_cards(lv_obj_t *scr, lv_obj_t **cards);
+
+/**
+ * @brief Build labels of wrapped pangram text, 38 rows apart
+ *
+ * The benchmark's "text" scene with 4 labels, also rendered by host/ui_bench.c.
+ *
+ * @param scr    Screen to build on
+ * @param labels Number of labels
+ */
+void scene_bench_build_text(lv_obj_t *scr, int labels);
+
+/**
+ * @brief Render a fixed set of scenes and log the time per frame
+ *
+ * Each scene (shadowed gradient cards, wrapped text, thick arcs, translucent layers) is
+ * loaded on its own screen and redrawn in full `frames` times with lv_refr_now(). The log
+ * names the number of software draw units; what the extra units bring is the difference
+ * to a build with CONFIG_LV_DRAW_SW_DRAW_UNIT_CNT=1.
+ * The previous screen is loaded again afterwards.
+ *
+ * Must be called with the LVGL lock held.
+ *
+ * @param disp   Display to render
+ * @param frames Frames per scene and draw unit setting
+ */
+void scene_bench_run(lv_display_t *disp, uint32_t frames);
+
+#ifdef __cplusplus
+}
+#endif
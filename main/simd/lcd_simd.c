@@ -0,0 +1,314 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "lcd_simd.h"
+
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#include "esp_cpu.h"
+#include "esp_heap_caps.h"
+#endif
+
+#if CONFIG_IDF_TARGET_ESP32S3
+#define LCD_SIMD_HAS_PIE    (1)
+#else
+#define LCD_SIMD_HAS_PIE    (0)
+#endif
+
+#define LCD_SIMD_ALIGN      (16)    /* PIE loads and stores ignore the low 4 address bits */
+#define LCD_SIMD_BENCH_PX   (160 * 160)
+
+static const char *TAG = "lcd_simd";
+
+#if LCD_SIMD_HAS_PIE
+/* lcd_simd_esp32s3.S, 16-byte aligned buffers, counts in 16 or 8 pixel blocks */
+void lcd_simd_rgb565_swap_pie(uint16_t *buf, uint32_t blocks16);
+void lcd_simd_rgb565_fill_pie(uint16_t *dst, const uint16_t *color, uint32_t blocks8);
+void lcd_simd_rgb565_copy_pie(uint16_t *dst, const uint16_t *src, uint32_t blocks8);
+void lcd_simd_rgb565_diff_pie(const uint16_t *a, const uint16_t *b, uint32_t blocks8, uint32_t *acc);
+
+static bool pie_enabled = false;
+#endif
+
+void lcd_simd_rgb565_swap_c(uint16_t *buf, uint32_t px_cnt)
+{
+    /* Two pixels per word once aligned */
+    if (((uintptr_t)buf & 3) && px_cnt) {
+        *buf = (uint16_t)((*buf << 8) | (*buf >> 8));
+        buf++;
+        px_cnt--;
+    }
+    uint32_t *w = (uint32_t *)buf;
+    for (uint32_t i = 0; i < px_cnt / 2; i++) {
+        w[i] = ((w[i] & 0x00FF00FFU) << 8) | ((w[i] >> 8) & 0x00FF00FFU);
+    }
+    if (px_cnt & 1) {
+        uint16_t *last = &buf[px_cnt - 1];
+        *last = (uint16_t)((*last << 8) | (*last >> 8));
+    }
+}
+
+void lcd_simd_rgb565_fill_c(uint16_t *dst, uint16_t color, uint32_t px_cnt)
+{
+    for (uint32_t i = 0; i < px_cnt; i++) {
+        dst[i] = color;
+    }
+}
+
+void lcd_simd_rgb565_copy_c(uint16_t *dst, const uint16_t *src, uint32_t px_cnt)
+{
+    memcpy(dst, src, px_cnt * sizeof(uint16_t));
+}
+
+bool lcd_simd_rgb565_equal_c(const uint16_t *a, const uint16_t *b, uint32_t px_cnt)
+{
+    return memcmp(a, b, px_cnt * sizeof(uint16_t)) == 0;
+}
+
+#if LCD_SIMD_HAS_PIE
+/* Pixels before the first 16-byte boundary, handled in C */
+static inline uint32_t lcd_simd_head(const void *p, uint32_t px_cnt)
+{
+    uint32_t head = ((LCD_SIMD_ALIGN - ((uintptr_t)p & (LCD_SIMD_ALIGN - 1))) & (LCD_SIMD_ALIGN - 1)) / 2;
+    return head < px_cnt ? head : px_cnt;
+}
+#endif
+
+void lcd_simd_rgb565_swap(uint16_t *buf, uint32_t px_cnt)
+{
+#if LCD_SIMD_HAS_PIE
+    if (pie_enabled && ((uintptr_t)buf & 1) == 0) {
+        uint32_t head = lcd_simd_head(buf, px_cnt);
+        lcd_simd_rgb565_swap_c(buf, head);
+        buf += head;
+        px_cnt -= head;
+
+        uint32_t blocks = px_cnt / 16;
+        if (blocks) {
+            lcd_simd_rgb565_swap_pie(buf, blocks);
+            buf += blocks * 16;
+            px_cnt -= blocks * 16;
+        }
+    }
+#endif
+    lcd_simd_rgb565_swap_c(buf, px_cnt);
+}
+
+void lcd_simd_rgb565_fill(uint16_t *dst, uint16_t color, uint32_t px_cnt)
+{
+#if LCD_SIMD_HAS_PIE
+    if (pie_enabled && ((uintptr_t)dst & 1) == 0) {
+        uint32_t head = lcd_simd_head(dst, px_cnt);
+        lcd_simd_rgb565_fill_c(dst, color, head);
+        dst += head;
+        px_cnt -= head;
+
+        uint32_t blocks = px_cnt / 8;
+        if (blocks) {
+            lcd_simd_rgb565_fill_pie(dst, &color, blocks);
+            dst += blocks * 8;
+            px_cnt -= blocks * 8;
+        }
+    }
+#endif
+    lcd_simd_rgb565_fill_c(dst, color, px_cnt);
+}
+
+void lcd_simd_rgb565_copy(uint16_t *dst, const uint16_t *src, uint32_t px_cnt)
+{
+#if LCD_SIMD_HAS_PIE
+    /* Both buffers have to reach a 16-byte boundary together */
+    if (pie_enabled && (((uintptr_t)dst ^ (uintptr_t)src) & (LCD_SIMD_ALIGN - 1)) == 0 && ((uintptr_t)dst & 1) == 0) {
+        uint32_t head = lcd_simd_head(dst, px_cnt);
+        lcd_simd_rgb565_copy_c(dst, src, head);
+        dst += head;
+        src += head;
+        px_cnt -= head;
+
+        uint32_t blocks = px_cnt / 8;
+        if (blocks) {
+            lcd_simd_rgb565_copy_pie(dst, src, blocks);
+            dst += blocks * 8;
+            src += blocks * 8;
+            px_cnt -= blocks * 8;
+        }
+    }
+#endif
+    lcd_simd_rgb565_copy_c(dst, src, px_cnt);
+}
+
+bool lcd_simd_rgb565_equal(const uint16_t *a, const uint16_t *b, uint32_t px_cnt)
+{
+#if LCD_SIMD_HAS_PIE
+    /* Like copy, both runs have to reach a 16-byte boundary together */
+    if (pie_enabled && (((uintptr_t)a ^ (uintptr_t)b) & (LCD_SIMD_ALIGN - 1)) == 0 && ((uintptr_t)a & 1) == 0) {
+        uint32_t head = lcd_simd_head(a, px_cnt);
+        if (!lcd_simd_rgb565_equal_c(a, b, head)) {
+            return false;
+        }
+        a += head;
+        b += head;
+        px_cnt -= head;
+
+        uint32_t blocks = px_cnt / 8;
+        if (blocks) {
+            uint32_t acc[4] __attribute__((aligned(LCD_SIMD_ALIGN)));
+            lcd_simd_rgb565_diff_pie(a, b, blocks, acc);
+            if (acc[0] | acc[1] | acc[2] | acc[3]) {
+                return false;
+            }
+            a += blocks * 8;
+            b += blocks * 8;
+            px_cnt -= blocks * 8;
+        }
+    }
+#endif
+    return lcd_simd_rgb565_equal_c(a, b, px_cnt);
+}
+
+#if LCD_SIMD_HAS_PIE
+static void *lcd_simd_alloc(size_t size)
+{
+    return heap_caps_aligned_alloc(LCD_SIMD_ALIGN, size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+}
+
+static void lcd_simd_pattern(uint16_t *buf, uint32_t px_cnt)
+{
+    uint32_t x = 0x12345678;
+
+    for (uint32_t i = 0; i < px_cnt; i++) {
+        x = x * 1664525 + 1013904223;
+        buf[i] = (uint16_t)(x >> 16);
+    }
+}
+
+/* Odd offsets and lengths exercise the C head and tail around the vector bulk */
+static bool lcd_simd_check(uint16_t *ref, uint16_t *out, uint16_t *src)
+{
+    static const uint32_t offsets[] = { 0, 1, 3, 7 };
+    static const uint32_t lengths[] = { 0, 1, 7, 8, 15, 16, 17, 33, 160, 1001 };
+
+    for (int o = 0; o < sizeof(offsets) / sizeof(offsets[0]); o++) {
+        for (int l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+            const uint32_t off = offsets[o];
+            const uint32_t len = lengths[l];
+            const size_t size = (off + len + 8) * sizeof(uint16_t);
+
+            lcd_simd_pattern(src, off + len + 8);
+            memcpy(ref, src, size);
+            memcpy(out, src, size);
+            lcd_simd_rgb565_swap_c(ref + off, len);
+            lcd_simd_rgb565_swap(out + off, len);
+            if (memcmp(ref, out, size) != 0) {
+                ESP_LOGE(TAG, "swap mismatch, offset %"PRIu32" length %"PRIu32, off, len);
+                return false;
+            }
+
+            lcd_simd_rgb565_fill_c(ref + off, 0xA55A, len);
+            lcd_simd_rgb565_fill(out + off, 0xA55A, len);
+            if (memcmp(ref, out, size) != 0) {
+                ESP_LOGE(TAG, "fill mismatch, offset %"PRIu32" length %"PRIu32, off, len);
+                return false;
+            }
+
+            lcd_simd_rgb565_copy_c(ref + off, src + off, len);
+            lcd_simd_rgb565_copy(out + off, src + off, len);
+            if (memcmp(ref, out, size) != 0) {
+                ESP_LOGE(TAG, "copy mismatch, offset %"PRIu32" length %"PRIu32, off, len);
+                return false;
+            }
+
+            /* Equal runs, then a single differing pixel at each end and in the middle */
+            bool mismatch = !lcd_simd_rgb565_equal(out + off, src + off, len);
+            for (uint32_t i = 0; len && i < 3 && !mismatch; i++) {
+                const uint32_t at = off + (i == 0 ? 0 : i == 1 ? len / 2 : len - 1);
+                out[at] ^= 0x0100;
+                mismatch = lcd_simd_rgb565_equal(out + off, src + off, len);
+                out[at] ^= 0x0100;
+            }
+            if (mismatch) {
+                ESP_LOGE(TAG, "equal mismatch, offset %"PRIu32" length %"PRIu32, off, len);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+#endif
+
+bool lcd_simd_init(void)
+{
+#if LCD_SIMD_HAS_PIE
+    const size_t size = 1024 * 2 * sizeof(uint16_t);
+    uint16_t *ref = lcd_simd_alloc(size);
+    uint16_t *out = lcd_simd_alloc(size);
+    uint16_t *src = lcd_simd_alloc(size);
+
+    pie_enabled = ref && out && src;
+    if (pie_enabled) {
+        pie_enabled = lcd_simd_check(ref, out, src);
+    }
+    heap_caps_free(ref);
+    heap_caps_free(out);
+    heap_caps_free(src);
+
+    ESP_LOGI(TAG, "PIE kernels %s", pie_enabled ? "enabled" : "disabled, using C");
+    return pie_enabled;
+#else
+    return false;
+#endif
+}
+
+#if LCD_SIMD_HAS_PIE
+static void lcd_simd_bench_one(const char *name, bool pie, uint16_t *dst, uint16_t *src)
+{
+    const bool saved = pie_enabled;
+    uint32_t start, cycles;
+
+    pie_enabled = pie;
+    start = esp_cpu_get_cycle_count();
+    if (strcmp(name, "swap") == 0) {
+        lcd_simd_rgb565_swap(dst, LCD_SIMD_BENCH_PX);
+    } else if (strcmp(name, "fill") == 0) {
+        lcd_simd_rgb565_fill(dst, 0x1234, LCD_SIMD_BENCH_PX);
+    } else if (strcmp(name, "equal") == 0) {
+        lcd_simd_rgb565_equal(dst, src, LCD_SIMD_BENCH_PX);
+    } else {
+        lcd_simd_rgb565_copy(dst, src, LCD_SIMD_BENCH_PX);
+    }
+    cycles = esp_cpu_get_cycle_count() - start;
+    pie_enabled = saved;
+
+    ESP_LOGI(TAG, "%s %-5s %"PRIu32".%02"PRIu32" cycles/px", pie ? "PIE" : "C  ", name,
+             cycles / LCD_SIMD_BENCH_PX, cycles * 100 / LCD_SIMD_BENCH_PX % 100);
+}
+#endif
+
+void lcd_simd_bench(void)
+{
+#if LCD_SIMD_HAS_PIE
+    static const char *kernels[] = { "swap", "fill", "copy", "equal" };
+    uint16_t *dst = lcd_simd_alloc(LCD_SIMD_BENCH_PX * sizeof(uint16_t));
+    uint16_t *src = lcd_simd_alloc(LCD_SIMD_BENCH_PX * sizeof(uint16_t));
+
+    if (dst && src) {
+        lcd_simd_pattern(src, LCD_SIMD_BENCH_PX);
+        memcpy(dst, src, LCD_SIMD_BENCH_PX * sizeof(uint16_t));
+        for (int i = 0; i < sizeof(kernels) / sizeof(kernels[0]); i++) {
+            lcd_simd_bench_one(kernels[i], false, dst, src);
+            if (pie_enabled) {
+                lcd_simd_bench_one(kernels[i], true, dst, src);
+            }
+        }
+    }
+    heap_caps_free(dst);
+    heap_caps_free(src);
+#else
+    ESP_LOGI(TAG, "No vector unit on this target");
+#endif
+}
@@ -0,0 +1,68 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * RGB565 pixel kernels. On the ESP32-S3 the aligned bulk runs on the 128-bit PIE
+ * vector unit, everywhere else (and for unaligned heads and tails) the portable
+ * C versions below are used.
+ *
+ * LVGL's renderer only uses the swap, through lv_draw_sw_asm_app.h. Copy and compare
+ * are called by lcd_diff, fill only by the self-test and benchmark; there is no blend
+ * kernel.
+ */
+
+/**
+ * @brief Swap the bytes of every RGB565 pixel in place
+ */
+void lcd_simd_rgb565_swap(uint16_t *buf, uint32_t px_cnt);
+
+/**
+ * @brief Fill pixels with one color
+ */
+void lcd_simd_rgb565_fill(uint16_t *dst, uint16_t color, uint32_t px_cnt);
+
+/**
+ * @brief Copy pixels, the buffers must not overlap
+ */
+void lcd_simd_rgb565_copy(uint16_t *dst, const uint16_t *src, uint32_t px_cnt);
+
+/**
+ * @brief Compare pixels
+ *
+ * @return true when both runs hold the same pixels
+ */
+bool lcd_simd_rgb565_equal(const uint16_t *a, const uint16_t *b, uint32_t px_cnt);
+
+/* Portable C versions, also the reference for the self-test */
+void lcd_simd_rgb565_swap_c(uint16_t *buf, uint32_t px_cnt);
+void lcd_simd_rgb565_fill_c(uint16_t *dst, uint16_t color, uint32_t px_cnt);
+void lcd_simd_rgb565_copy_c(uint16_t *dst, const uint16_t *src, uint32_t px_cnt);
+bool lcd_simd_rgb565_equal_c(const uint16_t *a, const uint16_t *b, uint32_t px_cnt);
+
+/**
+ * @brief Check the vector kernels are bit-exact against the C versions and enable them
+ *
+ * Until this is called (or when the check fails) the C versions are used.
+ *
+ * @return true when the vector kernels are in use
+ */
+bool lcd_simd_init(void);
+
+/**
+ * @brief Print cycles per pixel of every kernel, C and vector, on a full 160x160 frame
+ */
+void lcd_simd_bench(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,32 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * LVGL software renderer hooks, selected with
+ * CONFIG_LV_DRAW_SW_ASM_CUSTOM_INCLUDE="lv_draw_sw_asm_app.h".
+ *
+ * Only the RGB565 byte swap (lv_draw_sw_rgb565_swap(), used by the flush when the display
+ * does not render in panel byte order) comes from lcd_simd. LVGL's fills and blends get the
+ * LVGL port's ESP32-S3 kernels when the port provides esp_lvgl_port_lv_blend.h and LVGL's
+ * own C code otherwise. lcd_simd has no blend kernel; its copy and compare serve lcd_diff,
+ * not the renderer.
+ */
+
+#pragma once
+
+#if defined(__has_include) && __has_include("esp_lvgl_port_lv_blend.h")
+#include "esp_lvgl_port_lv_blend.h"
+#endif
+#include "lcd_simd.h"
+
+#ifndef LV_DRAW_SW_RGB565_SWAP
+#define LV_DRAW_SW_RGB565_SWAP(__buf_ptr, __buf_size_px) \
+    lv_draw_sw_rgb565_swap_app(__buf_ptr, __buf_size_px)
+#endif
+
+static inline lv_result_t lv_draw_sw_rgb565_swap_app(void *buf, uint32_t buf_size_px)
+{
+    lcd_simd_rgb565_swap((uint16_t *)buf, buf_size_px);
+    return LV_RESULT_OK;
+}
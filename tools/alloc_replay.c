@@ -0,0 +1,377 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Replays an LVGL heap trace against main/mem/tier_alloc.c on the host.
+ *
+ * Record a UI session on the target with EXAMPLE_LVGL_MEM_TRACE, which prints every
+ * allocator call as an "LVMEM" line, save the monitor output and replay it:
+ *
+ *   cc -O2 -Imain/mem -o alloc_replay tools/alloc_replay.c main/mem/tier_alloc.c
+ *   ./alloc_replay [--slab KB] [--mid-max B] [--mid-budget KB] [--arena KB]
+ *                  [--max-peak KB] [--max-frag PCT] monitor.log
+ *
+ * The host build records the same lines with `lcd_host --mem-trace FILE`.
+ *
+ * Other log lines are skipped. Every replayed block is filled with a pattern that is
+ * checked when the block is resized or freed, the slab lists are checked every few
+ * thousand calls and at the end. Prints the per-class statistics, the arena peak, the
+ * peak of live bytes next to the old 64 KB builtin pool and the fragmentation: the share
+ * of the memory the tiers held at their peak (slab pages, mid and large heap) that was
+ * not live. Exits with 1 on corruption, on a trace that frees a block it never allocated
+ * and when the live peak or the fragmentation exceed --max-peak / --max-frag.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tier_alloc.h"
+
+#define REPLAY_CHECK_EVERY  (4096)
+#define REPLAY_BUILTIN_KB   (64)
+
+/* Target address to replayed block, open addressing */
+typedef struct {
+    uint32_t addr;              /* 0 for an empty slot */
+    uint32_t size;
+    uint8_t *ptr;
+    uint8_t pattern;
+    uint8_t dead;               /* Freed slot, keeps probing going */
+} replay_block_t;
+
+typedef struct {
+    size_t used;                /* Bytes in the heap, with the host heap's size prefix */
+    size_t peak;
+    size_t limit;               /* Arena size, 0 for no limit */
+    uint32_t overflows;         /* Allocations past the arena, the default heap on the target */
+} replay_heap_t;
+
+static replay_block_t *blocks;
+static size_t block_cap;
+static size_t block_cnt;        /* Live and dead slots */
+
+static size_t live_bytes;
+static size_t live_peak;
+static size_t held_peak;        /* Slab pages and heap bytes the tiers held, at most */
+static size_t held_live;        /* Live bytes at that point */
+static uint32_t ops;
+static uint32_t errors;
+
+static void *replay_heap_alloc(void *user, size_t size)
+{
+    replay_heap_t *heap = user;
+
+    if (heap->limit && heap->used + size > heap->limit) {
+        heap->overflows++;
+    }
+    size_t *p = malloc(sizeof(size_t) + size);
+    if (!p) {
+        return NULL;
+    }
+    *p = size;
+    heap->used += size;
+    if (heap->used > heap->peak) {
+        heap->peak = heap->used;
+    }
+    return p + 1;
+}
+
+static void replay_heap_free(void *user, void *ptr)
+{
+    replay_heap_t *heap = user;
+    size_t *p = (size_t *)ptr - 1;
+
+    heap->used -= *p;
+    free(p);
+}
+
+static size_t replay_slot(uint32_t addr)
+{
+    return (addr * 2654435761u) & (block_cap - 1);
+}
+
+static replay_block_t *replay_find(uint32_t addr)
+{
+    for (size_t i = replay_slot(addr);; i = (i + 1) & (block_cap - 1)) {
+        if (!blocks[i].addr) {
+            return NULL;
+        }
+        if (blocks[i].addr == addr && !blocks[i].dead) {
+            return &blocks[i];
+        }
+    }
+}
+
+static void replay_insert(uint32_t addr, uint8_t *ptr, uint32_t size, uint8_t pattern);
+
+static void replay_grow(void)
+{
+    replay_block_t *old = blocks;
+    const size_t old_cap = block_cap;
+
+    block_cap = block_cap ? block_cap * 2 : 4096;
+    blocks = calloc(block_cap, sizeof(replay_block_t));
+    if (!blocks) {
+        fprintf(stderr, "out of memory\n");
+        exit(2);
+    }
+    block_cnt = 0;
+    for (size_t i = 0; i < old_cap; i++) {
+        if (old[i].addr && !old[i].dead) {
+            replay_insert(old[i].addr, old[i].ptr, old[i].size, old[i].pattern);
+        }
+    }
+    free(old);
+}
+
+static void replay_insert(uint32_t addr, uint8_t *ptr, uint32_t size, uint8_t pattern)
+{
+    if ((block_cnt + 1) * 4 > block_cap * 3) {
+        replay_grow();
+    }
+    size_t i = replay_slot(addr);
+    while (blocks[i].addr) {
+        i = (i + 1) & (block_cap - 1);
+    }
+    blocks[i] = (replay_block_t) {
+        .addr = addr, .size = size, .ptr = ptr, .pattern = pattern,
+    };
+    block_cnt++;
+}
+
+static void replay_fill(uint8_t *ptr, uint32_t from, uint32_t to, uint8_t pattern)
+{
+    for (uint32_t i = from; i < to; i++) {
+        ptr[i] = (uint8_t)(pattern + i);
+    }
+}
+
+static void replay_verify(const replay_block_t *b, uint32_t len, const char *line)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        if (b->ptr[i] != (uint8_t)(b->pattern + i)) {
+            fprintf(stderr, "corrupted block %08"PRIx32" at byte %"PRIu32": %s", b->addr, i, line);
+            errors++;
+            return;
+        }
+    }
+}
+
+static void replay_alloc(tier_alloc_t *ta, uint32_t addr, uint32_t size, const char *line)
+{
+    uint8_t *ptr = tier_alloc_malloc(ta, size);
+
+    if (!ptr) {
+        fprintf(stderr, "allocation failed: %s", line);
+        errors++;
+        return;
+    }
+    replay_fill(ptr, 0, size, (uint8_t)ops);
+    replay_insert(addr, ptr, size, (uint8_t)ops);
+    live_bytes += size;
+    if (live_bytes > live_peak) {
+        live_peak = live_bytes;
+    }
+}
+
+static void replay_free(tier_alloc_t *ta, uint32_t addr, const char *line)
+{
+    replay_block_t *b = replay_find(addr);
+
+    if (!b) {
+        fprintf(stderr, "free of an unknown block: %s", line);
+        errors++;
+        return;
+    }
+    replay_verify(b, b->size, line);
+    tier_alloc_free(ta, b->ptr);
+    live_bytes -= b->size;
+    b->dead = 1;
+}
+
+static void replay_realloc(tier_alloc_t *ta, uint32_t old_addr, uint32_t new_addr, uint32_t size, const char *line)
+{
+    replay_block_t *b = replay_find(old_addr);
+
+    if (!b) {
+        fprintf(stderr, "realloc of an unknown block: %s", line);
+        errors++;
+        return;
+    }
+    replay_verify(b, b->size, line);
+
+    uint8_t *ptr = tier_alloc_realloc(ta, b->ptr, size);
+    if (!ptr) {
+        fprintf(stderr, "reallocation failed: %s", line);
+        errors++;
+        return;
+    }
+    const uint32_t old_size = b->size;
+    const uint8_t pattern = b->pattern;
+    b->dead = 1;
+
+    /* The kept bytes follow the old pattern, the new ones continue it */
+    if (size > old_size) {
+        replay_fill(ptr, old_size, size, pattern);
+    }
+    replay_insert(new_addr, ptr, size, pattern);
+    replay_verify(replay_find(new_addr), size < old_size ? size : old_size, line);
+    live_bytes = live_bytes - old_size + size;
+    if (live_bytes > live_peak) {
+        live_peak = live_bytes;
+    }
+}
+
+/* After every call, fragmentation is taken where the tiers hold the most */
+static void replay_held(const tier_alloc_t *ta, const replay_heap_t *mid, const replay_heap_t *large)
+{
+    size_t held = mid->used + large->used;
+
+    for (int cls = 0; cls < TIER_ALLOC_SLAB_CLASSES; cls++) {
+        held += (size_t)tier_alloc_get_stats(ta, cls)->pages * TIER_ALLOC_PAGE_SIZE;
+    }
+    if (held > held_peak) {
+        held_peak = held;
+        held_live = live_bytes;
+    }
+}
+
+static void replay_usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [--slab KB] [--mid-max B] [--mid-budget KB] [--arena KB] [--max-peak KB] "
+            "[--max-frag PCT] trace.log\n", prog);
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    size_t slab_kb = 32, mid_max = 4096, mid_budget_kb = 32, arena_kb = 1024;
+    size_t max_peak_kb = 0, max_frag = 100;
+    const char *path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--slab") == 0) {
+            slab_kb = strtoul(argv[++i], NULL, 0);
+        } else if (i + 1 < argc && strcmp(argv[i], "--mid-max") == 0) {
+            mid_max = strtoul(argv[++i], NULL, 0);
+        } else if (i + 1 < argc && strcmp(argv[i], "--mid-budget") == 0) {
+            mid_budget_kb = strtoul(argv[++i], NULL, 0);
+        } else if (i + 1 < argc && strcmp(argv[i], "--arena") == 0) {
+            arena_kb = strtoul(argv[++i], NULL, 0);
+        } else if (i + 1 < argc && strcmp(argv[i], "--max-peak") == 0) {
+            max_peak_kb = strtoul(argv[++i], NULL, 0);
+        } else if (i + 1 < argc && strcmp(argv[i], "--max-frag") == 0) {
+            max_frag = strtoul(argv[++i], NULL, 0);
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            replay_usage(argv[0]);
+        }
+    }
+    if (!path) {
+        replay_usage(argv[0]);
+    }
+    FILE *f = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return 2;
+    }
+
+    replay_heap_t mid = { 0 };
+    replay_heap_t large = { .limit = arena_kb * 1024 };
+    const size_t slab_size = slab_kb * 1024;
+    void *slab = slab_size ? malloc(slab_size) : NULL;
+    const tier_alloc_cfg_t cfg = {
+        .slab_mem = slab,
+        .slab_size = slab_size,
+        .mid = { replay_heap_alloc, replay_heap_free, &mid },
+        .mid_max = mid_max,
+        .mid_budget = mid_budget_kb * 1024,
+        .large = { replay_heap_alloc, replay_heap_free, &large },
+    };
+    tier_alloc_t ta;
+    if (!tier_alloc_init(&ta, &cfg)) {
+        fprintf(stderr, "tier_alloc_init failed\n");
+        return 2;
+    }
+    replay_grow();
+
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        const char *rec = strstr(line, "LVMEM ");
+        uint32_t a, b, size;
+
+        if (!rec) {
+            continue;
+        }
+        rec += 6;
+        if (sscanf(rec, "a %"SCNx32" %"SCNu32, &a, &size) == 2) {
+            if (a) {                            /* Failed on the target */
+                replay_alloc(&ta, a, size, line);
+            }
+        } else if (sscanf(rec, "r %"SCNx32" %"SCNx32" %"SCNu32, &a, &b, &size) == 3) {
+            if (!a && b) {
+                replay_alloc(&ta, b, size, line);
+            } else if (a && b) {
+                replay_realloc(&ta, a, b, size, line);
+            }
+        } else if (sscanf(rec, "f %"SCNx32, &a) == 1) {
+            if (a) {
+                replay_free(&ta, a, line);
+            }
+        } else {
+            continue;
+        }
+        replay_held(&ta, &mid, &large);
+        if (++ops % REPLAY_CHECK_EVERY == 0 && !tier_alloc_check(&ta)) {
+            fprintf(stderr, "slab check failed after %"PRIu32" calls\n", ops);
+            errors++;
+        }
+    }
+    if (f != stdin) {
+        fclose(f);
+    }
+    if (!tier_alloc_check(&ta)) {
+        fprintf(stderr, "slab check failed at the end\n");
+        errors++;
+    }
+
+    printf("%"PRIu32" calls, peak live %zu KB (builtin pool %d KB), %zu B still live\n",
+           ops, live_peak / 1024, REPLAY_BUILTIN_KB, live_bytes);
+    printf("class   used   peak   allocs  spills pages  peak KB\n");
+    for (int cls = 0; cls < TIER_ALLOC_CLASSES; cls++) {
+        const tier_alloc_class_stats_t *st = tier_alloc_get_stats(&ta, cls);
+        char name[8];
+
+        if (!st->allocs && !st->fails) {
+            continue;
+        }
+        if (cls == TIER_ALLOC_CLASS_MID) {
+            snprintf(name, sizeof(name), "mid");
+        } else if (cls == TIER_ALLOC_CLASS_LARGE) {
+            snprintf(name, sizeof(name), "large");
+        } else {
+            snprintf(name, sizeof(name), "%"PRIu32, st->size);
+        }
+        printf("%-6s %6"PRIu32" %6"PRIu32" %8"PRIu32" %6"PRIu32" %5"PRIu32" %8zu\n", name,
+               st->used, st->peak, st->allocs, st->fails, st->pages, st->peak_bytes / 1024);
+    }
+    printf("slab %zu KB free of %zu KB, mid peak %zu KB, arena peak %zu KB of %zu KB (%"PRIu32" past the arena)\n",
+           tier_alloc_slab_free(&ta) / 1024, slab_kb, mid.peak / 1024, large.peak / 1024, arena_kb, large.overflows);
+    const size_t frag = held_peak ? (held_peak - held_live) * 100 / held_peak : 0;
+    printf("tiers held %zu KB at most, %zu %% of it not live\n", held_peak / 1024, frag);
+    if (max_peak_kb && live_peak > max_peak_kb * 1024) {
+        fprintf(stderr, "peak live %zu KB above %zu KB\n", live_peak / 1024, max_peak_kb);
+        errors++;
+    }
+    if (frag > max_frag) {
+        fprintf(stderr, "fragmentation %zu %% above %zu %%\n", frag, max_frag);
+        errors++;
+    }
+    if (errors) {
+        printf("%"PRIu32" error(s)\n", errors);
+    }
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,439 @@
+#!/usr/bin/env python3
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Convert GIF/PNG files to the A565 delta-frame animation format played by main/anim565.c.
+#
+# Every frame is composed to full RGBA (GIF disposal handled), quantized to RGB565 once here,
+# and stored as the bounding box of the pixels that changed since the previous frame. The
+# first frame is a full key frame. Playback only copies rectangles: no LZW, no palette.
+#
+# Layout, little-endian:
+#   header  "A565" u8 version, u8 flags, u16 w, u16 h, u16 frame_cnt         (12 bytes)
+#   frame   u16 delay_ms, u16 x, u16 y, u16 w, u16 h, u16 reserved           (12 bytes)
+#           w * h RGB565 pixels, then w * h alpha bytes if flags & HAS_ALPHA,
+#           padded to 4 bytes
+#
+# Usage:
+#   anim_conv.py --name anim_bulb --out-c anim_bulb.c --out-h anim_bulb.h bulb.gif
+#   anim_conv.py --verify bulb.gif        round-trip: encode, decode, compare with the source
+#   anim_conv.py --stats bulb.gif         invalidated pixels per frame, changed rectangle vs whole image
+#   anim_conv.py --splash 160x160 --bg f5f5f5 --name splash_bulb --out-c splash_bulb.c --out-h splash_bulb.h bulb.gif
+#                                         first frame centered on a full-screen background, RGB565 in
+#                                         panel byte order, sent by main/lcd_splash.c before LVGL starts
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+A565_MAGIC = b'A565'
+A565_VERSION = 1
+A565_FLAG_HAS_ALPHA = 0x01
+A565_HEADER = struct.Struct('<4sBBHHH')
+A565_FRAME = struct.Struct('<HHHHHH')
+
+
+# GIF decoding
+
+def _lzw_decode(data, min_code_size, pixel_cnt):
+    clear = 1 << min_code_size
+    eoi = clear + 1
+    code_size = min_code_size + 1
+    table = [bytes([i]) for i in range(clear)] + [b'', b'']
+    out = bytearray()
+    prev = None
+    bit_pos = 0
+    bit_len = len(data) * 8
+    while bit_pos + code_size <= bit_len:
+        byte_pos = bit_pos >> 3
+        chunk = int.from_bytes(data[byte_pos:byte_pos + 3], 'little')
+        code = (chunk >> (bit_pos & 7)) & ((1 << code_size) - 1)
+        bit_pos += code_size
+        if code == clear:
+            code_size = min_code_size + 1
+            table = table[:clear + 2]
+            prev = None
+            continue
+        if code == eoi:
+            break
+        if code < len(table):
+            entry = table[code]
+            if prev is not None:
+                table.append(prev + entry[:1])
+        elif prev is not None:
+            entry = prev + prev[:1]
+            table.append(entry)
+        else:
+            raise ValueError('invalid LZW stream')
+        out += entry
+        prev = entry
+        if len(table) == (1 << code_size) and code_size < 12:
+            code_size += 1
+    return bytes(out[:pixel_cnt])
+
+
+def _read_sub_blocks(buf, pos):
+    data = bytearray()
+    while True:
+        size = buf[pos]
+        pos += 1
+        if size == 0:
+            return bytes(data), pos
+        data += buf[pos:pos + size]
+        pos += size
+
+
+def decode_gif(buf):
+    """Return (w, h, [(rgba bytes, delay_ms), ...]) with every frame fully composed."""
+    if buf[:6] not in (b'GIF87a', b'GIF89a'):
+        raise ValueError('not a GIF file')
+    w, h, flags, _bg, _aspect = struct.unpack_from('<HHBBB', buf, 6)
+    pos = 13
+    global_ct = None
+    if flags & 0x80:
+        size = 3 << ((flags & 7) + 1)
+        global_ct = buf[pos:pos + size]
+        pos += size
+
+    canvas = bytearray(w * h * 4)
+    frames = []
+    gce = {'disposal': 0, 'transparent': None, 'delay': 0}
+    while pos < len(buf):
+        block = buf[pos]
+        pos += 1
+        if block == 0x3B:
+            break
+        if block == 0x21:
+            label = buf[pos]
+            pos += 1
+            data, pos = _read_sub_blocks(buf, pos)
+            if label == 0xF9 and len(data) >= 4:
+                gce = {
+                    'disposal': (data[0] >> 2) & 7,
+                    'transparent': data[3] if data[0] & 1 else None,
+                    'delay': struct.unpack_from('<H', data, 1)[0],
+                }
+            continue
+        if block != 0x2C:
+            raise ValueError('unexpected GIF block 0x%02x' % block)
+
+        fx, fy, fw, fh, fflags = struct.unpack_from('<HHHHB', buf, pos)
+        pos += 9
+        ct = global_ct
+        if fflags & 0x80:
+            size = 3 << ((fflags & 7) + 1)
+            ct = buf[pos:pos + size]
+            pos += size
+        min_code_size = buf[pos]
+        pos += 1
+        data, pos = _read_sub_blocks(buf, pos)
+        indices = _lzw_decode(data, min_code_size, fw * fh)
+
+        rows = list(range(fh))
+        if fflags & 0x40:
+            rows = list(range(0, fh, 8)) + list(range(4, fh, 8)) + list(range(2, fh, 4)) + list(range(1, fh, 2))
+
+        previous = bytes(canvas) if gce['disposal'] == 3 else None
+        for src_row, y in enumerate(rows):
+            cy = fy + y
+            if cy >= h:
+                continue
+            for x in range(fw):
+                cx = fx + x
+                i = src_row * fw + x
+                if cx >= w or i >= len(indices):
+                    continue
+                idx = indices[i]
+                if idx == gce['transparent']:
+                    continue
+                o = (cy * w + cx) * 4
+                canvas[o:o + 4] = bytes((ct[idx * 3], ct[idx * 3 + 1], ct[idx * 3 + 2], 0xFF))
+        frames.append((bytes(canvas), gce['delay'] * 10))
+
+        if gce['disposal'] == 2:
+            for y in range(fy, min(fy + fh, h)):
+                o = (y * w + fx) * 4
+                n = min(fw, w - fx) * 4
+                canvas[o:o + n] = bytes(n)
+        elif previous is not None:
+            canvas[:] = previous
+        gce = {'disposal': 0, 'transparent': None, 'delay': 0}
+    return w, h, frames
+
+
+# PNG decoding (non-interlaced, 8-bit grey/RGB/RGBA/palette)
+
+def _paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def decode_png(buf):
+    if buf[:8] != b'\x89PNG\r\n\x1a\n':
+        raise ValueError('not a PNG file')
+    pos = 8
+    idat = bytearray()
+    palette = trns = None
+    while pos < len(buf):
+        length, ctype = struct.unpack_from('>I4s', buf, pos)
+        data = buf[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if ctype == b'IHDR':
+            w, h, depth, color, _comp, _filt, interlace = struct.unpack('>IIBBBBB', data)
+        elif ctype == b'PLTE':
+            palette = data
+        elif ctype == b'tRNS':
+            trns = data
+        elif ctype == b'IDAT':
+            idat += data
+        elif ctype == b'IEND':
+            break
+    if depth != 8 or interlace:
+        raise ValueError('only 8-bit non-interlaced PNG is supported')
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[color]
+    raw = zlib.decompress(bytes(idat))
+    stride = w * channels
+    prev = bytearray(stride)
+    rgba = bytearray(w * h * 4)
+    pos = 0
+    for y in range(h):
+        ftype = raw[pos]
+        line = bytearray(raw[pos + 1:pos + 1 + stride])
+        pos += 1 + stride
+        for i in range(stride):
+            a = line[i - channels] if i >= channels else 0
+            b = prev[i]
+            c = prev[i - channels] if i >= channels else 0
+            if ftype == 1:
+                line[i] = (line[i] + a) & 0xFF
+            elif ftype == 2:
+                line[i] = (line[i] + b) & 0xFF
+            elif ftype == 3:
+                line[i] = (line[i] + ((a + b) >> 1)) & 0xFF
+            elif ftype == 4:
+                line[i] = (line[i] + _paeth(a, b, c)) & 0xFF
+        prev = line
+        for x in range(w):
+            px = line[x * channels:(x + 1) * channels]
+            if color == 0:
+                r = g = b = px[0]
+                a = 0xFF
+            elif color == 4:
+                r = g = b = px[0]
+                a = px[1]
+            elif color == 3:
+                r, g, b = palette[px[0] * 3:px[0] * 3 + 3]
+                a = trns[px[0]] if trns and px[0] < len(trns) else 0xFF
+            else:
+                r, g, b = px[0:3]
+                a = px[3] if channels == 4 else 0xFF
+            rgba[(y * w + x) * 4:(y * w + x + 1) * 4] = bytes((r, g, b, a))
+    return w, h, [(bytes(rgba), 0)]
+
+
+def load_frames(path):
+    with open(path, 'rb') as f:
+        buf = f.read()
+    if buf[:3] == b'GIF':
+        return decode_gif(buf)
+    return decode_png(buf)
+
+
+# A565 encoding
+
+def _to_565(rgba, w, h):
+    """Quantize once: transparent pixels get colour 0 so they never show up as changes."""
+    rgb = [0] * (w * h)
+    alpha = bytearray(w * h)
+    for i in range(w * h):
+        r, g, b, a = rgba[i * 4:i * 4 + 4]
+        alpha[i] = a
+        if a:
+            rgb[i] = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3)
+    return rgb, alpha
+
+
+def _dirty_rect(prev, cur, w, h):
+    x1, y1, x2, y2 = w, h, -1, -1
+    for y in range(h):
+        row = y * w
+        for x in range(w):
+            if prev[0][row + x] != cur[0][row + x] or prev[1][row + x] != cur[1][row + x]:
+                x1 = min(x1, x)
+                x2 = max(x2, x)
+                y1 = min(y1, y)
+                y2 = max(y2, y)
+    if x2 < 0:
+        return 0, 0, 0, 0
+    return x1, y1, x2 - x1 + 1, y2 - y1 + 1
+
+
+def encode(w, h, frames):
+    planes = [_to_565(rgba, w, h) for rgba, _ in frames]
+    has_alpha = any(a != 0xFF for _, alpha in planes for a in alpha)
+    out = bytearray(A565_HEADER.pack(A565_MAGIC, A565_VERSION, A565_FLAG_HAS_ALPHA if has_alpha else 0, w, h, len(frames)))
+    prev = None
+    for (_, delay), cur in zip(frames, planes):
+        rx, ry, rw, rh = (0, 0, w, h) if prev is None else _dirty_rect(prev, cur, w, h)
+        out += A565_FRAME.pack(delay, rx, ry, rw, rh, 0)
+        for y in range(ry, ry + rh):
+            out += struct.pack('<%dH' % rw, *cur[0][y * w + rx:y * w + rx + rw])
+        if has_alpha:
+            for y in range(ry, ry + rh):
+                out += cur[1][y * w + rx:y * w + rx + rw]
+        out += bytes(-len(out) % 4)
+        prev = cur
+    return bytes(out)
+
+
+def decode(blob):
+    """Replay an A565 stream the way the player does, return [(rgb565 list, alpha, delay, rect)]."""
+    magic, version, flags, w, h, frame_cnt = A565_HEADER.unpack_from(blob, 0)
+    if magic != A565_MAGIC or version != A565_VERSION:
+        raise ValueError('not an A565 v%d stream' % A565_VERSION)
+    pos = A565_HEADER.size
+    rgb = [0] * (w * h)
+    alpha = bytearray(b'\xff' * (w * h))
+    frames = []
+    for _ in range(frame_cnt):
+        delay, rx, ry, rw, rh, _ = A565_FRAME.unpack_from(blob, pos)
+        pos += A565_FRAME.size
+        for y in range(rh):
+            rgb[(ry + y) * w + rx:(ry + y) * w + rx + rw] = struct.unpack_from('<%dH' % rw, blob, pos)
+            pos += rw * 2
+        if flags & A565_FLAG_HAS_ALPHA:
+            for y in range(rh):
+                alpha[(ry + y) * w + rx:(ry + y) * w + rx + rw] = blob[pos:pos + rw]
+                pos += rw
+        pos += -pos % 4
+        frames.append((list(rgb), bytes(alpha), delay, (rx, ry, rw, rh)))
+    return w, h, frames
+
+
+def verify(path):
+    w, h, frames = load_frames(path)
+    blob = encode(w, h, frames)
+    _, _, decoded = decode(blob)
+    ref = [_to_565(rgba, w, h) for rgba, _ in frames]
+    has_alpha = blob[5] & A565_FLAG_HAS_ALPHA
+    for i, ((rgb, alpha), (drgb, dalpha, delay, _)) in enumerate(zip(ref, decoded)):
+        if rgb != drgb or (has_alpha and bytes(alpha) != dalpha) or delay != frames[i][1]:
+            print('%s: frame %d differs after round trip' % (path, i), file=sys.stderr)
+            return False
+    full = sum(w * h * (3 if has_alpha else 2) for _ in frames)
+    changed = sum(r[2] * r[3] for _, _, _, r in decoded)
+    print('%s: %dx%d, %d frames, %d bytes (%d bytes as full frames), %.1f%% pixels changed per frame, round trip OK'
+          % (path, w, h, len(frames), len(blob), full, 100.0 * changed / (w * h * len(frames))))
+    return True
+
+
+# Splash
+
+def splash(w, h, frames, sw, sh, bg):
+    """First frame centered on `bg`, alpha blended, big-endian RGB565 rows of sw pixels."""
+    rgba = frames[0][0]
+    ox, oy = (sw - w) // 2, (sh - h) // 2
+    br, bgr, bb = (bg >> 16) & 0xff, (bg >> 8) & 0xff, bg & 0xff
+    out = bytearray()
+    for y in range(sh):
+        for x in range(sw):
+            r, g, b = br, bgr, bb
+            fx, fy = x - ox, y - oy
+            if 0 <= fx < w and 0 <= fy < h:
+                pr, pg, pb, pa = rgba[(fy * w + fx) * 4:(fy * w + fx) * 4 + 4]
+                r = (pr * pa + r * (255 - pa)) // 255
+                g = (pg * pa + g * (255 - pa)) // 255
+                b = (pb * pa + b * (255 - pa)) // 255
+            out += struct.pack('>H', ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3))
+    return bytes(out)
+
+
+def _align(v, a, up):
+    return (v // a + 1) * a - 1 if up else v // a * a
+
+
+def stats(path, align):
+    """Pixels invalidated per frame by the delta player versus invalidating the whole image."""
+    w, h, frames = load_frames(path)
+    _, _, decoded = decode(encode(w, h, frames))
+    # Playback loops, so the key frame is compared with the last frame
+    first = _dirty_rect(_to_565(frames[-1][0], w, h), _to_565(frames[0][0], w, h), w, h)
+    rects = [first] + [r for _, _, _, r in decoded[1:]]
+
+    print('frame  rect               delta_px  aligned_px  full_px')
+    total = total_aligned = 0
+    for i, (rx, ry, rw, rh) in enumerate(rects):
+        px = rw * rh
+        if px:
+            ax1, ay1 = _align(rx, align, False), _align(ry, align, False)
+            ax2, ay2 = min(_align(rx + rw - 1, align, True), w - 1), min(_align(ry + rh - 1, align, True), h - 1)
+            aligned = (ax2 - ax1 + 1) * (ay2 - ay1 + 1)
+        else:
+            aligned = 0
+        total += px
+        total_aligned += aligned
+        print('%5d  %3d,%3d %3dx%-3d     %8d  %10d  %7d' % (i, rx, ry, rw, rh, px, aligned, w * h))
+    full = w * h * len(rects)
+    print('avg px/frame: delta %.0f, aligned to %d %.0f, whole image %d (%.1fx fewer)'
+          % (total / len(rects), align, total_aligned / len(rects), w * h, full / max(total_aligned, 1)))
+
+
+def write_sources(name, blob, w, h, out_c, out_h, src_path, cf='LV_COLOR_FORMAT_RAW', stride=0, tool='anim_conv.py'):
+    guard = name.upper() + '_H'
+    with open(out_h, 'w') as f:
+        f.write('/* Generated by tools/%s from %s, do not edit */\n\n' % (tool, os.path.basename(src_path)))
+        f.write('#ifndef %s\n#define %s\n\n#include "lvgl.h"\n\n' % (guard, guard))
+        f.write('extern const lv_image_dsc_t %s;\n\n#endif // %s\n' % (name, guard))
+    with open(out_c, 'w') as f:
+        f.write('/* Generated by tools/%s from %s, do not edit */\n\n' % (tool, os.path.basename(src_path)))
+        f.write('#include "lvgl.h"\n\n')
+        f.write('#ifndef LV_ATTRIBUTE_MEM_ALIGN\n    #define LV_ATTRIBUTE_MEM_ALIGN\n#endif\n\n')
+        f.write('static const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST uint8_t %s_map[] __attribute__((aligned(4))) = {\n' % name)
+        for i in range(0, len(blob), 16):
+            f.write('    ' + ', '.join('0x%02x' % b for b in blob[i:i + 16]) + ',\n')
+        f.write('};\n\n')
+        f.write('const lv_image_dsc_t %s = {\n' % name)
+        f.write('    .header = {\n        .magic = LV_IMAGE_HEADER_MAGIC,\n        .cf = %s,\n' % cf)
+        f.write('        .w = %d,\n        .h = %d,\n        .stride = %d,\n    },\n' % (w, h, stride))
+        f.write('    .data_size = sizeof(%s_map),\n    .data = %s_map,\n};\n' % (name, name))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert GIF/PNG to A565 delta-frame animations')
+    parser.add_argument('src', help='source GIF or PNG')
+    parser.add_argument('--name', help='C symbol name, defaults to the file name')
+    parser.add_argument('--out-c', help='generated C source')
+    parser.add_argument('--out-h', help='generated header')
+    parser.add_argument('--verify', action='store_true', help='check the encoder output decodes back to the source')
+    parser.add_argument('--stats', action='store_true', help='print invalidated pixels per frame')
+    parser.add_argument('--align', type=int, default=2, help='partial refresh window grid used by --stats')
+    parser.add_argument('--splash', metavar='WxH', help='write a full-screen splash image instead of an animation')
+    parser.add_argument('--bg', default='000000', help='splash background, RRGGBB')
+    args = parser.parse_args()
+
+    if args.verify:
+        return 0 if verify(args.src) else 1
+    if args.stats:
+        stats(args.src, args.align)
+        return 0
+
+    if not args.out_c or not args.out_h:
+        parser.error('--out-c and --out-h are required')
+    name = args.name or os.path.splitext(os.path.basename(args.src))[0]
+    w, h, frames = load_frames(args.src)
+    if args.splash:
+        sw, sh = (int(v) for v in args.splash.lower().split('x'))
+        write_sources(name, splash(w, h, frames, sw, sh, int(args.bg, 16)), sw, sh, args.out_c, args.out_h, args.src,
+                      'LV_COLOR_FORMAT_RGB565_SWAPPED', sw * 2)
+        return 0
+    write_sources(name, encode(w, h, frames), w, h, args.out_c, args.out_h, args.src)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
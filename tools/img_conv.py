@@ -0,0 +1,248 @@
+#!/usr/bin/env python3
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Convert GIF/PNG files to C565 compressed RGB565 images drawn by main/img_c565.c.
+#
+# The first frame is alpha blended onto a background (a color or a vertical gradient),
+# optionally centered on a larger canvas, quantized to RGB565 and compressed row by row with
+# a QOI variant. Every row starts from black with an empty hash table, so the decoder can
+# start at any row and decompress only the band being rendered.
+#
+# Layout, little-endian:
+#   header  "C565" u8 version, u8 flags, u16 w, u16 h, u16 reserved           (12 bytes)
+#   table   h * u32 row offsets, counted from the end of the table
+#   rows    ops until w pixels are produced:
+#             00nnnnnn            previous pixel n + 1 times
+#             01iiiiii            pixel i of the hash table
+#             10rrggbb            previous pixel, each channel plus -2..1 (stored + 2)
+#             110ggggg rrrrbbbb   green plus -16..15 (+ 16), red and blue plus green -8..7 (+ 8)
+#             111nnnnn            n + 1 RGB565 pixels follow
+#           channel sums wrap within the channel, the hash is (r * 3 + g * 5 + b * 7) % 64
+#           and every pixel not from a run or the table is stored at its hash
+#
+# Usage:
+#   img_conv.py --name bg_bulb --canvas 160x160 --bg 87ceeb:f5f5f5 --out-c bg_bulb.c --out-h bg_bulb.h bulb.gif
+#   img_conv.py --format rgb565 ...       plain RGB565 instead, e.g. as a reference for host/c565_bench.c
+#   img_conv.py --verify --canvas 160x160 --bg 87ceeb:f5f5f5 bulb.gif
+#                                         round-trip: encode, decode, compare with the source
+#   img_conv.py --stats --canvas 160x160 --bg 87ceeb:f5f5f5 bulb.gif
+#                                         compressed size and ops used
+
+import argparse
+import os
+import struct
+import sys
+
+from anim_conv import load_frames, write_sources
+
+C565_MAGIC = b'C565'
+C565_VERSION = 1
+C565_HEADER = struct.Struct('<4sBBHHH')
+
+OP_RUN = 0x00
+OP_INDEX = 0x40
+OP_DIFF = 0x80
+OP_LUMA = 0xC0
+OP_LIT = 0xE0
+OP_NAMES = ('run', 'index', 'diff', 'luma', 'literal')
+
+
+def _hash(px):
+    return ((px >> 11) * 3 + ((px >> 5) & 0x3F) * 5 + (px & 0x1F) * 7) & 0x3F
+
+
+def _delta(a, b, bits):
+    """b - a wrapped into the signed range of a channel"""
+    half = 1 << (bits - 1)
+    return ((b - a + half) & ((1 << bits) - 1)) - half
+
+
+def compose(w, h, frames, cw, ch, bg_top, bg_bottom):
+    """First frame centered on a cw x ch canvas over a vertical gradient, as RGB565 pixels."""
+    rgba = frames[0][0]
+    ox, oy = (cw - w) // 2, (ch - h) // 2
+    px = []
+    for y in range(ch):
+        t = y / max(ch - 1, 1)
+        bg = [round(((bg_top >> s) & 0xff) * (1 - t) + ((bg_bottom >> s) & 0xff) * t) for s in (16, 8, 0)]
+        for x in range(cw):
+            r, g, b = bg
+            fx, fy = x - ox, y - oy
+            if 0 <= fx < w and 0 <= fy < h:
+                pr, pg, pb, pa = rgba[(fy * w + fx) * 4:(fy * w + fx) * 4 + 4]
+                r = (pr * pa + r * (255 - pa)) // 255
+                g = (pg * pa + g * (255 - pa)) // 255
+                b = (pb * pa + b * (255 - pa)) // 255
+            px.append(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3))
+    return px
+
+
+def _plain_op(px, prev, index):
+    """Op for a pixel other than a run or a literal, None if it needs a literal"""
+    if index[_hash(px)] == px:
+        return bytes((OP_INDEX | _hash(px),))
+    dr = _delta(prev >> 11, px >> 11, 5)
+    dg = _delta((prev >> 5) & 0x3F, (px >> 5) & 0x3F, 6)
+    db = _delta(prev & 0x1F, px & 0x1F, 5)
+    if -2 <= dr <= 1 and -2 <= dg <= 1 and -2 <= db <= 1:
+        return bytes((OP_DIFF | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2),))
+    dr_dg = _delta(dg, dr, 5)
+    db_dg = _delta(dg, db, 5)
+    if -16 <= dg <= 15 and -8 <= dr_dg <= 7 and -8 <= db_dg <= 7:
+        return bytes((OP_LUMA | (dg + 16), (dr_dg + 8) << 4 | (db_dg + 8)))
+    return None
+
+
+def encode_row(row, ops=None):
+    out = bytearray()
+    index = [0] * 64
+    prev = 0
+    i = 0
+    while i < len(row):
+        px = row[i]
+        if px == prev:
+            n = 1
+            while n < 64 and i + n < len(row) and row[i + n] == prev:
+                n += 1
+            out.append(OP_RUN | (n - 1))
+            i += n
+            kind = 0
+        else:
+            op = _plain_op(px, prev, index)
+            if op is not None:
+                out += op
+                if (op[0] & 0xC0) != OP_INDEX:
+                    index[_hash(px)] = px
+                prev = px
+                i += 1
+                kind = op[0] >> 6
+            else:
+                lit = []
+                while i < len(row) and len(lit) < 32 and (not lit or (row[i] != prev and _plain_op(row[i], prev, index) is None)):
+                    prev = row[i]
+                    index[_hash(prev)] = prev
+                    lit.append(prev)
+                    i += 1
+                out.append(OP_LIT | (len(lit) - 1))
+                out += struct.pack('<%dH' % len(lit), *lit)
+                kind = 4
+        if ops is not None:
+            ops[kind] += 1
+    return bytes(out)
+
+
+def encode(w, h, px, ops=None):
+    rows = [encode_row(px[y * w:(y + 1) * w], ops) for y in range(h)]
+    offsets = []
+    pos = 0
+    for row in rows:
+        offsets.append(pos)
+        pos += len(row)
+    out = bytearray(C565_HEADER.pack(C565_MAGIC, C565_VERSION, 0, w, h, 0))
+    out += struct.pack('<%dI' % h, *offsets)
+    for row in rows:
+        out += row
+    out += bytes(-len(out) % 4)
+    return bytes(out)
+
+
+def _add(px, dr, dg, db):
+    return (((px >> 11) + dr) & 0x1F) << 11 | ((((px >> 5) & 0x3F) + dg) & 0x3F) << 5 | ((px & 0x1F) + db) & 0x1F
+
+
+def decode(blob):
+    """Decode every row the way main/img_c565.c does, return (w, h, RGB565 pixels)."""
+    magic, version, _flags, w, h, _ = C565_HEADER.unpack_from(blob, 0)
+    if magic != C565_MAGIC or version != C565_VERSION:
+        raise ValueError('not a C565 v%d image' % C565_VERSION)
+    base = C565_HEADER.size + 4 * h
+    offsets = struct.unpack_from('<%dI' % h, blob, C565_HEADER.size)
+    out = []
+    for y in range(h):
+        pos = base + offsets[y]
+        index = [0] * 64
+        px = 0
+        row = []
+        while len(row) < w:
+            op = blob[pos]
+            pos += 1
+            if op < OP_INDEX:
+                row += [px] * min((op & 0x3F) + 1, w - len(row))
+                continue
+            if op >= OP_LIT:
+                for _ in range(min((op & 0x1F) + 1, w - len(row))):
+                    px = struct.unpack_from('<H', blob, pos)[0]
+                    pos += 2
+                    index[_hash(px)] = px
+                    row.append(px)
+                continue
+            if op < OP_DIFF:
+                px = index[op & 0x3F]
+            else:
+                if op < OP_LUMA:
+                    px = _add(px, ((op >> 4) & 3) - 2, ((op >> 2) & 3) - 2, (op & 3) - 2)
+                else:
+                    dg = (op & 0x1F) - 16
+                    rb = blob[pos]
+                    pos += 1
+                    px = _add(px, dg + (rb >> 4) - 8, dg, dg + (rb & 0x0F) - 8)
+                index[_hash(px)] = px
+            row.append(px)
+        out += row
+    return w, h, out
+
+
+def _parse_size(s):
+    return tuple(int(v) for v in s.lower().split('x'))
+
+
+def _parse_bg(s):
+    top, _, bottom = s.partition(':')
+    return int(top, 16), int(bottom or top, 16)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert GIF/PNG to C565 compressed RGB565 images')
+    parser.add_argument('src', help='source GIF or PNG, its first frame is used')
+    parser.add_argument('--name', help='C symbol name, defaults to the file name')
+    parser.add_argument('--out-c', help='generated C source')
+    parser.add_argument('--out-h', help='generated header')
+    parser.add_argument('--canvas', metavar='WxH', help='center the image on a canvas this size, defaults to the image size')
+    parser.add_argument('--bg', default='000000', help='background, RRGGBB or RRGGBB:RRGGBB for a top to bottom gradient')
+    parser.add_argument('--format', choices=('c565', 'rgb565'), default='c565', help='compressed or plain RGB565')
+    parser.add_argument('--verify', action='store_true', help='check the encoder output decodes back to the source')
+    parser.add_argument('--stats', action='store_true', help='print the compressed size and the ops used')
+    args = parser.parse_args()
+
+    w, h, frames = load_frames(args.src)
+    cw, ch = _parse_size(args.canvas) if args.canvas else (w, h)
+    px = compose(w, h, frames, cw, ch, *_parse_bg(args.bg))
+    ops = [0] * len(OP_NAMES)
+    blob = encode(cw, ch, px, ops)
+
+    if args.verify:
+        if decode(blob)[2] != px:
+            print('%s: differs after round trip' % args.src, file=sys.stderr)
+            return 1
+        print('%s: %dx%d, %d bytes (%d as RGB565), round trip OK' % (args.src, cw, ch, len(blob), cw * ch * 2))
+        return 0
+    if args.stats:
+        print('%dx%d: %d bytes, %.1f%% of RGB565, %.2f bytes per row on average'
+              % (cw, ch, len(blob), 100.0 * len(blob) / (cw * ch * 2), (len(blob) - C565_HEADER.size) / ch))
+        print('ops: ' + ', '.join('%s %d' % (n, c) for n, c in zip(OP_NAMES, ops)))
+        return 0
+
+    if not args.out_c or not args.out_h:
+        parser.error('--out-c and --out-h are required')
+    name = args.name or os.path.splitext(os.path.basename(args.src))[0]
+    if args.format == 'rgb565':
+        write_sources(name, struct.pack('<%dH' % len(px), *px), cw, ch, args.out_c, args.out_h, args.src,
+                      'LV_COLOR_FORMAT_RGB565', cw * 2, 'img_conv.py')
+    else:
+        write_sources(name, blob, cw, ch, args.out_c, args.out_h, args.src, tool='img_conv.py')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
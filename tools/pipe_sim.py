@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Host simulation of the LVGL render / SPI transfer overlap for the flush paths in main/.
+#
+# Every frame is rendered as `--areas` flushes of equal size. Rendering an area takes
+# `--render-us`, sending it takes the command phase (CASET/RASET/RAMWR) plus the pixel
+# bytes at the SPI clock. Compared paths:
+#
+#   single    one draw buffer, LVGL waits for every transfer before rendering again
+#   port      esp_lvgl_port double buffering, the flush waits for the previous transfer
+#             and runs the command phase on the LVGL task
+#   pipe N    main/lcd_pipe.c with N buffers, a transfer task sends queued buffers and
+#             LVGL only waits when all buffers are queued or in flight
+#
+# Usage:
+#   pipe_sim.py --render-us 6000                      whole frame per flush, continuous refresh
+#   pipe_sim.py --render-us 900 --areas 8 --period-ms 16
+#   pipe_sim.py --render-us 3000 --drop               full refresh, stale frames dropped
+
+import argparse
+import sys
+
+
+class Sim:
+    def __init__(self, args, bufs, drop):
+        self.args = args
+        self.bufs = bufs
+        self.drop = drop
+        self.wire_us = args.cmd_us + args.bytes * 8 * 1e6 / args.pclk
+        self.releases = []          # Times buffers become free again
+        self.queue = []             # Ready times of jobs waiting for the bus
+        self.busy_until = 0.0       # End of the transfer on the wire
+        self.bus_us = 0.0
+        self.sent = 0
+        self.dropped = 0
+        self.stall_us = 0.0
+
+    def advance(self, t):
+        """Start every queued transfer that begins before t"""
+        while self.queue:
+            start = max(self.busy_until, self.queue[0])
+            if start > t:
+                break
+            self.queue.pop(0)
+            self.busy_until = start + self.wire_us
+            self.bus_us += self.wire_us
+            self.releases.append(self.busy_until)
+            self.sent += 1
+
+    def acquire(self, t):
+        """Time at which a free buffer is available to render into"""
+        while True:
+            self.advance(t)
+            free = [r for r in self.releases if r <= t]
+            if free:
+                self.releases.remove(free[0])
+                return t
+            pending = self.releases + ([max(self.busy_until, self.queue[0])] if self.queue else [])
+            nxt = min(pending)
+            self.stall_us += nxt - t
+            t = nxt
+
+    def run(self):
+        args = self.args
+        self.releases = [0.0] * (self.bufs - 1)     # LVGL holds one buffer from the start
+        t = 0.0
+        held = True
+        for frame in range(args.frames):
+            if args.period_ms:
+                tick = args.period_ms * 1000
+                t = max(t, -(-t // tick) * tick if frame else 0.0)
+            for _ in range(args.areas):
+                if not held:
+                    t = self.acquire(t)
+                t += args.render_us
+                self.advance(t)
+                if self.drop and self.queue:
+                    self.queue.pop(0)
+                    self.releases.append(t)
+                    self.dropped += 1
+                self.queue.append(t)
+                held = False
+        self.advance(float('inf'))
+        return t, max(t, self.busy_until)
+
+    def report(self, name, rendered_t, end_t):
+        args = self.args
+        shown = args.frames - self.dropped
+        print(f'{name:<8} {shown * 1e6 / end_t:7.1f} fps  {rendered_t / args.frames / 1000:6.2f} ms/frame rendered  '
+              f'stall {self.stall_us / args.frames / 1000:5.2f} ms/frame  dropped {self.dropped:4d}  '
+              f'bus {self.bus_us * 100 / end_t:5.1f}%')
+
+
+def sim_blocking(args, double):
+    """LVGL task waits in the flush for the previous transfer, then issues the next one itself"""
+    wire_us = args.bytes * 8 * 1e6 / args.pclk
+    t = 0.0
+    done = 0.0
+    stall = 0.0
+    for frame in range(args.frames):
+        if args.period_ms:
+            tick = args.period_ms * 1000
+            t = max(t, -(-t // tick) * tick if frame else 0.0)
+        for _ in range(args.areas):
+            if not double and done > t:
+                stall += done - t
+                t = done
+            t += args.render_us
+            if done > t:
+                stall += done - t
+                t = done
+            t += args.cmd_us
+            done = t + wire_us
+    end = max(t, done)
+    name = 'port' if double else 'single'
+    bus = (args.cmd_us + wire_us) * args.frames * args.areas
+    print(f'{name:<8} {args.frames * 1e6 / end:7.1f} fps  {t / args.frames / 1000:6.2f} ms/frame rendered  '
+          f'stall {stall / args.frames / 1000:5.2f} ms/frame  dropped    0  bus {bus * 100 / end:5.1f}%')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Simulate render / SPI transfer overlap of the LCD flush paths')
+    parser.add_argument('--render-us', type=float, required=True, help='render time of one area')
+    parser.add_argument('--areas', type=int, default=1, help='flushes per frame')
+    parser.add_argument('--bytes', type=int, default=160 * 160 * 2, help='pixel bytes per flush')
+    parser.add_argument('--pclk', type=float, default=80e6, help='SPI clock in Hz')
+    parser.add_argument('--cmd-us', type=float, default=40, help='CASET/RASET/RAMWR command phase per flush')
+    parser.add_argument('--period-ms', type=float, default=0, help='LVGL refresh period, 0 renders back to back')
+    parser.add_argument('--frames', type=int, default=500)
+    parser.add_argument('--drop', action='store_true', help='pipeline drops queued frames, needs --areas 1')
+    args = parser.parse_args()
+
+    if args.drop and args.areas != 1:
+        parser.error('--drop only applies to full refresh (--areas 1)')
+
+    wire_us = args.cmd_us + args.bytes * 8 * 1e6 / args.pclk
+    print(f'render {args.render_us * args.areas / 1000:.2f} ms/frame, transfer {wire_us * args.areas / 1000:.2f} ms/frame, '
+          f'bound {max(args.render_us, wire_us) * args.areas / 1000:.2f} ms/frame')
+    sim_blocking(args, False)
+    sim_blocking(args, True)
+    for bufs in (2, 3):
+        sim = Sim(args, bufs, args.drop)
+        sim.report(f'pipe {bufs}', *sim.run())
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())